@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// A minimal benchmark registry, see main.cpp. Benchmarks print their own results.
+
+namespace SchafKopf
+{
+namespace Bench
+{
+
+struct Benchmark
+{
+    const char *name;
+    void (*run)();
+};
+
+inline std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> registry;
+    return registry;
+}
+
+struct Registrar
+{
+    Registrar(const char *name, void (*run)())
+    {
+        benchmarks().push_back(Benchmark{ name, run });
+    }
+};
+
+class Timer
+{
+public:
+    Timer()
+        : m_start(std::chrono::steady_clock::now())
+    {}
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}
+}
+
+#define BENCHMARK(name) \
+    static void bench_##name(); \
+    static SchafKopf::Bench::Registrar registrar_##name(#name, bench_##name); \
+    static void bench_##name()
@@ -0,0 +1,72 @@
+#include "Bench.h"
+
+#include <BatchSim.h>
+#include <RandomAi.h>
+#include <Ranking.h>
+
+using namespace SchafKopf;
+
+static void report(const char *name, int numGames, double seconds)
+{
+    std::cout << "    " << name << ": " << numGames / seconds << " games/s" << std::endl;
+}
+
+BENCHMARK(batchSim)
+{
+    constexpr int numGames = 1 << 14;
+    const Rules rules(Game::Solo, Herz);
+
+    std::minstd_rand engine(29);
+    std::vector<Deal> deals(numGames);
+    for (Deal& deal : deals)
+        deal = randomDeal(engine);
+
+    {
+        // one Game with RandomAi at a time
+        constexpr int numSlowGames = numGames / 16;
+        Bench::Timer timer;
+        for (int i = 0; i < numSlowGames; ++i) {
+            Game game;
+            game.gameType = Game::Solo;
+            game.gameColor = Herz;
+            RandomAi ais[numPlayers] = {
+                { game, game.players[0] }, { game, game.players[1] },
+                { game, game.players[2] }, { game, game.players[3] }
+            };
+            for (int p = 0; p < numPlayers; ++p)
+                game.ais[p] = &ais[p];
+            for (int j = 0; j < numCards; ++j)
+                game.putCard(ais[game.m_activePlayer].doPlayCard(game.activePile));
+        }
+        report("Game", numSlowGames, timer.seconds());
+    }
+
+    {
+        Bench::Timer timer;
+        int points = 0;
+        for (const Deal& deal : deals) {
+            Position position(rules, deal, 0, 0);
+            while (!position.finished())
+                position.play(lowestCard(position.legalMoves()));
+            points += position.declarerPoints();
+        }
+        report("Position", numGames, timer.seconds());
+        std::cout << "    average declarer points " << double(points) / numGames << std::endl;
+    }
+
+    BatchSim sim(rules, numGames);
+    for (int i = 0; i < numGames; ++i)
+        sim.setGame(size_t(i), deals[size_t(i)], 0, 0);
+
+    const BatchSim::Policy policies[] = { BatchSim::FirstLegal, BatchSim::RandomLegal };
+    const char *names[2][2] = { { "BatchSim scalar, first legal", "BatchSim scalar, random legal" },
+                                { "BatchSim AVX2, first legal", "BatchSim AVX2, random legal" } };
+    for (int avx2 = 0; avx2 < 1 + BatchSim::hasAvx2(); ++avx2) {
+        sim.setUseAvx2(avx2);
+        for (int policy = 0; policy < 2; ++policy) {
+            Bench::Timer timer;
+            sim.run(policies[policy], 1);
+            report(names[avx2][policy], numGames, timer.seconds());
+        }
+    }
+}
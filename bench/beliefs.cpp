@@ -0,0 +1,77 @@
+#include "Bench.h"
+
+#include <Beliefs.h>
+#include <Ranking.h>
+
+using namespace SchafKopf;
+
+// Player 0 follows random Solo games with Beliefs, once with the scalar
+// and once with the AVX2 kernel, and after every card of the others
+// scores the probabilities against where the cards really are (Brier
+// score over the hidden cards, lower is better). For comparison, the same
+// score for spreading each card evenly over the players that may have it.
+BENCHMARK(beliefs)
+{
+    const Rules rules(Game::Solo, Eichel);
+    constexpr int numGames = 2000;
+
+    for (int avx2 = 0; avx2 < 2; ++avx2) {
+        std::minstd_rand engine(107);
+        Beliefs beliefs;
+        beliefs.setUseAvx2(avx2);
+        double seconds = 0;
+        double brier = 0;
+        double evenBrier = 0;
+        long iterations = 0;
+        long updates = 0;
+        long scored = 0;
+
+        for (int g = 0; g < numGames; ++g) {
+            Position position(rules, randomDeal(engine), g % numPlayers, 0);
+            int handSizes[numPlayers];
+            for (int p = 0; p < numPlayers; ++p)
+                handSizes[p] = popCount(position.hands[p]);
+            beliefs.reset(0, allCards & ~position.hands[0], handSizes);
+            CardMask excluded[numPlayers] = { 0, 0, 0, 0 };
+
+            while (position.numStiche() < 7) {
+                const int who = position.toMove();
+                const CardMask moves = position.legalMoves();
+                const int card = nthCard(moves, int(engine() % popCount(moves)));
+                const int leadSuit = position.numInTrick ? rules.suit(position.trick[0]) : -1;
+                position.play(card);
+
+                Bench::Timer timer;
+                beliefs.cardPlayed(who, card);
+                if (leadSuit >= 0 && rules.suit(card) != leadSuit) {
+                    beliefs.exclude(who, rules.suitMask(leadSuit));
+                    excluded[who] |= rules.suitMask(leadSuit);
+                }
+                iterations += beliefs.update();
+                seconds += timer.seconds();
+                ++updates;
+                if (who == 0)
+                    continue;
+
+                for (CardMask rest = beliefs.hidden(); rest; rest &= rest - 1) {
+                    const int c = lowestCard(rest);
+                    int numAllowed = 0;
+                    for (int p = 1; p < numPlayers; ++p)
+                        numAllowed += !((excluded[p] >> c) & 1);
+                    for (int p = 1; p < numPlayers; ++p) {
+                        const double actual = (position.hands[p] >> c) & 1;
+                        const double even = (excluded[p] >> c) & 1 ? 0.0 : 1.0 / numAllowed;
+                        brier += (beliefs.probability(p, c) - actual) * (beliefs.probability(p, c) - actual);
+                        evenBrier += (even - actual) * (even - actual);
+                    }
+                    ++scored;
+                }
+            }
+        }
+
+        std::cout << "    " << (avx2 ? "avx2" : "scalar") << ": "
+                  << seconds * 1e6 / updates << " us per card, "
+                  << double(iterations) / updates << " iterations, Brier score "
+                  << brier / scored << " (spread evenly " << evenBrier / scored << ")" << std::endl;
+    }
+}
@@ -0,0 +1,33 @@
+#include "Bench.h"
+
+#include <Bidding.h>
+
+using namespace SchafKopf;
+
+BENCHMARK(bidDecision)
+{
+    constexpr int numDecisions = 200;
+
+    ContractEvaluator evaluator(48, 42);
+    EvaluatorBiddingAi ai(evaluator);
+
+    std::minstd_rand engine(7);
+    Deck deck;
+    int numBids = 0;
+
+    Bench::Timer timer;
+    for (int i = 0; i < numDecisions; ++i) {
+        std::shuffle(deck.cards, deck.cards + Deck::numCards, engine);
+        CardMask hand = 0;
+        for (int j = 0; j < Player::maxCards; ++j)
+            hand |= cardBit(deck.cards[j]);
+
+        Auction auction(i % numPlayers);
+        numBids += bool(ai.bid(auction, hand));
+    }
+    const double seconds = timer.seconds();
+
+    std::cout << "    " << evaluator.numSamples() << " samples per contract, "
+              << seconds * 1000.0 / numDecisions << " ms per decision, "
+              << numBids << "/" << numDecisions << " hands announced a game" << std::endl;
+}
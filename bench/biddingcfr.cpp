@@ -0,0 +1,145 @@
+#include "Bench.h"
+
+#include <BiddingCfr.h>
+#include <ExpertPolicy.h>
+#include <Ranking.h>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+struct Bidder
+{
+    virtual ~Bidder() {}
+    virtual std::optional<Contract> bid(const Auction& auction, CardMask hand) = 0;
+    virtual bool kontra(const Auction& auction, int seat, CardMask hand, bool declarerTeam) = 0;
+    virtual bool re(const Auction& auction, CardMask hand) = 0;
+};
+
+struct CfrBidder : public Bidder
+{
+    explicit CfrBidder(const CfrStrategy& strategy)
+        : ai(strategy, 3)
+    {}
+
+    std::optional<Contract> bid(const Auction& auction, CardMask hand) override { return ai.bid(auction, hand); }
+    bool kontra(const Auction& auction, int seat, CardMask hand, bool declarerTeam) override
+    {
+        return ai.kontra(auction, seat, hand, declarerTeam);
+    }
+    bool re(const Auction& auction, CardMask hand) override { return ai.re(auction, hand); }
+
+    CfrBiddingAi ai;
+};
+
+// a Solo with 6 trumps, a Sauspiel with 3 Ober and Unter, never doubles
+struct RuleBidder : public Bidder
+{
+    std::optional<Contract> bid(const Auction& auction, CardMask hand) override
+    {
+        const Contract solo = CfrStrategy::contract(CfrStrategy::SoloKind, hand);
+        if (popCount(hand & Rules::get(solo.type, solo.color).trumps()) >= 6 && auction.canBid(solo, hand))
+            return solo;
+        if ((CfrStrategy::bucket(hand) & 1) && popCount(hand & (typeMask(Ober) | typeMask(Unter))) >= 3) {
+            const Contract sauSpiel = CfrStrategy::contract(CfrStrategy::SauSpielKind, hand);
+            if (auction.canBid(sauSpiel, hand))
+                return sauSpiel;
+        }
+        return std::optional<Contract>();
+    }
+    bool kontra(const Auction&, int, CardMask, bool) override { return false; }
+    bool re(const Auction&, CardMask) override { return false; }
+};
+
+// the money of every player for a deal, bid, doubled and played out with ExpertPolicy
+void playDeal(const Deal& deal, int firstSeat, Bidder *const bidders[numPlayers], const Scoring& scoring, int *money)
+{
+    std::fill(money, money + numPlayers, 0);
+    Auction auction(firstSeat);
+    while (!auction.finished())
+        auction.bid(bidders[auction.activeSeat()]->bid(auction, deal.hands[auction.activeSeat()]));
+    if (!auction.hasContract())
+        return;
+
+    const Contract& contract = auction.contract();
+    const int declarer = auction.declarer();
+    const int team = declarerTeam(contract.type, contract.color, declarer, deal.hands);
+    int doublings = 0;
+    for (int i = 1; i < numPlayers && !doublings; ++i) {
+        const int seat = (declarer + i) & (numPlayers - 1);
+        if (bidders[seat]->kontra(auction, seat, deal.hands[seat], (team >> seat) & 1))
+            doublings = 1 + bidders[declarer]->re(auction, deal.hands[declarer]);
+    }
+
+    const ExpertPolicy& policy = ExpertPolicy::get(contract.type, contract.color);
+    Position position(policy.rules(), deal, declarer, firstSeat);
+    while (!position.finished())
+        position.play(policy.move(position));
+    FinishedGame finished;
+    finished.gameType = contract.type;
+    finished.gameColor = contract.color;
+    finished.declarer = declarer;
+    std::copy(deal.hands, deal.hands + numPlayers, finished.hands);
+    std::copy(position.won, position.won + numPlayers, finished.won);
+    const Settlement settlement = scoring.settle(finished);
+    for (int p = 0; p < numPlayers; ++p)
+        money[p] = settlement.money[p] * (1 << doublings);
+}
+
+}
+
+// Solves the bidding game on 1 and 4 threads, then plays deals where one
+// seat, in turn, bids by the rules of RuleBidder and the others by the
+// strategy, and the other way around. Money per deal of that one seat.
+BENCHMARK(biddingCfr)
+{
+    constexpr uint64_t numIterations = 200000;
+    CfrSolver solver;
+    for (int numThreads : { 1, 4 }) {
+        CfrSolver timed;
+        Bench::Timer timer;
+        timed.run(numIterations / 4, numThreads, 17);
+        std::cout << "    " << numThreads << " threads: " << numIterations / 4 / timer.seconds() << " iterations/s"
+                  << std::endl;
+    }
+    solver.run(numIterations, 1, 17);
+    const CfrStrategy strategy = solver.strategy();
+
+    // how often the first seat announces, by the trumps of the best Solo
+    std::minstd_rand engine(151);
+    double announced[5] = {};
+    int counts[5] = {};
+    for (int i = 0; i < 20000; ++i) {
+        const CardMask hand = randomDeal(engine).hands[0];
+        const int bucket = CfrStrategy::bucket(hand);
+        const int infoSet = CfrStrategy::infoSet(CfrStrategy::auctionNode(0, CfrStrategy::NoGame, 0), false, bucket);
+        announced[bucket / 128] += 1.0 - strategy.probability(infoSet, CfrStrategy::NoGame);
+        ++counts[bucket / 128];
+    }
+    std::cout << "    first seat announces with <=3 .. >=7 trumps:";
+    for (int t = 0; t < 5; ++t)
+        std::cout << " " << int(100 * announced[t] / std::max(1, counts[t])) << "%";
+    std::cout << std::endl;
+
+    const Scoring scoring;
+    constexpr int numDeals = 40000;
+    for (int cfrHero = 0; cfrHero < 2; ++cfrHero) {
+        // neither keeps anything of a seat, so all seats share one
+        CfrBidder cfr(strategy);
+        RuleBidder rules;
+        std::minstd_rand deals(157);
+        long total = 0;
+        int money[numPlayers];
+        for (int d = 0; d < numDeals; ++d) {
+            const int hero = d & (numPlayers - 1);
+            Bidder *bidders[numPlayers];
+            for (int p = 0; p < numPlayers; ++p)
+                bidders[p] = (p == hero) == bool(cfrHero) ? static_cast<Bidder *>(&cfr) : &rules;
+            playDeal(randomDeal(deals), (d / numPlayers) & (numPlayers - 1), bidders, scoring, money);
+            total += money[hero];
+        }
+        std::cout << "    " << (cfrHero ? "strategy among rules" : "rules among strategy") << ": "
+                  << double(total) / numDeals << " per deal" << std::endl;
+    }
+}
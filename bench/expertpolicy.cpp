@@ -0,0 +1,79 @@
+#include "Bench.h"
+
+#include <ExpertAi.h>
+#include <RandomAi.h>
+#include <Ranking.h>
+
+using namespace SchafKopf;
+
+// Time per decision of ExpertPolicy in Solo games where all players use it.
+BENCHMARK(expertPolicy)
+{
+    const ExpertPolicy& policy = ExpertPolicy::get(Game::Solo, Eichel);
+    std::minstd_rand engine(139);
+    constexpr int numGames = 100000;
+
+    std::vector<Deal> deals;
+    for (int i = 0; i < numGames; ++i)
+        deals.push_back(randomDeal(engine));
+
+    Bench::Timer timer;
+    int checksum = 0;
+    for (int i = 0; i < numGames; ++i) {
+        Position position(policy.rules(), deals[size_t(i)], i % numPlayers, 0);
+        while (!position.finished())
+            position.play(policy.move(position));
+        checksum += position.declarerPoints();
+    }
+    std::cout << "    " << timer.seconds() * 1e9 / (numGames * numCards) << " ns per card ("
+              << checksum << ")" << std::endl;
+}
+
+// Solo games through Game with ExpertAi and RandomAi: the declarer, the
+// player with the most trumps, and the defenders are played by either.
+// Average points of the declarer and how often the declarer wins.
+BENCHMARK(expertMatch)
+{
+    constexpr int numGames = 5000;
+    const char *names[2] = { "random", "expert" };
+
+    for (int expertDeclarer = 0; expertDeclarer < 2; ++expertDeclarer) {
+        for (int expertDefenders = 0; expertDefenders < 2; ++expertDefenders) {
+            std::minstd_rand engine(149);
+            Game game;
+            game.gameType = Game::Solo;
+            game.gameColor = Eichel;
+
+            RandomAi randoms[numPlayers] = {
+                { game, game.players[0] }, { game, game.players[1] }, { game, game.players[2] }, { game, game.players[3] }
+            };
+            ExpertAi experts[numPlayers] = {
+                { game, game.players[0] }, { game, game.players[1] }, { game, game.players[2] }, { game, game.players[3] }
+            };
+            const Rules& rules = Rules::get(game.gameType, game.gameColor);
+
+            long points = 0;
+            int won = 0;
+            for (int g = 0; g < numGames; ++g) {
+                game.redeal(engine);
+                game.declarer = 0;
+                for (int p = 1; p < numPlayers; ++p) {
+                    if (popCount(handMask(game.players[p]) & rules.trumps()) > popCount(handMask(game.players[game.declarer]) & rules.trumps()))
+                        game.declarer = p;
+                }
+                for (int p = 0; p < numPlayers; ++p) {
+                    const bool expert = p == game.declarer ? expertDeclarer : expertDefenders;
+                    game.ais[p] = expert ? static_cast<AI *>(&experts[p]) : &randoms[p];
+                }
+
+                for (int ply = 0; ply < numCards; ++ply)
+                    game.putCard(game.ais[game.m_activePlayer]->doPlayCard(game.activePile));
+                points += game.players[game.declarer].points;
+                won += game.players[game.declarer].points > 60;
+            }
+
+            std::cout << "    " << names[expertDeclarer] << " declarer vs " << names[expertDefenders] << " defenders: "
+                      << double(points) / numGames << " points, " << won * 100.0 / numGames << "% won" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "Bench.h"
+
+#include <GamePool.h>
+#include <ObserverAi.h>
+#include <RandomAi.h>
+
+#include <random>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+struct ObservingRandomAi : public AI
+{
+    ObservingRandomAi(const Game& game, const Player& player)
+        : observerAi(game, player),
+          randomAi(game, player)
+    {}
+
+    void reset() override { observerAi.reset(); }
+    int doPlayCard(const ActivePile& pile) override { return randomAi.doPlayCard(pile); }
+    void cardPlayed(const ActivePile& pile, int player) override { observerAi.cardPlayed(pile, player); }
+
+    ObserverAi observerAi;
+    RandomAi randomAi;
+};
+
+// reads the played cards from the game's history on its turn only
+struct LazyObservingRandomAi : public ObservingRandomAi
+{
+    LazyObservingRandomAi(const Game& game, const Player& player)
+        : ObservingRandomAi(game, player)
+    {
+        setLazy(true);
+    }
+
+    int doPlayCard(const ActivePile& pile) override
+    {
+        observerAi.sync();
+        return randomAi.doPlayCard(pile);
+    }
+};
+
+}
+
+BENCHMARK(gameReset)
+{
+    constexpr int numResets = 1 << 17;
+    std::minstd_rand engine(53);
+
+    auto report = [](const char *name, int count, double seconds) {
+        std::cout << "    " << name << ": " << count / seconds << "/s" << std::endl;
+    };
+
+    {
+        // a new Game and new AIs for every game
+        Bench::Timer timer;
+        int checksum = 0;
+        for (int i = 0; i < numResets / 16; ++i) {
+            GameBundle<ObservingRandomAi> bundle;
+            checksum += bundle.game.players[0].m_cards[0]->hashValue();
+        }
+        report("new Game and AIs", numResets / 16, timer.seconds());
+    }
+
+    GamePool<ObservingRandomAi> pool;
+    GamePool<ObservingRandomAi>::Lease bundle = pool.acquire();
+
+    {
+        Bench::Timer timer;
+        for (int i = 0; i < numResets; ++i)
+            bundle->game.reset();
+        report("Game::reset", numResets, timer.seconds());
+    }
+
+    {
+        Bench::Timer timer;
+        for (int i = 0; i < numResets; ++i)
+            bundle->game.redeal(engine);
+        report("Game::redeal", numResets, timer.seconds());
+    }
+
+    {
+        Bench::Timer timer;
+        for (int i = 0; i < numResets / 16; ++i) {
+            bundle->game.reset();
+            bundle->play();
+        }
+        report("games with Game::reset", numResets / 16, timer.seconds());
+    }
+
+    {
+        Bench::Timer timer;
+        for (int i = 0; i < numResets / 16; ++i) {
+            bundle->game.redeal(engine);
+            bundle->play();
+        }
+        report("games with Game::redeal", numResets / 16, timer.seconds());
+    }
+
+    {
+        GamePool<LazyObservingRandomAi> lazyPool;
+        GamePool<LazyObservingRandomAi>::Lease lazy = lazyPool.acquire();
+        Bench::Timer timer;
+        for (int i = 0; i < numResets / 16; ++i) {
+            lazy->game.redeal(engine);
+            lazy->play();
+        }
+        report("games with Game::redeal, lazy observers", numResets / 16, timer.seconds());
+    }
+}
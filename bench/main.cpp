@@ -0,0 +1,22 @@
+#include "Bench.h"
+
+#include <cstring>
+
+using namespace SchafKopf;
+
+// runs all benchmarks, or only the ones given on the command line
+int main(int argc, char *argv[])
+{
+    for (const Bench::Benchmark& benchmark : Bench::benchmarks()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected |= std::strcmp(argv[i], benchmark.name) == 0;
+        if (!selected)
+            continue;
+
+        std::cout << benchmark.name << ":" << std::endl;
+        benchmark.run();
+    }
+
+    return 0;
+}
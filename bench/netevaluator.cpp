@@ -0,0 +1,108 @@
+#include "Bench.h"
+
+#include <DepthSearch.h>
+#include <Ranking.h>
+#include <Solver.h>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+// random weights, the speed does not depend on them
+NetEvaluator::Weights randomWeights(std::minstd_rand& engine)
+{
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    NetEvaluator::Weights weights;
+    for (float& w : weights.w1)
+        w = 0.1f * uniform(engine);
+    for (float& w : weights.w2)
+        w = 0.5f * uniform(engine);
+    for (float& w : weights.w3)
+        w = 0.3f * uniform(engine);
+    return weights;
+}
+
+Position randomPosition(const Rules& rules, std::minstd_rand& engine, int plies)
+{
+    Position position(rules, randomDeal(engine), int(engine() % numPlayers), int(engine() % numPlayers));
+    while (numCards - popCount(position.played) - position.numInTrick > plies) {
+        const CardMask moves = position.legalMoves();
+        position.play(nthCard(moves, int(engine() % popCount(moves))));
+    }
+    return position;
+}
+
+}
+
+// Time per position with the scalar and the AVX2 kernel, one call per
+// position and batched, over positions from every stage of the game.
+BENCHMARK(netEvaluator)
+{
+    std::minstd_rand engine(113);
+    std::vector<Position> positions;
+    for (int i = 0; i < 4096; ++i)
+        positions.push_back(randomPosition(Rules::get(Game::Type(i % numGameTypes), Color(i % numColors)), engine, 1 + i % 32));
+    std::vector<float> points(positions.size());
+
+    NetEvaluator evaluator;
+    evaluator.setWeights(randomWeights(engine));
+    constexpr int numRounds = 50;
+    for (int avx2 = 0; avx2 < 2; ++avx2) {
+        evaluator.setUseAvx2(avx2);
+        float sum = 0;
+        Bench::Timer single;
+        for (int r = 0; r < numRounds; ++r) {
+            for (const Position& position : positions)
+                sum += evaluator.evaluate(position);
+        }
+        const double singleSeconds = single.seconds();
+
+        Bench::Timer batched;
+        for (int r = 0; r < numRounds; ++r)
+            evaluator.evaluate(positions.data(), positions.size(), points.data());
+        const double batchedSeconds = batched.seconds();
+
+        const double count = double(numRounds) * positions.size();
+        std::cout << "    " << (avx2 ? "avx2" : "scalar") << ": " << singleSeconds * 1e9 / count << " ns per position, "
+                  << batchedSeconds * 1e9 / count << " ns batched (" << sum + points[0] << ")" << std::endl;
+    }
+}
+
+// A search of the current stich and one or two more, with the evaluator
+// at the leaves, against solving to the end, with 20 and 28 cards left to
+// play. The search only pays off while the exact solve is expensive.
+BENCHMARK(depthSearch)
+{
+    std::minstd_rand engine(127);
+    NetEvaluator evaluator;
+    evaluator.setWeights(randomWeights(engine));
+    DepthSearch search(evaluator);
+    Solver solver;
+
+    constexpr int numPositions = 100;
+    for (int plies : { 12, 20, 28 }) {
+        double searchSeconds[2] = {};
+        double solveSeconds = 0;
+        size_t leaves[2] = {};
+        for (int i = 0; i < numPositions; ++i) {
+            const Position position = randomPosition(Rules::get(Game::Type(i % numGameTypes), Color(i % numColors)), engine, plies);
+            for (int depth = 1; depth <= 2; ++depth) {
+                Bench::Timer timer;
+                search.value(position, depth);
+                searchSeconds[depth - 1] += timer.seconds();
+                leaves[depth - 1] += search.numLeaves();
+            }
+
+            solver.clear();
+            Bench::Timer solve;
+            solver.value(position);
+            solveSeconds += solve.seconds();
+        }
+        std::cout << "    " << plies << " cards left, exact: " << solveSeconds * 1e6 / numPositions << " us";
+        for (int depth = 1; depth <= 2; ++depth)
+            std::cout << "; depth " << depth << ": " << searchSeconds[depth - 1] * 1e6 / numPositions << " us, "
+                      << double(leaves[depth - 1]) / numPositions << " leaves";
+        std::cout << std::endl;
+    }
+}
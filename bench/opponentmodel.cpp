@@ -0,0 +1,105 @@
+#include "Bench.h"
+
+#include <OpponentModel.h>
+#include <Ranking.h>
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+template <typename Engine>
+GameRecord smearedGame(const Rules& rules, const PlayModel& model, Engine& engine)
+{
+    const int declarer = int(engine() % numPlayers);
+    const Position start(rules, randomDeal(engine), declarer, int(engine() % numPlayers));
+    Position position = start;
+    std::uniform_real_distribution<double> uniform(0, 1);
+    uint8_t cards[numCards];
+    for (int i = 0; i < numCards; ++i) {
+        const CardMask moves = position.legalMoves();
+        double x = uniform(engine);
+        int card = lowestCard(moves);
+        for (CardMask rest = moves; rest; rest &= rest - 1) {
+            card = lowestCard(rest);
+            x -= model.probability(position, card);
+            if (x <= 0)
+                break;
+        }
+        cards[i] = uint8_t(card);
+        position.play(card);
+    }
+    return GameLog::record(start, declarer, cards);
+}
+
+}
+
+// Streams a log of 50000 Sauspiele played by SmearPlayModel into
+// PlayCounts with 1 and 2 threads, then scores the fitted model on 2000
+// new games of the same kind: log likelihood per card, against uniform
+// play and SmearPlayModel itself, and the time per query.
+BENCHMARK(opponentModel)
+{
+    const Rules& rules = Rules::get(Game::SauSpiel, Eichel);
+    const SmearPlayModel smear;
+    const std::string fileName = "opponentmodel.bench.bin";
+    constexpr int numGames = 50000;
+    constexpr size_t chunkSize = 1024;
+
+    std::minstd_rand engine(131);
+    {
+        GameLog::Writer writer(fileName);
+        for (int i = 0; i < numGames; ++i)
+            writer.write(smearedGame(rules, smear, engine));
+    }
+
+    OpponentModel model;
+    for (int numThreads = 1; numThreads <= 2; ++numThreads) {
+        PlayCounts counts(numThreads);
+        GameLog::Reader reader(fileName);
+        Bench::Timer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<GameRecord> records(chunkSize);
+                size_t count;
+                while ((count = reader.read(records.data(), records.size())) > 0) {
+                    for (size_t i = 0; i < count; ++i)
+                        counts.add(records[i], t);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        std::cout << "    " << numThreads << " thread(s): " << numGames / timer.seconds() << " games per second" << std::endl;
+        model = counts.model();
+    }
+    std::remove(fileName.c_str());
+
+    const UniformPlayModel uniform;
+    const PlayModel *models[] = { &uniform, &model, &smear };
+    const char *names[] = { "uniform", "fitted", "smear" };
+    std::vector<GameRecord> games;
+    for (int i = 0; i < 2000; ++i)
+        games.push_back(smearedGame(rules, smear, engine));
+
+    for (int m = 0; m < 3; ++m) {
+        double logLikelihood = 0;
+        long queries = 0;
+        Bench::Timer timer;
+        for (const GameRecord& game : games) {
+            Position position = game.start();
+            for (int c = 0; c < numCards; ++c) {
+                logLikelihood += std::log(models[m]->probability(position, game.cards[c]));
+                ++queries;
+                position.play(game.cards[c]);
+            }
+        }
+        std::cout << "    " << names[m] << ": log likelihood per card " << logLikelihood / queries
+                  << ", " << timer.seconds() * 1e9 / queries << " ns per query" << std::endl;
+    }
+}
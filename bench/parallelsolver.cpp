@@ -0,0 +1,54 @@
+#include "Bench.h"
+
+#include <ParallelSolver.h>
+#include <Ranking.h>
+
+#include <thread>
+
+using namespace SchafKopf;
+
+// Solo deals played by the player with the most trumps, after one random
+// stich, solved with 1 to N threads
+BENCHMARK(parallelSolver)
+{
+    const Rules rules(Game::Solo, Herz);
+    std::minstd_rand engine(71);
+    std::vector<Position> positions;
+    while (positions.size() < 8) {
+        const Deal deal = randomDeal(engine);
+        int declarer = 0;
+        for (int p = 1; p < numPlayers; ++p) {
+            if (popCount(deal.hands[p] & rules.trumps()) > popCount(deal.hands[declarer] & rules.trumps()))
+                declarer = p;
+        }
+        // hard ones: the declarer has a chance, but does not walk it
+        if (popCount(deal.hands[declarer] & rules.trumps()) != 5)
+            continue;
+        Position position(rules, deal, declarer, int(positions.size()) % numPlayers);
+        while (position.numStiche() < 1) {
+            const CardMask moves = position.legalMoves();
+            position.play(nthCard(moves, int(engine() % popCount(moves))));
+        }
+        positions.push_back(position);
+    }
+
+    const int maxThreads = std::max(4, int(std::thread::hardware_concurrency()));
+    std::cout << "    " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    double single = 0;
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        ParallelSolver solver(numThreads);
+        int checksum = 0;
+        double seconds = 0;
+        for (const Position& position : positions) {
+            solver.clear();
+            Bench::Timer timer;
+            checksum += solver.value(position);
+            seconds += timer.seconds();
+        }
+        if (numThreads == 1)
+            single = seconds;
+        std::cout << "    " << numThreads << " threads: " << seconds * 1000 / positions.size()
+                  << " ms per position, speedup " << single / seconds << ", "
+                  << solver.nodes() / positions.size() << " nodes (" << checksum << ")" << std::endl;
+    }
+}
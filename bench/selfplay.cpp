@@ -0,0 +1,61 @@
+#include "Bench.h"
+
+#include <ExpertAi.h>
+#include <NetTrainer.h>
+#include <SelfPlay.h>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace SchafKopf;
+
+// Self-play games of ExpertAi through the shard writer, then a few epochs
+// of training on 1 and 4 threads. The error is the root mean squared
+// error in points on games the trainer did not see, against always
+// guessing the mean of the training samples.
+BENCHMARK(selfPlay)
+{
+    constexpr int numGames = 20000;
+    const std::string prefix = "selfplaybench";
+    std::vector<Sample> samples;
+    {
+        TrainingData::ShardWriter writer(prefix, size_t(1) << 18);
+        Bench::Timer timer;
+        SelfPlay::run<ExpertAi>(writer, numGames, 1, 5);
+        std::cout << "    self-play: " << numGames / timer.seconds() << " games/s, " << writer.numShards() << " shards"
+                  << std::endl;
+        for (int s = 0; s < writer.numShards(); ++s) {
+            TrainingData::readShard(TrainingData::shardName(prefix, s), samples);
+            std::remove(TrainingData::shardName(prefix, s).c_str());
+        }
+    }
+
+    const size_t numHeldBack = samples.size() / 10;
+    const std::vector<Sample> heldBack(samples.end() - std::ptrdiff_t(numHeldBack), samples.end());
+    samples.resize(samples.size() - numHeldBack);
+
+    double mean = 0;
+    for (const Sample& sample : samples)
+        mean += sample.points;
+    mean /= samples.size();
+    double squared = 0;
+    for (const Sample& sample : heldBack)
+        squared += (sample.points - mean) * (sample.points - mean);
+    std::cout << "    guessing the mean: " << std::sqrt(squared / heldBack.size()) << " points" << std::endl;
+
+    constexpr int numEpochs = 3;
+    for (int numThreads : { 1, 4 }) {
+        NetTrainer trainer;
+        trainer.setNumThreads(numThreads);
+        Bench::Timer timer;
+        for (int e = 0; e < numEpochs; ++e)
+            trainer.epoch(samples);
+        const double seconds = timer.seconds();
+
+        NetEvaluator evaluator;
+        evaluator.setWeights(trainer.weights());
+        std::cout << "    " << numThreads << " threads: " << numEpochs * samples.size() / seconds / 1000
+                  << "k samples/s, " << NetTrainer::error(trainer.weights(), heldBack) << " points, quantized "
+                  << NetTrainer::error(evaluator, heldBack) << std::endl;
+    }
+}
@@ -0,0 +1,194 @@
+#include "Bench.h"
+
+#include <Ranking.h>
+#include <Solver.h>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+// the same positions every run: a few random stiche into a game played by
+// whoever has the most trumps
+std::vector<Position> positions(const Rules& rules, int numPositions, int numStiche)
+{
+    std::minstd_rand engine(43);
+    std::vector<Position> result;
+    for (int i = 0; i < numPositions; ++i) {
+        const Deal deal = randomDeal(engine);
+        int declarer = 0;
+        for (int p = 1; p < numPlayers; ++p) {
+            if (popCount(deal.hands[p] & rules.trumps()) > popCount(deal.hands[declarer] & rules.trumps()))
+                declarer = p;
+        }
+        Position position(rules, deal, declarer, i % numPlayers);
+        while (position.numStiche() < numStiche) {
+            const CardMask moves = position.legalMoves();
+            position.play(nthCard(moves, int(engine() % popCount(moves))));
+        }
+        result.push_back(position);
+    }
+    return result;
+}
+
+template <typename Query>
+void run(const char *name, const std::vector<Position>& positions, Solver::Measure measure, Query query,
+         bool mergeEquivalent = true)
+{
+    Solver solver(measure);
+    solver.setMergeEquivalent(mergeEquivalent);
+    uint64_t nodes = 0;
+    int checksum = 0;
+    double seconds = 0;
+    for (const Position& position : positions) {
+        // every position on its own
+        solver.clear();
+        const uint64_t before = solver.nodes();
+        Bench::Timer timer;
+        checksum += query(solver, position);
+        seconds += timer.seconds();
+        nodes += solver.nodes() - before;
+    }
+    std::cout << "    " << name << ": " << seconds * 1000 / positions.size() << " ms, "
+              << nodes / positions.size() << " nodes per position (" << checksum << ")" << std::endl;
+}
+
+}
+
+BENCHMARK(solver)
+{
+    const Rules rules(Game::Solo, Eichel);
+    const std::vector<Position> set = positions(rules, 32, 2);
+
+    run("alpha-beta value", set, Solver::Points,
+        [](Solver& solver, const Position& position) { return solver.valueAlphaBeta(position); });
+    run("alpha-beta value, all cards", set, Solver::Points,
+        [](Solver& solver, const Position& position) { return solver.valueAlphaBeta(position); }, false);
+    run("MTD(f) value", set, Solver::Points,
+        [](Solver& solver, const Position& position) { return solver.value(position); });
+    run("61 threshold", set, Solver::Points,
+        [](Solver& solver, const Position& position) { return int(solver.declarerWins(position)); });
+    run("91 threshold", set, Solver::Points,
+        [](Solver& solver, const Position& position) { return int(solver.declarerSchneider(position)); });
+    run("schwarz threshold", set, Solver::Stiche,
+        [](Solver& solver, const Position& position) { return int(solver.reaches(position, Player::maxCards)); });
+}
+
+// the same positions solved with a plain Zobrist table and a partition
+// table, each position on its own and with one table for the whole set
+BENCHMARK(partitionTable)
+{
+    const Game::Type types[] = { Game::Solo, Game::Wenz };
+    const char *typeNames[] = { "Solo", "Wenz" };
+
+    for (int t = 0; t < 2; ++t) {
+        const Rules rules(types[t], Gras);
+        const std::vector<Position> set = positions(rules, 32, 2);
+
+        for (int shared = 0; shared < 2; ++shared) {
+            for (int partition = 0; partition < 2; ++partition) {
+                Solver solver;
+                solver.setPartitionTable(partition);
+                int checksum = 0;
+                Bench::Timer timer;
+                for (const Position& position : set) {
+                    if (!shared)
+                        solver.clear();
+                    checksum += solver.value(position);
+                }
+                const double seconds = timer.seconds();
+                std::cout << "    " << typeNames[t] << (partition ? ", partition" : ", Zobrist")
+                          << (shared ? ", shared table: " : ": ")
+                          << seconds * 1000 / set.size() << " ms, "
+                          << solver.nodes() / set.size() << " nodes per position, "
+                          << 100.0 * solver.hits() / solver.probes() << "% hits (" << checksum << ")" << std::endl;
+            }
+        }
+    }
+}
+
+BENCHMARK(bounds)
+{
+    const Rules rules(Game::Solo, Schelln);
+    const std::vector<Position> set = positions(rules, 32, 2);
+
+    {
+        // the estimator alone, on positions at every stich
+        std::vector<Position> all;
+        for (Position position : set) {
+            while (!position.finished()) {
+                if (position.numInTrick == 0)
+                    all.push_back(position);
+                position.play(lowestCard(position.legalMoves()));
+            }
+        }
+        constexpr int rounds = 1000;
+        int checksum = 0;
+        Bench::Timer timer;
+        for (int r = 0; r < rounds; ++r) {
+            for (const Position& position : all) {
+                const Bounds bounds = pointBounds(position);
+                checksum += bounds.lower + bounds.upper;
+            }
+        }
+        std::cout << "    pointBounds: " << timer.seconds() * 1e9 / (double(rounds) * all.size())
+                  << " ns (" << checksum << ")" << std::endl;
+    }
+
+    for (int use = 0; use < 2; ++use) {
+        Solver solver;
+        solver.setUseBounds(use);
+        int checksum = 0;
+        double seconds = 0;
+        for (const Position& position : set) {
+            solver.clear();
+            Bench::Timer timer;
+            checksum += solver.value(position) + solver.declarerWins(position);
+            seconds += timer.seconds();
+        }
+        std::cout << "    " << (use ? "with bounds" : "without bounds") << ": "
+                  << seconds * 1000 / set.size() << " ms, " << solver.nodes() / set.size()
+                  << " nodes per position (" << checksum << ")" << std::endl;
+    }
+}
+
+// All moves in 32 worlds of the same root, one call per world or one
+// batch. Keys include the game, so the worlds never need a clear() in
+// between; one memset of the table per world would dwarf the search.
+BENCHMARK(worlds)
+{
+    const Rules rules(Game::Solo, Gras);
+    const std::vector<Position> roots = positions(rules, 4, 3);
+    constexpr int numWorlds = 32;
+
+    std::minstd_rand engine(73);
+    std::vector<std::vector<Deal>> worlds;
+    for (const Position& root : roots) {
+        worlds.emplace_back();
+        for (int w = 0; w < numWorlds; ++w)
+            worlds.back().push_back(randomWorld(root, root.toMove(), engine));
+    }
+
+    const char *names[] = { "one call per world", "batch", "batch with history" };
+    for (int mode = 0; mode < 3; ++mode) {
+        Solver solver;
+        solver.setUseHistory(mode == 2);
+        int checksum = 0;
+        Bench::Timer timer;
+        for (size_t r = 0; r < roots.size(); ++r) {
+            solver.clear();
+            if (mode == 0) {
+                for (const Deal& world : worlds[r]) {
+                    for (int16_t value : solver.solveWorlds(roots[r], &world, 1).values)
+                        checksum += value;
+                }
+            } else {
+                for (int16_t value : solver.solveWorlds(roots[r], worlds[r].data(), worlds[r].size()).values)
+                    checksum += value;
+            }
+        }
+        const double seconds = timer.seconds();
+        std::cout << "    " << names[mode] << ": " << seconds * 1000 / (roots.size() * numWorlds) << " ms, "
+                  << solver.nodes() / (roots.size() * numWorlds) << " nodes per world (" << checksum << ")" << std::endl;
+    }
+}
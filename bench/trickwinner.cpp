@@ -0,0 +1,75 @@
+#include "Bench.h"
+
+#include <Rules.h>
+
+#include <random>
+
+using namespace SchafKopf;
+
+BENCHMARK(trickWinner)
+{
+    constexpr size_t numStiche = 1 << 16;
+    constexpr int numRounds = 16;
+
+    std::minstd_rand engine(41);
+    std::vector<uint8_t> stiche;
+    uint8_t deck[numCards];
+    for (int i = 0; i < numCards; ++i)
+        deck[i] = uint8_t(i);
+    for (size_t i = 0; i < numStiche; ++i) {
+        std::shuffle(deck, deck + numCards, engine);
+        stiche.insert(stiche.end(), deck, deck + numPlayers);
+    }
+
+    Game game;
+    game.gameType = Game::Solo;
+    game.gameColor = Eichel;
+    const Rules& rules = Rules::get(game.gameType, game.gameColor);
+
+    std::vector<Card> cards;
+    for (uint8_t card : stiche)
+        cards.push_back(cardAt(card));
+
+    auto report = [](const char *name, double seconds, int checksum) {
+        std::cout << "    " << name << ": " << numStiche * numRounds / seconds / 1e6
+                  << " M stiche/s (" << checksum << ")" << std::endl;
+    };
+
+    {
+        Bench::Timer timer;
+        int checksum = 0;
+        for (int round = 0; round < numRounds; ++round) {
+            for (size_t i = 0; i < numStiche; ++i) {
+                const Card *stich = &cards[i * numPlayers];
+                int winner = 0;
+                for (int j = 1; j < numPlayers; ++j) {
+                    if (game.sticht(stich[winner], stich[j]))
+                        winner = j;
+                }
+                checksum += winner;
+            }
+        }
+        report("Game::sticht", timer.seconds(), checksum);
+    }
+
+    {
+        Bench::Timer timer;
+        int checksum = 0;
+        for (int round = 0; round < numRounds; ++round) {
+            for (size_t i = 0; i < numStiche; ++i)
+                checksum += rules.trickWinner(&stiche[i * numPlayers]);
+        }
+        report("Rules::trickWinner", timer.seconds(), checksum);
+    }
+
+    {
+        std::vector<uint8_t> winners(numStiche);
+        Bench::Timer timer;
+        int checksum = 0;
+        for (int round = 0; round < numRounds; ++round) {
+            rules.trickWinners(stiche.data(), numStiche, winners.data());
+            checksum += winners[size_t(round)];
+        }
+        report("Rules::trickWinners", timer.seconds(), checksum);
+    }
+}
@@ -0,0 +1,122 @@
+#include "Bench.h"
+
+#include <Ranking.h>
+#include <WorldCache.h>
+
+using namespace SchafKopf;
+
+// Player 0 decides with 16 worlds from the third stich on in Solo games
+// of random cards, once keeping the worlds from decision to decision and
+// once drawing all of them again at every decision, with the same solver.
+BENCHMARK(worldCache)
+{
+    const Rules rules(Game::Solo, Eichel);
+    constexpr int numGames = 6;
+    constexpr int numWorlds = 16;
+
+    for (int fresh = 0; fresh < 2; ++fresh) {
+        std::minstd_rand engine(89);
+        WorldCache cache(0, numWorlds, 5);
+        double seconds[2] = { 0, 0 };
+        int decisions[2] = { 0, 0 };
+        int checksum = 0;
+
+        for (int g = 0; g < numGames; ++g) {
+            Position position(rules, randomDeal(engine), g % numPlayers, 0);
+            cache.reset(position);
+            while (!position.finished()) {
+                const int who = position.toMove();
+                if (who == 0 && position.numStiche() >= 2) {
+                    Bench::Timer timer;
+                    if (fresh)
+                        cache.clearWorlds();
+                    checksum += cache.solve(position).values[0];
+                    const int late = position.numStiche() >= 5;
+                    seconds[late] += timer.seconds();
+                    ++decisions[late];
+                }
+                const CardMask moves = position.legalMoves();
+                const int card = nthCard(moves, int(engine() % popCount(moves)));
+                position.play(card);
+                cache.cardPlayed(card);
+            }
+        }
+
+        std::cout << "    " << (fresh ? "fresh worlds" : "cached worlds") << ": "
+                  << seconds[0] * 1000 / decisions[0] << " ms middle game, "
+                  << seconds[1] * 1000 / decisions[1] << " ms late game per decision ("
+                  << checksum << ")" << std::endl;
+    }
+}
+
+// The others play by SmearPlayModel in Sauspiel games of random cards.
+// Player 0 keeps 32 worlds, once weighted by that model and once not, and
+// at every stich of the second half checks how many hidden cards the
+// worlds put into the right hand, weighted by the weights of the worlds.
+BENCHMARK(playModel)
+{
+    const Rules rules(Game::SauSpiel, Schelln);
+    const SmearPlayModel model;
+    constexpr int numGames = 200;
+    constexpr int numWorlds = 32;
+
+    for (int weighted = 0; weighted < 2; ++weighted) {
+        std::minstd_rand engine(101);
+        std::uniform_real_distribution<double> uniform(0, 1);
+        WorldCache cache(0, numWorlds, 7);
+        cache.setPlayModel(weighted ? &model : nullptr);
+        double right = 0;
+        double ess = 0;
+        int checks = 0;
+        int resamples = 0;
+
+        Bench::Timer timer;
+        for (int g = 0; g < numGames; ++g) {
+            Position position(rules, randomDeal(engine), g % numPlayers, 0);
+            cache.reset(position);
+            while (!position.finished()) {
+                const int who = position.toMove();
+                CardMask hidden = 0;
+                for (int p = 1; p < numPlayers; ++p)
+                    hidden |= position.hands[p];
+                if (who == 0 && position.numStiche() >= 4 && hidden) {
+                    cache.topUp();
+                    const std::vector<double> weights = cache.weights();
+                    for (size_t w = 0; w < weights.size(); ++w) {
+                        int count = 0;
+                        for (int p = 1; p < numPlayers; ++p)
+                            count += popCount(cache.worlds()[w].deal.hands[p] & position.hands[p]);
+                        right += weights[w] * count / popCount(hidden);
+                    }
+                    ess += cache.effectiveSampleSize();
+                    ++checks;
+                    if (cache.effectiveSampleSize() < numWorlds / 4) {
+                        cache.resample();
+                        ++resamples;
+                    }
+                }
+
+                const CardMask moves = position.legalMoves();
+                int card = lowestCard(moves);
+                if (who == 0) {
+                    card = nthCard(moves, int(engine() % popCount(moves)));
+                } else {
+                    double x = uniform(engine);
+                    for (CardMask rest = moves; rest; rest &= rest - 1) {
+                        card = lowestCard(rest);
+                        x -= model.probability(position, card);
+                        if (x <= 0)
+                            break;
+                    }
+                }
+                position.play(card);
+                cache.cardPlayed(card);
+            }
+        }
+
+        std::cout << "    " << (weighted ? "weighted" : "unweighted") << ": "
+                  << right * 100 / checks << "% of hidden cards right, effective worlds "
+                  << ess / checks << ", " << resamples << " resamples, "
+                  << timer.seconds() * 1000 / numGames << " ms per game" << std::endl;
+    }
+}
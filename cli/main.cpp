@@ -1,6 +1,7 @@
 #include <Schafkopf.h>
 #include <RandomAi.h>
 #include <ObserverAi.h>
+#include <HandTable.h>
 
 #ifdef EMSCRIPTEN
 #include <emscripten.h>
@@ -17,7 +18,10 @@ struct CLI
         : ai0{game, game.players[0]},
           ai1{game, game.players[1]},
           ai2{game, game.players[2]},
-          ai3{game, game.players[3]}
+          ai3{game, game.players[3]},
+          handTable{handTableFileName()},
+          evaluatorBiddingAi{evaluator},
+          biddingAi{handTable, &evaluatorBiddingAi}
     {
         newGame();
     }
@@ -25,20 +29,50 @@ struct CLI
     void newGame() {
         game.reset();
 
-        game.gameType = Game::Solo;
-        game.gameColor = Color::Herz;
-
         game.ais[0] = &ai0;
         game.ais[1] = &ai1;
         game.ais[2] = &ai2;
         game.ais[3] = &ai3;
+
+        runAuction();
+
+        for (AI *ai : game.ais)
+            ai->reset();
+    }
+
+    // the AIs bid for their seats, player 1 passes and plays a Herz Solo
+    // if nobody else wants to play
+    void runAuction()
+    {
+        Auction auction(0);
+        while (!auction.finished()) {
+            const int seat = auction.activeSeat();
+            std::optional<Contract> contract;
+            if (seat != 0)
+                contract = biddingAi.bid(auction, handMask(game.players[seat]));
+            auction.bid(contract);
+        }
+
+        if (auction.hasContract()) {
+            game.gameType = auction.contract().type;
+            game.gameColor = auction.contract().color;
+            game.declarer = auction.declarer();
+        } else {
+            game.gameType = Game::Solo;
+            game.gameColor = Color::Herz;
+            game.declarer = 0;
+        }
+
+        std::cout << "Player " << game.declarer + 1 << " plays ";
+        printGameType();
+        std::cout << std::endl;
     }
 
     void playCard(int c)
     {
         game.putCard(c);
         if (game.activePile.numCards == 0) {
-            const Stich& lastStich = game.lastStichPlayer().lastStich();
+            const Stich lastStich = game.lastStich();
             std::cout << "Stich:" << std::endl;
             for (int i = 0; i < numPlayers; ++i)
                 std::cout << "    P" << lastStich.cards[i].first + 1 << ": " << lastStich.cards[i].second << std::endl;
@@ -52,21 +86,39 @@ struct CLI
             for (int i = 0; i < numPlayers; ++i)
                 std::cout << "    Player " << i + 1 << ": " << game.players[i].points << " points" << std::endl;
 
-            // ### TODO - support sauspiel
-            if (game.players[0].points > 60)
-                std::cout << "Player 1 won!" << std::endl;
-            else
-                std::cout << "Player 1 lost!" << std::endl;
-            game.reset();
+            printSettlement(evaluator.scoring().settle(FinishedGame::fromGame(game)));
+            newGame();
         }
     }
 
-    void printCards() const
+    void printSettlement(const Settlement& settlement) const
+    {
+        std::cout << "Player " << game.declarer + 1 << (settlement.won ? " won" : " lost")
+                  << " with " << settlement.declarerPoints << " points";
+        if (settlement.schwarz)
+            std::cout << ", schwarz";
+        else if (settlement.schneider)
+            std::cout << ", schneider";
+        if (settlement.laufende >= evaluator.scoring().tariff().minLaufende[game.gameType])
+            std::cout << ", " << settlement.laufende << " Laufende";
+        std::cout << std::endl;
+
+        for (int i = 0; i < numPlayers; ++i)
+            std::cout << "    Player " << i + 1 << ": " << settlement.money[i] << std::endl;
+    }
+
+    void printGameType() const
     {
-        std::cout << "Game: ";
         if (game.gameType != Game::Wenz && game.gameType != Game::Geier)
             std::cout << colorNames[game.gameColor] << " ";
-        std::cout << GameTypeNames[game.gameType] << std::endl;
+        std::cout << GameTypeNames[game.gameType];
+    }
+
+    void printCards() const
+    {
+        std::cout << "Game: ";
+        printGameType();
+        std::cout << " by Player " << game.declarer + 1 << std::endl;
 
         for (int i = 0; i < numPlayers; ++i) {
             std::cout << "Player " << i + 1 << " (" << game.players[i].points << ")";
@@ -79,6 +131,13 @@ struct CLI
         }
     }
 
+    // the table is only mapped once the first AI bids
+    static std::string handTableFileName()
+    {
+        const char *fileName = std::getenv("SCHAFKOPF_HANDTABLE");
+        return fileName ? fileName : "handtable.bin";
+    }
+
     static void printPrompt()
     {
         std::cout << "Schaf> " << std::flush;
@@ -256,6 +315,11 @@ struct CLI
     RandomAi ai1;
     RandomAi ai2;
     RandomAi ai3;
+
+    ContractEvaluator evaluator;
+    HandTable handTable;
+    EvaluatorBiddingAi evaluatorBiddingAi;
+    TableBiddingAi biddingAi;
 };
 
 #ifdef EMSCRIPTEN
@@ -0,0 +1,306 @@
+#include "BatchSim.h"
+#include "Cpu.h"
+#include "Ranking.h"
+
+namespace SchafKopf
+{
+
+static constexpr int numPlies = numCards;
+
+// xorshift32, the same in both kernels
+static inline uint32_t nextRandom(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void runScalar(const BatchSim::Block& block, const BatchSim::Tables& tables, BatchSim::Policy policy)
+{
+    for (int lane = 0; lane < BatchSim::laneWidth; ++lane) {
+        CardMask hands[numPlayers];
+        CardMask won[numPlayers];
+        for (int p = 0; p < numPlayers; ++p) {
+            hands[p] = block.hands[p][lane];
+            won[p] = 0;
+        }
+        int leader = block.leader[lane];
+        uint32_t random = block.random[lane];
+
+        CardMask trick = 0;
+        CardMask leadMask = 0;
+        int best = 0;
+        int winner = 0;
+
+        for (int ply = 0; ply < numPlies; ++ply) {
+            const int position = ply & (numPlayers - 1);
+            const int player = (leader + position) & (numPlayers - 1);
+            const CardMask hand = hands[player];
+
+            CardMask legal = hand;
+            if (position) {
+                const CardMask follow = hand & leadMask;
+                legal = follow ? follow : hand;
+            }
+
+            if (policy == BatchSim::RandomLegal) {
+                const uint32_t n = uint32_t((uint64_t(nextRandom(random)) * uint32_t(popCount(legal))) >> 32);
+                for (uint32_t k = 0; k < n; ++k)
+                    legal &= legal - 1;
+            }
+            const CardMask bit = lowestBit(legal);
+            const int card = lowestCard(bit);
+
+            hands[player] &= ~bit;
+            trick |= bit;
+
+            const int strength = tables.strength[card];
+            if (!position) {
+                leadMask = tables.suitMask[card];
+                best = strength;
+                winner = player;
+            } else if ((bit & (leadMask | tables.trumps)) && strength > best) {
+                best = strength;
+                winner = player;
+            }
+
+            if (position == numPlayers - 1) {
+                won[winner] |= trick;
+                leader = winner;
+                trick = 0;
+            }
+        }
+
+        CardMask teamWon = 0;
+        for (int p = 0; p < numPlayers; ++p) {
+            block.won[p][lane] = won[p];
+            if ((block.declarerTeam[lane] >> p) & 1)
+                teamWon |= won[p];
+        }
+        block.declarerPoints[lane] = maskPoints(teamWon);
+        block.random[lane] = random;
+    }
+}
+
+#ifdef SCHAFKOPF_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i popCount8(__m256i v)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+    const __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi32(v, 4), nibble));
+    // sum the four byte counts into the top byte of each lane
+    const __m256i bytes = _mm256_add_epi8(low, high);
+    return _mm256_srli_epi32(_mm256_mullo_epi32(bytes, _mm256_set1_epi32(0x01010101)), 24);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i lowestBit8(__m256i v)
+{
+    return _mm256_and_si256(v, _mm256_sub_epi32(_mm256_setzero_si256(), v));
+}
+
+// index of the single set bit of each lane, from the exponent of its float value
+__attribute__((target("avx2")))
+static inline __m256i bitIndex8(__m256i bit)
+{
+    const __m256i exponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(bit)), 23);
+    return _mm256_and_si256(_mm256_sub_epi32(_mm256_and_si256(exponent, _mm256_set1_epi32(0xff)),
+                                              _mm256_set1_epi32(127)),
+                            _mm256_set1_epi32(numCards - 1));
+}
+
+// (a * b) >> 32 per lane
+__attribute__((target("avx2")))
+static inline __m256i mulHigh8(__m256i a, __m256i b)
+{
+    const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+__attribute__((target("avx2")))
+static void runAvx2(const BatchSim::Block& block, const BatchSim::Tables& tables, BatchSim::Policy policy)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i playerMask = _mm256_set1_epi32(numPlayers - 1);
+    const __m256i trumps = _mm256_set1_epi32(int(tables.trumps));
+    const __m256i players[numPlayers] = {
+        _mm256_set1_epi32(0), _mm256_set1_epi32(1), _mm256_set1_epi32(2), _mm256_set1_epi32(3)
+    };
+
+    __m256i hands[numPlayers];
+    __m256i won[numPlayers];
+    for (int p = 0; p < numPlayers; ++p) {
+        hands[p] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.hands[p]));
+        won[p] = zero;
+    }
+    __m256i leader = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.leader));
+    __m256i random = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.random));
+
+    __m256i trick = zero;
+    __m256i leadMask = zero;
+    __m256i best = zero;
+    __m256i winner = zero;
+
+    for (int ply = 0; ply < numPlies; ++ply) {
+        const int position = ply & (numPlayers - 1);
+        const __m256i player = _mm256_and_si256(_mm256_add_epi32(leader, _mm256_set1_epi32(position)), playerMask);
+
+        __m256i isPlayer[numPlayers];
+        __m256i hand = zero;
+        for (int p = 0; p < numPlayers; ++p) {
+            isPlayer[p] = _mm256_cmpeq_epi32(player, players[p]);
+            hand = _mm256_or_si256(hand, _mm256_and_si256(hands[p], isPlayer[p]));
+        }
+
+        __m256i legal = hand;
+        if (position) {
+            const __m256i follow = _mm256_and_si256(hand, leadMask);
+            legal = _mm256_blendv_epi8(follow, hand, _mm256_cmpeq_epi32(follow, zero));
+        }
+
+        if (policy == BatchSim::RandomLegal) {
+            random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 13));
+            random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 17));
+            random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 5));
+
+            // drop the n lowest legal cards, there are at most maxCards
+            const __m256i n = mulHigh8(random, popCount8(legal));
+            for (int k = 0; k < Player::maxCards - 1; ++k) {
+                const __m256i drop = _mm256_cmpgt_epi32(n, _mm256_set1_epi32(k));
+                legal = _mm256_andnot_si256(_mm256_and_si256(lowestBit8(legal), drop), legal);
+            }
+        }
+        const __m256i bit = lowestBit8(legal);
+        const __m256i card = bitIndex8(bit);
+
+        for (int p = 0; p < numPlayers; ++p)
+            hands[p] = _mm256_andnot_si256(_mm256_and_si256(bit, isPlayer[p]), hands[p]);
+        trick = _mm256_or_si256(trick, bit);
+
+        const __m256i strength = _mm256_i32gather_epi32(tables.strength, card, 4);
+        if (!position) {
+            leadMask = _mm256_i32gather_epi32(reinterpret_cast<const int *>(tables.suitMask), card, 4);
+            best = strength;
+            winner = player;
+        } else {
+            const __m256i counts = _mm256_and_si256(bit, _mm256_or_si256(leadMask, trumps));
+            const __m256i valid = _mm256_andnot_si256(_mm256_cmpeq_epi32(counts, zero), _mm256_set1_epi32(-1));
+            const __m256i better = _mm256_and_si256(_mm256_cmpgt_epi32(strength, best), valid);
+            best = _mm256_blendv_epi8(best, strength, better);
+            winner = _mm256_blendv_epi8(winner, player, better);
+        }
+
+        if (position == numPlayers - 1) {
+            for (int p = 0; p < numPlayers; ++p)
+                won[p] = _mm256_or_si256(won[p], _mm256_and_si256(trick, _mm256_cmpeq_epi32(winner, players[p])));
+            leader = winner;
+            trick = zero;
+        }
+    }
+
+    const __m256i team = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.declarerTeam));
+    __m256i teamWon = zero;
+    for (int p = 0; p < numPlayers; ++p) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(block.won[p]), won[p]);
+        const __m256i inTeam = _mm256_cmpeq_epi32(_mm256_and_si256(team, _mm256_set1_epi32(1 << p)),
+                                                  _mm256_set1_epi32(1 << p));
+        teamWon = _mm256_or_si256(teamWon, _mm256_and_si256(won[p], inTeam));
+    }
+
+    static const struct { CardType type; int points; } pointCards[] = {
+        { Ass, 11 }, { Zehner, 10 }, { Koenig, 4 }, { Ober, 3 }, { Unter, 2 }
+    };
+    __m256i points = zero;
+    for (const auto& pointCard : pointCards) {
+        const __m256i cards = _mm256_and_si256(teamWon, _mm256_set1_epi32(int(typeMask(pointCard.type))));
+        points = _mm256_add_epi32(points, _mm256_mullo_epi32(popCount8(cards), _mm256_set1_epi32(pointCard.points)));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(block.declarerPoints), points);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(block.random), random);
+}
+
+#endif
+
+BatchSim::BatchSim(const Rules& rules, size_t numGames)
+    : m_rules(&rules),
+      m_numGames(numGames),
+      m_useAvx2(hasAvx2())
+{
+    m_tables.trumps = rules.trumps();
+    for (int i = 0; i < numCards; ++i) {
+        m_tables.strength[i] = rules.strength(i);
+        m_tables.suitMask[i] = rules.suitMask(rules.suit(i));
+    }
+
+    const size_t size = (numGames + laneWidth - 1) / laneWidth * laneWidth;
+    for (int p = 0; p < numPlayers; ++p) {
+        m_hands[p].resize(size);
+        m_won[p].resize(size);
+    }
+    m_leader.resize(size);
+    m_declarerTeam.resize(size);
+    m_declarerPoints.resize(size);
+    m_random.resize(size);
+
+    // padding games are played too, so they need valid hands as well
+    const Deal deal = dealFromRank(0);
+    for (size_t i = 0; i < size; ++i)
+        setGame(i, deal, 0, 0);
+}
+
+void BatchSim::setGame(size_t game, const Deal& deal, int declarer, int leader)
+{
+    for (int p = 0; p < numPlayers; ++p) {
+        m_hands[p][game] = deal.hands[p];
+        m_won[p][game] = 0;
+    }
+    m_leader[game] = leader;
+    m_declarerTeam[game] = SchafKopf::declarerTeam(m_rules->type(), m_rules->color(), declarer, deal.hands);
+    m_declarerPoints[game] = 0;
+}
+
+void BatchSim::run(Policy policy, uint32_t seed)
+{
+    for (size_t i = 0; i < m_random.size(); ++i) {
+        // scramble seed and index, xorshift needs a state that is not 0
+        uint32_t state = seed * 0x9e3779b9u + uint32_t(i) * 0x85ebca6bu;
+        state ^= state >> 16;
+        state *= 0x7feb352du;
+        state ^= state >> 15;
+        m_random[i] = state ? state : 1;
+    }
+
+    for (size_t begin = 0; begin < m_random.size(); begin += laneWidth) {
+        Block block;
+        for (int p = 0; p < numPlayers; ++p) {
+            block.hands[p] = &m_hands[p][begin];
+            block.won[p] = &m_won[p][begin];
+        }
+        block.leader = &m_leader[begin];
+        block.declarerTeam = &m_declarerTeam[begin];
+        block.declarerPoints = &m_declarerPoints[begin];
+        block.random = &m_random[begin];
+
+#ifdef SCHAFKOPF_AVX2
+        if (m_useAvx2) {
+            runAvx2(block, m_tables, policy);
+            continue;
+        }
+#endif
+        runScalar(block, m_tables, policy);
+    }
+}
+
+bool BatchSim::hasAvx2()
+{
+    return SchafKopf::hasAvx2();
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Position.h"
+
+#include <vector>
+
+namespace SchafKopf
+{
+
+// Plays many independent games of the same Rules in lockstep, for bulk
+// baseline runs where one Game or Position per game is too slow.
+//
+// All games start at the same time, so every game is at the same card of
+// its stich in every step. The state is kept as one array per field
+// (hands, won cards, leader, ...) and the games are processed in blocks of
+// laneWidth, which maps to one AVX2 register of 32 bit masks. The AVX2
+// kernel is picked at runtime, there is a scalar kernel with exactly the
+// same results for other CPUs.
+class BatchSim
+{
+public:
+    // FirstLegal plays the lowest legal card (like RandomAi plays the first
+    // legal card of its hand), RandomLegal a uniformly random legal card
+    enum Policy
+    {
+        FirstLegal,
+        RandomLegal
+    };
+
+    static constexpr int laneWidth = 8;
+
+    // all games start with the same valid deal until they are set
+    BatchSim(const Rules& rules, size_t numGames);
+
+    const Rules& rules() const { return *m_rules; }
+    size_t numGames() const { return m_numGames; }
+
+    void setGame(size_t game, const Deal& deal, int declarer, int leader);
+
+    // plays all games to the end. RandomLegal draws from a generator per
+    // game that is seeded from seed and the index of the game. The deals
+    // are kept, so the games can be played again with another seed.
+    void run(Policy policy, uint32_t seed = 1);
+
+    CardMask won(size_t game, int player) const { return m_won[player][game]; }
+    int declarerTeam(size_t game) const { return m_declarerTeam[game]; }
+    // points of the declarer team after run()
+    int declarerPoints(size_t game) const { return m_declarerPoints[game]; }
+
+    // true if the CPU has AVX2, run() uses it unless disabled
+    static bool hasAvx2();
+    void setUseAvx2(bool use) { m_useAvx2 = use && hasAvx2(); }
+    bool usesAvx2() const { return m_useAvx2; }
+
+    // the per block state and tables the kernels work on
+    struct Block
+    {
+        const CardMask *hands[numPlayers];
+        CardMask *won[numPlayers];
+        const int32_t *leader;
+        const int32_t *declarerTeam;
+        int32_t *declarerPoints;
+        uint32_t *random;
+    };
+
+    struct Tables
+    {
+        CardMask trumps;
+        // strength of each card, see Rules::strength
+        int32_t strength[numCards];
+        // cards that have to follow each card as the first card of a stich
+        CardMask suitMask[numCards];
+    };
+
+private:
+    const Rules* m_rules;
+    size_t m_numGames;
+    bool m_useAvx2;
+    Tables m_tables;
+
+    // padded to a multiple of laneWidth
+    std::vector<CardMask> m_hands[numPlayers];
+    std::vector<CardMask> m_won[numPlayers];
+    std::vector<int32_t> m_leader;
+    std::vector<int32_t> m_declarerTeam;
+    std::vector<int32_t> m_declarerPoints;
+    std::vector<uint32_t> m_random;
+};
+
+}
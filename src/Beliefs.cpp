@@ -0,0 +1,211 @@
+#include "Beliefs.h"
+#include "Cpu.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SchafKopf
+{
+
+// One iteration, returns how far the rows are off afterwards. The
+// player's row has size 0 and stays empty.
+static float iterateScalar(float matrix[numPlayers][numCards], const float sizes[numPlayers])
+{
+    // rows to the hand sizes
+    for (int p = 0; p < numPlayers; ++p) {
+        float sum = 0;
+        for (int c = 0; c < numCards; ++c)
+            sum += matrix[p][c];
+        const float factor = sum > 0 ? sizes[p] / sum : 0;
+        for (int c = 0; c < numCards; ++c)
+            matrix[p][c] *= factor;
+    }
+
+    // columns to 1
+    for (int c = 0; c < numCards; ++c) {
+        const float sum = matrix[0][c] + matrix[1][c] + matrix[2][c] + matrix[3][c];
+        const float factor = sum > 0 ? 1 / sum : 0;
+        for (int p = 0; p < numPlayers; ++p)
+            matrix[p][c] *= factor;
+    }
+
+    float error = 0;
+    for (int p = 0; p < numPlayers; ++p) {
+        float sum = 0;
+        for (int c = 0; c < numCards; ++c)
+            sum += matrix[p][c];
+        error = std::max(error, std::fabs(sum - sizes[p]));
+    }
+    return error;
+}
+
+#ifdef SCHAFKOPF_AVX2
+
+__attribute__((target("avx2")))
+static inline float horizontalSum(__m256 v)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+// the same with the matrix in registers, a row is 4 vectors of 8 cards
+__attribute__((target("avx2")))
+static float iterateAvx2(float matrix[numPlayers][numCards], const float sizes[numPlayers])
+{
+    constexpr int width = 8;
+    constexpr int numChunks = numCards / width;
+    __m256 m[numPlayers][numChunks];
+    for (int p = 0; p < numPlayers; ++p) {
+        for (int i = 0; i < numChunks; ++i)
+            m[p][i] = _mm256_loadu_ps(matrix[p] + i * width);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    for (int p = 0; p < numPlayers; ++p) {
+        const float sum = horizontalSum(_mm256_add_ps(_mm256_add_ps(m[p][0], m[p][1]), _mm256_add_ps(m[p][2], m[p][3])));
+        const __m256 factor = _mm256_set1_ps(sum > 0 ? sizes[p] / sum : 0);
+        for (int i = 0; i < numChunks; ++i)
+            m[p][i] = _mm256_mul_ps(m[p][i], factor);
+    }
+
+    // 1 / 0 is masked away, it never reaches the matrix
+    for (int i = 0; i < numChunks; ++i) {
+        const __m256 sum = _mm256_add_ps(_mm256_add_ps(m[0][i], m[1][i]), _mm256_add_ps(m[2][i], m[3][i]));
+        const __m256 factor = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1), sum), _mm256_cmp_ps(sum, zero, _CMP_GT_OQ));
+        for (int p = 0; p < numPlayers; ++p)
+            m[p][i] = _mm256_mul_ps(m[p][i], factor);
+    }
+
+    float error = 0;
+    for (int p = 0; p < numPlayers; ++p) {
+        const float sum = horizontalSum(_mm256_add_ps(_mm256_add_ps(m[p][0], m[p][1]), _mm256_add_ps(m[p][2], m[p][3])));
+        error = std::max(error, std::fabs(sum - sizes[p]));
+        for (int i = 0; i < numChunks; ++i)
+            _mm256_storeu_ps(matrix[p] + i * width, m[p][i]);
+    }
+    return error;
+}
+
+#endif
+
+constexpr float Beliefs::tolerance;
+constexpr int Beliefs::maxIterations;
+
+Beliefs::Beliefs()
+    : m_player(0),
+      m_hidden(0),
+      m_useAvx2(hasAvx2())
+{
+    std::fill(&m_matrix[0][0], &m_matrix[0][0] + numPlayers * numCards, 0.0f);
+    std::fill(m_handSizes, m_handSizes + numPlayers, 0);
+}
+
+void Beliefs::setUseAvx2(bool use)
+{
+    m_useAvx2 = use && hasAvx2();
+}
+
+void Beliefs::reset(int player, CardMask hidden, const int handSizes[numPlayers])
+{
+    m_player = player;
+    m_hidden = hidden;
+    for (int p = 0; p < numPlayers; ++p) {
+        m_handSizes[p] = handSizes[p];
+        for (int c = 0; c < numCards; ++c)
+            m_matrix[p][c] = p != player && ((hidden >> c) & 1) ? 1.0f : 0.0f;
+    }
+    update();
+}
+
+void Beliefs::cardPlayed(int who, int card)
+{
+    for (int p = 0; p < numPlayers; ++p)
+        m_matrix[p][card] = 0;
+    m_hidden &= ~cardBit(card);
+    --m_handSizes[who];
+}
+
+void Beliefs::exclude(int who, CardMask cards)
+{
+    if (who == m_player)
+        return;
+    for (CardMask rest = cards & m_hidden; rest; rest &= rest - 1)
+        m_matrix[who][lowestCard(rest)] = 0;
+}
+
+// Cards that only one player can have are that player's, a player who
+// can have just as many cards as the hand holds has all of them, and a
+// player with that many sure cards has no others. The fitted matrix only
+// gets there in the limit, so this settles them first.
+void Beliefs::propagate()
+{
+    for (bool changed = true; changed;) {
+        changed = false;
+        CardMask allowed[numPlayers];
+        for (int p = 0; p < numPlayers; ++p) {
+            allowed[p] = 0;
+            for (CardMask rest = m_hidden; rest; rest &= rest - 1) {
+                if (m_matrix[p][lowestCard(rest)] > 0)
+                    allowed[p] |= lowestBit(rest);
+            }
+        }
+
+        for (int p = 0; p < numPlayers; ++p) {
+            if (p == m_player)
+                continue;
+            CardMask sure = allowed[p];
+            if (popCount(sure) != m_handSizes[p]) {
+                // the cards nobody else can have
+                for (int other = 0; other < numPlayers; ++other) {
+                    if (other != p)
+                        sure &= ~allowed[other];
+                }
+            }
+            for (int other = 0; other < numPlayers; ++other) {
+                if (other != p && (allowed[other] & sure)) {
+                    exclude(other, sure);
+                    changed = true;
+                }
+            }
+            // a full hand has room for nothing else
+            if (popCount(sure) == m_handSizes[p] && (allowed[p] & ~sure)) {
+                exclude(p, allowed[p] & ~sure);
+                changed = true;
+            }
+        }
+    }
+}
+
+int Beliefs::update()
+{
+    propagate();
+
+    float sizes[numPlayers];
+    for (int p = 0; p < numPlayers; ++p)
+        sizes[p] = p == m_player ? 0.0f : float(m_handSizes[p]);
+
+    int iterations = 0;
+    float error = tolerance;
+    while (error >= tolerance && iterations < maxIterations) {
+#ifdef SCHAFKOPF_AVX2
+        if (m_useAvx2)
+            error = iterateAvx2(m_matrix, sizes);
+        else
+#endif
+            error = iterateScalar(m_matrix, sizes);
+        ++iterations;
+    }
+    return iterations;
+}
+
+float Beliefs::expected(int who, CardMask cards) const
+{
+    float result = 0;
+    for (CardMask rest = cards & m_hidden; rest; rest &= rest - 1)
+        result += m_matrix[who][lowestCard(rest)];
+    return result;
+}
+
+}
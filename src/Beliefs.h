@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CardMask.h"
+
+namespace SchafKopf
+{
+
+// How likely each card the player cannot see sits with each of the
+// others, without drawing deals.
+//
+// The matrix has a row of 32 probabilities per player, the player's own
+// row stays empty. Every hidden card is with exactly one of the others,
+// so its column adds up to 1, every row adds up to the number of cards
+// that player holds, and cards a player cannot have are 0. update()
+// finds such a matrix by iterative proportional fitting (Sinkhorn):
+// scale the rows to the hand sizes, then the columns to 1, until the rows
+// are off by less than tolerance. Of all matrices that meet the sums it
+// is the one closest to the starting matrix, which is what the uniform
+// deal gives when nothing else is known, though not exactly the marginals
+// of uniformly drawn deals once there are voids.
+//
+// Played cards and new exclusions only zero entries of the matrix. The
+// scaled matrix differs from the start by row and column factors, and so
+// does the result, so update() continues from the last one and needs a
+// few iterations only.
+class Beliefs
+{
+public:
+    Beliefs();
+
+    // Starts over: hidden are the cards nobody but their holder has seen,
+    // handSizes how many cards each player holds.
+    void reset(int player, CardMask hidden, const int handSizes[numPlayers]);
+
+    // who played card, which was hidden unless who is the player
+    void cardPlayed(int who, int card);
+
+    // cards who cannot have
+    void exclude(int who, CardMask cards);
+
+    // scales the matrix until it meets the sums again, returns the
+    // number of iterations
+    int update();
+
+    float probability(int who, int card) const { return m_matrix[who][card]; }
+    const float *row(int who) const { return m_matrix[who]; }
+
+    // the expected number of cards out of cards that who holds
+    float expected(int who, CardMask cards) const;
+
+    int player() const { return m_player; }
+    CardMask hidden() const { return m_hidden; }
+    int handSize(int who) const { return m_handSizes[who]; }
+
+    static constexpr float tolerance = 1e-3f;
+    static constexpr int maxIterations = 100;
+
+    // the AVX2 kernel is used where the CPU has it, this can turn it off
+    void setUseAvx2(bool use);
+
+private:
+    void propagate();
+
+    float m_matrix[numPlayers][numCards];
+    int m_player;
+    CardMask m_hidden;
+    int m_handSizes[numPlayers];
+    bool m_useAvx2;
+};
+
+}
@@ -0,0 +1,108 @@
+#include "Bidding.h"
+#include "ExpertPolicy.h"
+
+namespace SchafKopf
+{
+
+ContractEvaluator::ContractEvaluator(int numSamples, unsigned seed)
+    : m_numSamples(numSamples),
+      m_engine(seed),
+      m_expertRollouts(false)
+{
+}
+
+int ContractEvaluator::evaluate(CardMask hand, int seat, int leader, const Contract* contracts, int numCandidates,
+                                ContractValue* values)
+{
+    assert(popCount(hand) == Player::maxCards);
+    assert(numCandidates <= numContracts);
+
+    const Rules* rules[numContracts];
+    int count = 0;
+    for (int i = 0; i < numCandidates; ++i) {
+        const Contract& contract = contracts[i];
+        if (!contract.isValid(hand))
+            continue;
+        values[count] = ContractValue{ contract, 0.0, 0.0 };
+        rules[count] = &m_scoring.rules(contract.type, contract.color);
+        ++count;
+    }
+
+    uint8_t others[numCards - Player::maxCards];
+    int numOthers = 0;
+    for (int i = 0; i < numCards; ++i) {
+        if (!(hand & cardBit(i)))
+            others[numOthers++] = uint8_t(i);
+    }
+
+    FinishedGame finished;
+    finished.declarer = seat;
+
+    for (int sample = 0; sample < m_numSamples; ++sample) {
+        std::shuffle(others, others + numOthers, m_engine);
+
+        for (int i = 0; i < numPlayers; ++i) {
+            const int player = (seat + i) % numPlayers;
+            if (i == 0) {
+                finished.hands[player] = hand;
+                continue;
+            }
+            finished.hands[player] = 0;
+            for (int j = 0; j < Player::maxCards; ++j)
+                finished.hands[player] |= cardBit(others[(i - 1) * Player::maxCards + j]);
+        }
+
+        Deal deal;
+        std::copy(finished.hands, finished.hands + numPlayers, deal.hands);
+
+        // same random decisions for every contract
+        const unsigned rolloutSeed = unsigned(m_engine());
+
+        for (int c = 0; c < count; ++c) {
+            std::minstd_rand rollout(rolloutSeed);
+            Position position(*rules[c], deal, seat, leader);
+            if (m_expertRollouts) {
+                const ExpertPolicy& policy = ExpertPolicy::get(values[c].contract.type, values[c].contract.color);
+                while (!position.finished())
+                    position.play(policy.move(position));
+            }
+            while (!position.finished()) {
+                const CardMask legal = position.legalMoves();
+                position.play(nthCard(legal, int(rollout() % unsigned(popCount(legal)))));
+            }
+
+            finished.gameType = values[c].contract.type;
+            finished.gameColor = values[c].contract.color;
+            std::copy(position.won, position.won + numPlayers, finished.won);
+
+            const Settlement settlement = m_scoring.settle(finished);
+            values[c].value += settlement.money[seat];
+            values[c].winProbability += settlement.won;
+        }
+    }
+
+    for (int c = 0; c < count; ++c) {
+        values[c].value /= m_numSamples;
+        values[c].winProbability /= m_numSamples;
+    }
+
+    return count;
+}
+
+std::optional<Contract> EvaluatorBiddingAi::bid(const Auction& auction, CardMask hand)
+{
+    ContractValue values[numContracts];
+    const int count = m_evaluator.evaluate(hand, auction.activeSeat(), auction.firstSeat(), values);
+
+    std::optional<Contract> result;
+    double best = m_minValue;
+    for (int i = 0; i < count; ++i) {
+        if (values[i].value > best && auction.canBid(values[i].contract, hand)) {
+            best = values[i].value;
+            result = values[i].contract;
+        }
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "Position.h"
+#include "Scoring.h"
+
+#include <random>
+
+namespace SchafKopf
+{
+
+// a game type together with its color - the color has no meaning for
+// Wenz and Geier and is always Schelln there
+struct Contract
+{
+    Game::Type type;
+    Color color;
+
+    bool operator==(const Contract& other) const { return type == other.type && color == other.color; }
+    bool operator!=(const Contract& other) const { return !(*this == other); }
+
+    // a Sauspiel is beaten by Wenz and Geier, which are beaten by all solos
+    static int priority(Game::Type type)
+    {
+        switch (type) {
+        case Game::SauSpiel:
+            return 0;
+        case Game::Wenz:
+        case Game::Geier:
+            return 1;
+        case Game::FarbWenz:
+        case Game::FarbGeier:
+        case Game::Solo:
+            return 2;
+        }
+        assert(false);
+        return 0;
+    }
+
+    int priority() const { return priority(type); }
+
+    // true if the contract may be announced with that hand
+    bool isValid(CardMask hand) const
+    {
+        if (type != Game::SauSpiel)
+            return true;
+
+        // one cannot call the Herz Sau or a Sau of one's own, and one
+        // needs a card of the called color
+        const CardMask callable = colorMask(color) & ~typeMask(Ober) & ~typeMask(Unter);
+        return color != Herz
+                && !(hand & cardBit(Card{ Ass, color }))
+                && (hand & callable);
+    }
+};
+
+constexpr int numContracts = 17;
+
+static const Contract allContracts[numContracts] = {
+    { Game::SauSpiel, Schelln },
+    { Game::SauSpiel, Gras },
+    { Game::SauSpiel, Eichel },
+    { Game::Wenz, Schelln },
+    { Game::Geier, Schelln },
+    { Game::FarbWenz, Schelln },
+    { Game::FarbWenz, Herz },
+    { Game::FarbWenz, Gras },
+    { Game::FarbWenz, Eichel },
+    { Game::FarbGeier, Schelln },
+    { Game::FarbGeier, Herz },
+    { Game::FarbGeier, Gras },
+    { Game::FarbGeier, Eichel },
+    { Game::Solo, Schelln },
+    { Game::Solo, Herz },
+    { Game::Solo, Gras },
+    { Game::Solo, Eichel }
+};
+
+// Every player, starting with firstSeat, gets one chance to announce a game
+// or to pass ("weiter"). An announcement has to beat the current one, so for
+// games of the same priority, the earlier seat wins.
+class Auction
+{
+public:
+    explicit Auction(int firstSeat = 0)
+        : m_firstSeat(firstSeat),
+          m_numBids(0),
+          m_declarer(-1)
+    {}
+
+    int firstSeat() const { return m_firstSeat; }
+    int activeSeat() const { return (m_firstSeat + m_numBids) % numPlayers; }
+    bool finished() const { return m_numBids == numPlayers; }
+
+    bool hasContract() const { return bool(m_contract); }
+    const Contract& contract() const { return *m_contract; }
+    int declarer() const { return m_declarer; }
+
+    // true if the active seat may announce contract with that hand
+    bool canBid(const Contract& contract, CardMask hand) const
+    {
+        if (!contract.isValid(hand))
+            return false;
+        return !m_contract || contract.priority() > m_contract->priority();
+    }
+
+    // an empty contract passes
+    void bid(const std::optional<Contract>& contract)
+    {
+        assert(!finished());
+        if (contract) {
+            m_contract = contract;
+            m_declarer = activeSeat();
+        }
+        ++m_numBids;
+    }
+
+private:
+    int m_firstSeat;
+    int m_numBids;
+    std::optional<Contract> m_contract;
+    int m_declarer;
+};
+
+class BiddingAi
+{
+public:
+    BiddingAi() {}
+    virtual ~BiddingAi() {}
+
+    BiddingAi(const BiddingAi&) = delete;
+    BiddingAi& operator=(const BiddingAi&) = delete;
+
+    // the game to announce for the active seat of auction, or nothing to pass
+    virtual std::optional<Contract> bid(const Auction& auction, CardMask hand) = 0;
+};
+
+struct ContractValue
+{
+    Contract contract;
+    // average money won by the declarer
+    double value;
+    double winProbability;
+};
+
+// Estimates what every contract is worth for a hand by playing it out on
+// sampled deals. All contracts are played on the same deals with the same
+// random decisions, so differences between them are not sampling noise.
+class ContractEvaluator
+{
+public:
+    explicit ContractEvaluator(int numSamples = 48, unsigned seed = std::random_device()());
+
+    int numSamples() const { return m_numSamples; }
+    const Scoring& scoring() const { return m_scoring; }
+
+    // plays the samples out with ExpertPolicy instead of random legal cards
+    void setExpertRollouts(bool expert) { m_expertRollouts = expert; }
+
+    // evaluates all contracts that are valid for hand, returns how many
+    // were written to values (at most numContracts)
+    int evaluate(CardMask hand, int seat, int leader, ContractValue* values)
+    {
+        return evaluate(hand, seat, leader, allContracts, numContracts, values);
+    }
+
+    // same, but only for the count given contracts
+    int evaluate(CardMask hand, int seat, int leader, const Contract* contracts, int count, ContractValue* values);
+
+private:
+    int m_numSamples;
+    std::minstd_rand m_engine;
+    Scoring m_scoring;
+    bool m_expertRollouts;
+};
+
+// announces the contract with the best evaluation, if it is expected to win money
+class EvaluatorBiddingAi : public BiddingAi
+{
+public:
+    explicit EvaluatorBiddingAi(ContractEvaluator& evaluator, double minValue = 0.0)
+        : m_evaluator(evaluator),
+          m_minValue(minValue)
+    {}
+
+    std::optional<Contract> bid(const Auction& auction, CardMask hand) override;
+
+private:
+    ContractEvaluator& m_evaluator;
+    double m_minValue;
+};
+
+}
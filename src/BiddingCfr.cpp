@@ -0,0 +1,435 @@
+#include "BiddingCfr.h"
+#include "ExpertPolicy.h"
+#include "Ranking.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace SchafKopf
+{
+
+constexpr int CfrStrategy::numActions;
+constexpr int CfrStrategy::numBuckets;
+constexpr int CfrStrategy::numAuctionNodes;
+constexpr int CfrStrategy::numNodes;
+constexpr int CfrStrategy::reStage;
+constexpr int CfrStrategy::numInfoSets;
+constexpr uint32_t CfrStrategy::version;
+constexpr double CfrSolver::regretScale;
+constexpr double CfrSolver::strategyScale;
+
+static const Color calledColors[] = { Schelln, Gras, Eichel };
+
+// the color with the most trumps for a Solo, then with the most points in them
+static Color soloColor(CardMask hand, int& numTrumps)
+{
+    Color best = Schelln;
+    int bestPoints = -1;
+    numTrumps = -1;
+    for (int c = 0; c < numColors; ++c) {
+        const CardMask trumps = hand & Rules::get(Game::Solo, Color(c)).trumps();
+        const int count = popCount(trumps);
+        const int points = maskPoints(trumps);
+        if (count > numTrumps || (count == numTrumps && points > bestPoints)) {
+            best = Color(c);
+            numTrumps = count;
+            bestPoints = points;
+        }
+    }
+    return best;
+}
+
+int CfrStrategy::bucket(CardMask hand)
+{
+    int numTrumps;
+    soloColor(hand, numTrumps);
+    const int trumps = std::min(4, std::max(0, numTrumps - 3));
+    const int ober = std::min(3, popCount(hand & typeMask(Ober)));
+    const int unter = std::min(3, popCount(hand & typeMask(Unter)));
+    const int sau = std::min(3, popCount(hand & typeMask(Ass)));
+    bool callable = false;
+    for (Color color : calledColors)
+        callable |= Contract{ Game::SauSpiel, color }.isValid(hand);
+    return (((trumps * 4 + ober) * 4 + unter) * 4 + sau) * 2 + callable;
+}
+
+Contract CfrStrategy::contract(Kind kind, CardMask hand)
+{
+    switch (kind) {
+    case SauSpielKind: {
+        // the shortest color, so the Sau comes out early
+        Color best = Schelln;
+        int fewest = Player::maxCards + 1;
+        for (Color color : calledColors) {
+            const int count = popCount(hand & colorMask(color) & ~typeMask(Ober) & ~typeMask(Unter));
+            if (Contract{ Game::SauSpiel, color }.isValid(hand) && count < fewest) {
+                best = color;
+                fewest = count;
+            }
+        }
+        assert(fewest <= Player::maxCards);
+        return Contract{ Game::SauSpiel, best };
+    }
+    case WenzKind:
+        return Contract{ Game::Wenz, Schelln };
+    case SoloKind: {
+        int numTrumps;
+        return Contract{ Game::Solo, soloColor(hand, numTrumps) };
+    }
+    case NoGame:
+    case numKinds:
+        break;
+    }
+    assert(false);
+    return Contract{ Game::SauSpiel, Schelln };
+}
+
+// other games count as the kind of the same priority
+CfrStrategy::Kind CfrStrategy::kind(const Contract& contract)
+{
+    return Kind(contract.priority() + 1);
+}
+
+unsigned CfrStrategy::legalActions(int node, bool declarerTeam, int bucket)
+{
+    if (isAuction(node)) {
+        // kinds are ordered by priority
+        const int highest = (node / numPlayers) % numKinds;
+        unsigned result = 1u << NoGame;
+        for (int k = highest + 1; k < numKinds; ++k) {
+            if (k != SauSpielKind || (bucket & 1))
+                result |= 1u << k;
+        }
+        return result;
+    }
+    const int stage = (node - numAuctionNodes) % numPlayers;
+    return stage != reStage && declarerTeam ? 1u << NoDouble : (1u << NoDouble) | (1u << Doubled);
+}
+
+CfrStrategy::CfrStrategy()
+    : m_probabilities(size_t(numInfoSets * numActions))
+{
+    for (int node = 0; node < numNodes; ++node) {
+        for (int team = 0; team < 2; ++team) {
+            for (int b = 0; b < numBuckets; ++b) {
+                const unsigned legal = legalActions(node, team, b);
+                for (int a = 0; a < numActions; ++a)
+                    setProbability(infoSet(node, team, b), a, (legal >> a) & 1 ? 1.0 / popCount(legal) : 0.0);
+            }
+        }
+    }
+}
+
+int CfrStrategy::sample(int infoSet, unsigned legal, double random) const
+{
+    double total = 0;
+    for (int a = 0; a < numActions; ++a) {
+        if ((legal >> a) & 1)
+            total += probability(infoSet, a);
+    }
+    int last = -1;
+    for (int a = 0; a < numActions; ++a) {
+        if (!((legal >> a) & 1))
+            continue;
+        // without any weight on the legal actions, they are equally likely
+        const double p = total > 0 ? probability(infoSet, a) / total : 1.0 / popCount(legal);
+        if (random < p)
+            return a;
+        random -= p;
+        last = a;
+    }
+    return last;
+}
+
+bool CfrStrategy::load(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, "SKCF", 4) != 0 || header.version != version || header.numNodes != uint32_t(numNodes)
+            || header.numBuckets != uint32_t(numBuckets) || header.numActions != uint32_t(numActions))
+        return false;
+
+    std::vector<uint16_t> probabilities(m_probabilities.size());
+    if (!file.read(reinterpret_cast<char *>(probabilities.data()), std::streamsize(probabilities.size() * sizeof(uint16_t))))
+        return false;
+    m_probabilities.swap(probabilities);
+    return true;
+}
+
+bool CfrStrategy::write(const std::string& fileName) const
+{
+    Header header;
+    std::memcpy(header.magic, "SKCF", 4);
+    header.version = version;
+    header.numNodes = numNodes;
+    header.numBuckets = numBuckets;
+    header.numActions = numActions;
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(m_probabilities.data()), std::streamsize(m_probabilities.size() * sizeof(uint16_t)));
+    return bool(file);
+}
+
+// One deal: the hands, their buckets and the outcomes of the games played
+// on it so far, money per player for every declarer and kind.
+struct CfrSolver::Iteration
+{
+    Deal deal;
+    int buckets[numPlayers];
+    std::minstd_rand engine;
+
+    bool played[numPlayers][CfrStrategy::numKinds];
+    int money[numPlayers][CfrStrategy::numKinds][numPlayers];
+    uint8_t teams[numPlayers][CfrStrategy::numKinds];
+};
+
+CfrSolver::CfrSolver(const Tariff& tariff)
+    : m_scoring(tariff),
+      m_regrets(new std::atomic<int64_t>[size_t(CfrStrategy::numInfoSets * CfrStrategy::numActions)]),
+      m_strategySums(new std::atomic<int64_t>[size_t(CfrStrategy::numInfoSets * CfrStrategy::numActions)]),
+      m_iterations(0)
+{
+    for (size_t i = 0; i < size_t(CfrStrategy::numInfoSets * CfrStrategy::numActions); ++i) {
+        m_regrets[i].store(0, std::memory_order_relaxed);
+        m_strategySums[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void CfrSolver::currentStrategy(int infoSet, unsigned legal, double *probabilities) const
+{
+    double total = 0;
+    for (int a = 0; a < CfrStrategy::numActions; ++a) {
+        const int64_t regret = m_regrets[size_t(infoSet * CfrStrategy::numActions + a)].load(std::memory_order_relaxed);
+        probabilities[a] = (legal >> a) & 1 ? double(std::max(int64_t(0), regret)) : 0.0;
+        total += probabilities[a];
+    }
+    for (int a = 0; a < CfrStrategy::numActions; ++a) {
+        if (total > 0)
+            probabilities[a] /= total;
+        else
+            probabilities[a] = (legal >> a) & 1 ? 1.0 / popCount(legal) : 0.0;
+    }
+}
+
+double CfrSolver::walk(Iteration& iteration, int node, int traverser) const
+{
+    using Kind = CfrStrategy::Kind;
+
+    int player;
+    int highest;
+    int declarer;
+    int stage = 0;
+    if (CfrStrategy::isAuction(node)) {
+        declarer = node % numPlayers;
+        highest = (node / numPlayers) % CfrStrategy::numKinds;
+        player = node / (numPlayers * CfrStrategy::numKinds);
+    } else {
+        const int rest = node - CfrStrategy::numAuctionNodes;
+        stage = rest % numPlayers;
+        declarer = (rest / numPlayers) % numPlayers;
+        highest = rest / (numPlayers * numPlayers) + 1;
+        player = stage == CfrStrategy::reStage ? declarer : (declarer + 1 + stage) & (numPlayers - 1);
+    }
+
+    // the game is played once per declarer and kind on this deal
+    auto payoff = [&](int doublings) -> double {
+        if (!iteration.played[declarer][highest]) {
+            const Contract contract = CfrStrategy::contract(Kind(highest), iteration.deal.hands[declarer]);
+            const ExpertPolicy& policy = ExpertPolicy::get(contract.type, contract.color);
+            Position position(policy.rules(), iteration.deal, declarer, 0);
+            while (!position.finished())
+                position.play(policy.move(position));
+
+            FinishedGame finished;
+            finished.gameType = contract.type;
+            finished.gameColor = contract.color;
+            finished.declarer = declarer;
+            std::copy(iteration.deal.hands, iteration.deal.hands + numPlayers, finished.hands);
+            std::copy(position.won, position.won + numPlayers, finished.won);
+            const Settlement settlement = m_scoring.settle(finished);
+            std::copy(settlement.money, settlement.money + numPlayers, iteration.money[declarer][highest]);
+            iteration.teams[declarer][highest] = position.declarerTeam;
+            iteration.played[declarer][highest] = true;
+        }
+        return double(iteration.money[declarer][highest][traverser] * (1 << doublings));
+    };
+
+    // the node or the value that follows action
+    auto next = [&](int action) -> double {
+        if (CfrStrategy::isAuction(node)) {
+            const int numBids = player + 1;
+            if (action != CfrStrategy::NoGame) {
+                highest = action;
+                declarer = player;
+            }
+            if (numBids < numPlayers)
+                return walk(iteration, CfrStrategy::auctionNode(numBids, Kind(highest), declarer), traverser);
+            if (highest == CfrStrategy::NoGame)
+                return 0.0;
+            return walk(iteration, CfrStrategy::doubleNode(Kind(highest), declarer, 0), traverser);
+        }
+        if (stage == CfrStrategy::reStage)
+            return payoff(1 + action);
+        if (action == CfrStrategy::Doubled)
+            return walk(iteration, CfrStrategy::doubleNode(Kind(highest), declarer, CfrStrategy::reStage), traverser);
+        if (stage + 1 < CfrStrategy::reStage)
+            return walk(iteration, CfrStrategy::doubleNode(Kind(highest), declarer, stage + 1), traverser);
+        return payoff(0);
+    };
+
+    bool declarerTeam = false;
+    if (!CfrStrategy::isAuction(node)) {
+        payoff(0);
+        declarerTeam = (iteration.teams[declarer][highest] >> player) & 1;
+    }
+    const int bucket = iteration.buckets[player];
+    const unsigned legal = CfrStrategy::legalActions(node, declarerTeam, bucket);
+    const int savedHighest = highest;
+    const int savedDeclarer = declarer;
+    if (!(legal & (legal - 1)))
+        return next(__builtin_ctz(legal));
+
+    const int infoSet = CfrStrategy::infoSet(node, declarerTeam, bucket);
+    double strategy[CfrStrategy::numActions];
+    currentStrategy(infoSet, legal, strategy);
+    std::atomic<int64_t> *regrets = &m_regrets[size_t(infoSet * CfrStrategy::numActions)];
+    std::atomic<int64_t> *sums = &m_strategySums[size_t(infoSet * CfrStrategy::numActions)];
+
+    if (player != traverser) {
+        double random = std::uniform_real_distribution<double>(0.0, 1.0)(iteration.engine);
+        int action = -1;
+        for (int a = 0; a < CfrStrategy::numActions; ++a) {
+            if (!((legal >> a) & 1))
+                continue;
+            sums[a].fetch_add(int64_t(strategy[a] * strategyScale + 0.5), std::memory_order_relaxed);
+            if (action < 0 && (random < strategy[a] || a == 31 - __builtin_clz(legal)))
+                action = a;
+            random -= strategy[a];
+        }
+        return next(action);
+    }
+
+    double values[CfrStrategy::numActions];
+    double value = 0;
+    for (int a = 0; a < CfrStrategy::numActions; ++a) {
+        if (!((legal >> a) & 1))
+            continue;
+        highest = savedHighest;
+        declarer = savedDeclarer;
+        values[a] = next(a);
+        value += strategy[a] * values[a];
+    }
+    for (int a = 0; a < CfrStrategy::numActions; ++a) {
+        if ((legal >> a) & 1)
+            regrets[a].fetch_add(std::llround((values[a] - value) * regretScale), std::memory_order_relaxed);
+    }
+    return value;
+}
+
+void CfrSolver::run(uint64_t numIterations, int numThreads, uint32_t seed)
+{
+    std::atomic<uint64_t> next(0);
+    auto worker = [&](int thread) {
+        Iteration iteration;
+        iteration.engine.seed(seed * 1000003u + unsigned(thread) + 1);
+        while (next++ < numIterations) {
+            iteration.deal = randomDeal(iteration.engine);
+            for (int p = 0; p < numPlayers; ++p)
+                iteration.buckets[p] = CfrStrategy::bucket(iteration.deal.hands[p]);
+            std::memset(iteration.played, 0, sizeof(iteration.played));
+            for (int traverser = 0; traverser < numPlayers; ++traverser)
+                walk(iteration, CfrStrategy::auctionNode(0, CfrStrategy::NoGame, 0), traverser);
+            ++m_iterations;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+CfrStrategy CfrSolver::strategy() const
+{
+    CfrStrategy result;
+    for (int node = 0; node < CfrStrategy::numNodes; ++node) {
+        for (int team = 0; team < 2; ++team) {
+            for (int b = 0; b < CfrStrategy::numBuckets; ++b) {
+                const int infoSet = CfrStrategy::infoSet(node, team, b);
+                const unsigned legal = CfrStrategy::legalActions(node, team, b);
+                double total = 0;
+                for (int a = 0; a < CfrStrategy::numActions; ++a) {
+                    if ((legal >> a) & 1)
+                        total += double(m_strategySums[size_t(infoSet * CfrStrategy::numActions + a)].load(std::memory_order_relaxed));
+                }
+                // information sets that were never reached keep the uniform strategy
+                if (total <= 0)
+                    continue;
+                for (int a = 0; a < CfrStrategy::numActions; ++a) {
+                    const double sum = double(m_strategySums[size_t(infoSet * CfrStrategy::numActions + a)].load(std::memory_order_relaxed));
+                    result.setProbability(infoSet, a, (legal >> a) & 1 ? sum / total : 0.0);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int CfrBiddingAi::sample(int node, bool declarerTeam, CardMask hand, unsigned allowed)
+{
+    const int bucket = CfrStrategy::bucket(hand);
+    const unsigned legal = CfrStrategy::legalActions(node, declarerTeam, bucket) & allowed;
+    if (!legal)
+        return 0;
+    const double random = std::uniform_real_distribution<double>(0.0, 1.0)(m_engine);
+    return m_strategy.sample(CfrStrategy::infoSet(node, declarerTeam, bucket), legal, random);
+}
+
+std::optional<Contract> CfrBiddingAi::bid(const Auction& auction, CardMask hand)
+{
+    const int first = auction.firstSeat();
+    const int numBids = (auction.activeSeat() - first) & (numPlayers - 1);
+    const CfrStrategy::Kind highest = auction.hasContract() ? CfrStrategy::kind(auction.contract()) : CfrStrategy::NoGame;
+    const int declarer = auction.hasContract() ? (auction.declarer() - first) & (numPlayers - 1) : 0;
+
+    unsigned allowed = 1u << CfrStrategy::NoGame;
+    for (int k = highest + 1; k < CfrStrategy::numKinds; ++k) {
+        if (k == CfrStrategy::SauSpielKind && !(CfrStrategy::bucket(hand) & 1))
+            continue;
+        if (auction.canBid(CfrStrategy::contract(CfrStrategy::Kind(k), hand), hand))
+            allowed |= 1u << k;
+    }
+
+    const int action = sample(CfrStrategy::auctionNode(numBids, highest, declarer), false, hand, allowed);
+    if (action == CfrStrategy::NoGame)
+        return std::optional<Contract>();
+    return CfrStrategy::contract(CfrStrategy::Kind(action), hand);
+}
+
+bool CfrBiddingAi::kontra(const Auction& auction, int seat, CardMask hand, bool declarerTeam)
+{
+    assert(auction.finished() && auction.hasContract() && seat != auction.declarer());
+    if (declarerTeam)
+        return false;
+    const int declarer = (auction.declarer() - auction.firstSeat()) & (numPlayers - 1);
+    const int stage = (seat - auction.declarer() - 1) & (numPlayers - 1);
+    const int node = CfrStrategy::doubleNode(CfrStrategy::kind(auction.contract()), declarer, stage);
+    return sample(node, false, hand, 3) == CfrStrategy::Doubled;
+}
+
+bool CfrBiddingAi::re(const Auction& auction, CardMask hand)
+{
+    assert(auction.finished() && auction.hasContract());
+    const int declarer = (auction.declarer() - auction.firstSeat()) & (numPlayers - 1);
+    const int node = CfrStrategy::doubleNode(CfrStrategy::kind(auction.contract()), declarer, CfrStrategy::reStage);
+    return sample(node, true, hand, 3) == CfrStrategy::Doubled;
+}
+
+}
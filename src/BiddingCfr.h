@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Bidding.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// Bidding and doubling as a small game of imperfect information, solved
+// with Monte Carlo counterfactual regret minimization (external sampling).
+//
+// The game is an abstraction of the real one. Every seat, from the first
+// one on, passes or announces one of three kinds of games that must beat
+// the current one: a Sauspiel, a Wenz or a Solo. The colors are not part
+// of it, a Sauspiel calls the callable color with the fewest cards and a
+// Solo takes the color with the most trumps. After a game was announced,
+// the seats after the declarer may say Kontra, and after a Kontra the
+// declarer may say Re. Each doubles the money. Partners in a Sauspiel
+// know that they are, and never say Kontra.
+//
+// A player knows the hand only as its bucket, see bucket(), and the
+// auction only as the number of bids, the highest kind of game so far and
+// who announced it. So the information sets are (node, team, bucket),
+// where the team is only known for doubling.
+//
+// Outcomes come from playing the deal out with ExpertPolicy and settling
+// the game with a Scoring. A deal where everybody passes is worth nothing.
+class CfrStrategy
+{
+public:
+    enum Kind
+    {
+        NoGame,
+        SauSpielKind,
+        WenzKind,
+        SoloKind,
+        numKinds
+    };
+
+    // actions of the auction are kinds, NoGame passes; doubling has two
+    enum Double
+    {
+        NoDouble,
+        Doubled
+    };
+
+    static constexpr int numActions = numKinds;
+
+    // 5 trump counts of the best Solo, 4 counts of Ober, Unter and Sau
+    // each, and whether a Sauspiel can be called
+    static constexpr int numBuckets = 5 * 4 * 4 * 4 * 2;
+
+    // the auction: number of bids, highest kind, offset of its declarer
+    // from the first seat; then per kind and offset of the declarer, the
+    // three seats after the declarer and the Re of the declarer
+    static constexpr int numAuctionNodes = numPlayers * numKinds * numPlayers;
+    static constexpr int numNodes = numAuctionNodes + (numKinds - 1) * numPlayers * numPlayers;
+    static constexpr int reStage = numPlayers - 1;
+
+    static constexpr int numInfoSets = numNodes * 2 * numBuckets;
+
+    static int bucket(CardMask hand);
+
+    // the contract a kind of game means for hand, see above
+    static Contract contract(Kind kind, CardMask hand);
+    static Kind kind(const Contract& contract);
+
+    static int auctionNode(int numBids, Kind highest, int declarer)
+    {
+        return (numBids * numKinds + highest) * numPlayers + declarer;
+    }
+
+    // stage 0 to 2 are the seats after the declarer, reStage the declarer
+    static int doubleNode(Kind kind, int declarer, int stage)
+    {
+        return numAuctionNodes + ((kind - 1) * numPlayers + declarer) * numPlayers + stage;
+    }
+
+    static bool isAuction(int node) { return node < numAuctionNodes; }
+
+    static int infoSet(int node, bool declarerTeam, int bucket)
+    {
+        return (node * 2 + declarerTeam) * numBuckets + bucket;
+    }
+
+    // bit a is set if action a is allowed in node, for a player of the
+    // team with a hand in bucket
+    static unsigned legalActions(int node, bool declarerTeam, int bucket);
+
+    // every legal action equally likely until load() succeeds or the
+    // probabilities are set
+    CfrStrategy();
+
+    bool load(const std::string& fileName);
+    bool write(const std::string& fileName) const;
+
+    // the probability of action a in infoSet
+    double probability(int infoSet, int action) const
+    {
+        return m_probabilities[size_t(infoSet * numActions + action)] / 65535.0;
+    }
+    void setProbability(int infoSet, int action, double probability)
+    {
+        m_probabilities[size_t(infoSet * numActions + action)] = uint16_t(probability * 65535.0 + 0.5);
+    }
+
+    // an action of infoSet, by a uniform random number in [0, 1)
+    int sample(int infoSet, unsigned legal, double random) const;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numNodes;
+        uint32_t numBuckets;
+        uint32_t numActions;
+    };
+
+    static constexpr uint32_t version = 1;
+
+private:
+    std::vector<uint16_t> m_probabilities;
+};
+
+// Runs the iterations of the solver on any number of threads. The regrets
+// and the strategy sums are fixed point integers, updated with relaxed
+// atomic adds, so threads share the tables without locks. Updates of
+// different threads to the same information set interleave, which only
+// changes the order of the sums.
+class CfrSolver
+{
+public:
+    explicit CfrSolver(const Tariff& tariff = Tariff());
+
+    // numIterations more deals, each with every seat as traverser once
+    void run(uint64_t numIterations, int numThreads, uint32_t seed);
+
+    uint64_t numIterations() const { return m_iterations; }
+
+    // the average strategy so far
+    CfrStrategy strategy() const;
+
+    // the strategy regret matching plays next, for infoSet with legal actions
+    void currentStrategy(int infoSet, unsigned legal, double *probabilities) const;
+
+private:
+    struct Iteration;
+
+    double walk(Iteration& iteration, int node, int traverser) const;
+
+    // fixed point scales of regrets (money) and strategy sums (probabilities)
+    static constexpr double regretScale = 256.0;
+    static constexpr double strategyScale = 65536.0;
+
+    Scoring m_scoring;
+    std::unique_ptr<std::atomic<int64_t>[]> m_regrets;
+    std::unique_ptr<std::atomic<int64_t>[]> m_strategySums;
+    std::atomic<uint64_t> m_iterations;
+};
+
+// Bids and doubles by looking the hand up in a CfrStrategy.
+class CfrBiddingAi : public BiddingAi
+{
+public:
+    explicit CfrBiddingAi(const CfrStrategy& strategy, unsigned seed = 1)
+        : m_strategy(strategy),
+          m_engine(seed)
+    {}
+
+    std::optional<Contract> bid(const Auction& auction, CardMask hand) override;
+
+    // Whether seat says Kontra to the contract of the finished auction,
+    // if nobody before did. declarerTeam is true for the partner in a
+    // Sauspiel, who never does.
+    bool kontra(const Auction& auction, int seat, CardMask hand, bool declarerTeam);
+
+    // whether the declarer says Re after a Kontra
+    bool re(const Auction& auction, CardMask hand);
+
+private:
+    int sample(int node, bool declarerTeam, CardMask hand, unsigned allowed);
+
+    const CfrStrategy& m_strategy;
+    std::minstd_rand m_engine;
+};
+
+}
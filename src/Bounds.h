@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Position.h"
+
+#include <algorithm>
+
+namespace SchafKopf
+{
+
+// the fewest points any n cards of hand are worth, card types are ordered by points
+inline int lowestPoints(CardMask hand, int n)
+{
+    static const int typePoints[numCardTypes] = { 0, 0, 0, 2, 3, 4, 10, 11 };
+    int points = 0;
+    for (int type = 0; n > 0 && type < numCardTypes; ++type) {
+        const int count = std::min(n, typeCount(hand, CardType(type)));
+        points += count * typePoints[type];
+        n -= count;
+    }
+    return points;
+}
+
+// What a team takes for sure from a position on, without searching.
+// Stiche and points are separate bounds, they may come from different
+// lines of play.
+//
+// A master trump, a trump higher than all trumps of the other team, wins
+// every stich it is played into for its team, and all cards get played
+// eventually. So the team takes at least the points of its master trumps,
+// and at least as many stiche as one of its players holds master trumps,
+// since one player's cards all go into different stiche. Trumps the other
+// team already put into the current stich count against the masters.
+//
+// If the team leads, it can also cash the leader's masters of one suit:
+// they win as long as nobody of the other team can trump in, which holds
+// while every opponent with trumps can still follow suit. Each of those
+// stiche brings in at least the cheapest cards everybody else can add.
+struct SureTricks
+{
+    int stiche;
+    int points;
+};
+
+inline SureTricks sureTricks(const Position& position, int team)
+{
+    const Rules& rules = *position.rules;
+
+    CardMask own = 0;
+    CardMask other = 0;
+    for (int p = 0; p < numPlayers; ++p)
+        ((team >> p) & 1 ? own : other) |= position.hands[p];
+    for (int i = 0; i < position.numInTrick; ++i) {
+        if (!((team >> ((position.leader + i) & (numPlayers - 1))) & 1))
+            other |= cardBit(position.trick[i]);
+    }
+
+    // the rank of the highest trump of the other team, or all trumps
+    const uint32_t otherRanks = rules.trumpRanks(other & rules.trumps());
+    const CardMask masters = own & rules.topTrumps(__builtin_ctz(otherRanks | (1u << rules.numTrumps())));
+
+    SureTricks result{ 0, maskPoints(masters) };
+    for (int p = 0; p < numPlayers; ++p) {
+        if ((team >> p) & 1)
+            result.stiche = std::max(result.stiche, popCount(position.hands[p] & masters));
+    }
+
+    const int leader = position.leader;
+    if (position.numInTrick || !((team >> leader) & 1))
+        return result;
+
+    const CardMask hand = position.hands[leader];
+    const CardMask otherTrumps = other & rules.trumps();
+    const uint8_t *order = rules.suitOrder();
+    for (int suit = 0; suit < Rules::numSuits; ++suit) {
+        const CardMask suitMask = rules.suitMask(suit);
+        if (!(hand & suitMask))
+            continue;
+
+        // the leader's cards above all cards of the other team, strongest first
+        CardMask cashed = 0;
+        int count = 0;
+        int limit = Player::maxCards;
+        if (suit != Rules::trumpSuit) {
+            for (int p = 0; p < numPlayers; ++p) {
+                if (!((team >> p) & 1) && (position.hands[p] & otherTrumps))
+                    limit = std::min(limit, popCount(position.hands[p] & suitMask));
+            }
+        }
+        for (int i = rules.suitStart(suit); i < rules.suitStart(suit + 1) && count < limit; ++i) {
+            const CardMask card = cardBit(order[i]);
+            if (other & card)
+                break;
+            if (hand & card) {
+                cashed |= card;
+                ++count;
+            }
+        }
+        if (!count)
+            continue;
+
+        int points = maskPoints(cashed);
+        for (int p = 0; p < numPlayers; ++p) {
+            if (p == leader)
+                continue;
+            const CardMask follow = position.hands[p] & suitMask;
+            const bool follows = !((team >> p) & 1) && popCount(follow) >= count;
+            points += lowestPoints(follows ? follow : position.hands[p], count);
+        }
+        result.stiche = std::max(result.stiche, count);
+        result.points = std::max(result.points, points);
+    }
+    return result;
+}
+
+// bounds on what the declarer team takes from now on
+struct Bounds
+{
+    int lower;
+    int upper;
+};
+
+// in card points, the defenders take at most what the declarer team does
+// not take for sure and the other way round
+inline Bounds pointBounds(const Position& position)
+{
+    const int remaining = maskPoints(allCards & ~position.played);
+    const SureTricks declarer = sureTricks(position, position.declarerTeam);
+    const SureTricks defenders = sureTricks(position, ~position.declarerTeam & 0xf);
+    return Bounds{ declarer.points, remaining - defenders.points };
+}
+
+// in stiche, counting the current one
+inline Bounds sticheBounds(const Position& position)
+{
+    const int remaining = Player::maxCards - position.numStiche();
+    const SureTricks declarer = sureTricks(position, position.declarerTeam);
+    const SureTricks defenders = sureTricks(position, ~position.declarerTeam & 0xf);
+    return Bounds{ declarer.stiche, remaining - defenders.stiche };
+}
+
+}
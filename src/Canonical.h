@@ -0,0 +1,268 @@
+#pragma once
+
+#include "Position.h"
+
+namespace SchafKopf
+{
+
+// A relabeling of the four colors. The cards in a fixed mask keep their
+// color, see Symmetry.
+struct ColorPermutation
+{
+    // map[c] is the color that c becomes
+    uint8_t map[numColors];
+
+    static constexpr int numPermutations = 24;
+
+    static ColorPermutation identity()
+    {
+        return ColorPermutation{ { 0, 1, 2, 3 } };
+    }
+
+    Color apply(Color color) const
+    {
+        return Color(map[color]);
+    }
+
+    int apply(int card, CardMask fixed = 0) const
+    {
+        if (fixed & cardBit(card))
+            return card;
+        return map[card / numCardTypes] * numCardTypes + card % numCardTypes;
+    }
+
+    // moves the byte of every color to the byte of its new color
+    CardMask apply(CardMask mask, CardMask fixed = 0) const
+    {
+        const CardMask moving = mask & ~fixed;
+        return (mask & fixed)
+                | (moving & 0xff) << (map[0] * numCardTypes)
+                | ((moving >> 8) & 0xff) << (map[1] * numCardTypes)
+                | ((moving >> 16) & 0xff) << (map[2] * numCardTypes)
+                | (moving >> 24) << (map[3] * numCardTypes);
+    }
+
+    ColorPermutation inverse() const
+    {
+        ColorPermutation result;
+        for (int c = 0; c < numColors; ++c)
+            result.map[map[c]] = uint8_t(c);
+        return result;
+    }
+
+    bool operator==(const ColorPermutation& other) const
+    {
+        return std::equal(map, map + numColors, other.map);
+    }
+
+    // a dense index in [0, numPermutations), see fromIndex
+    int index() const
+    {
+        // Lehmer code of map
+        int result = 0;
+        for (int i = 0; i < numColors; ++i) {
+            int smaller = 0;
+            for (int j = i + 1; j < numColors; ++j)
+                smaller += map[j] < map[i];
+            result = result * (numColors - i) + smaller;
+        }
+        return result;
+    }
+
+    static const ColorPermutation& fromIndex(int index);
+};
+
+// The colors that can be relabeled without changing the game: all of them
+// in Wenz and Geier, all but the trump color in the other solos and all
+// but Herz and the color of the called Sau in a Sauspiel.
+//
+// The Ober and Unter that are trumps rank by their color, so they have to
+// stay where they are - the symmetric colors are the remaining cards of
+// each color.
+struct Symmetry
+{
+    // a bit per color
+    int colors;
+    // the cards that keep their color
+    CardMask fixed;
+
+    static CardMask fixedCards(Game::Type type)
+    {
+        switch (type) {
+        case Game::Wenz:
+        case Game::FarbWenz:
+            return typeMask(Unter);
+        case Game::Geier:
+        case Game::FarbGeier:
+            return typeMask(Ober);
+        case Game::Solo:
+        case Game::SauSpiel:
+            return typeMask(Ober) | typeMask(Unter);
+        }
+        assert(false);
+        return 0;
+    }
+
+    static Symmetry of(Game::Type type, Color color)
+    {
+        switch (type) {
+        case Game::Wenz:
+        case Game::Geier:
+            return Symmetry{ 0xf, fixedCards(type) };
+        case Game::FarbWenz:
+        case Game::FarbGeier:
+        case Game::Solo:
+            return Symmetry{ 0xf & ~(1 << color), fixedCards(type) };
+        case Game::SauSpiel:
+            return Symmetry{ 0xf & ~(1 << Herz) & ~(1 << color), fixedCards(type) };
+        }
+        assert(false);
+        return Symmetry{ 0, 0 };
+    }
+
+    static Symmetry of(const Rules& rules)
+    {
+        return of(rules.type(), rules.color());
+    }
+};
+
+namespace Detail
+{
+
+struct SymmetricColors
+{
+    uint8_t count;
+    uint8_t colors[numColors];
+};
+
+// the symmetric colors in ascending order, per bit mask of colors
+inline const SymmetricColors& symmetricColorList(int symmetric)
+{
+    static const struct Table
+    {
+        Table()
+        {
+            for (int mask = 0; mask < 16; ++mask) {
+                lists[mask].count = 0;
+                for (int c = 0; c < numColors; ++c) {
+                    if (mask & (1 << c))
+                        lists[mask].colors[lists[mask].count++] = uint8_t(c);
+                }
+            }
+        }
+        SymmetricColors lists[16];
+    } table;
+    return table.lists[symmetric];
+}
+
+// the permutation that orders the symmetric colors by their key, the
+// smallest key goes to the lowest of the symmetric colors
+template <typename Key>
+inline ColorPermutation sortColors(const Key keys[numColors], int symmetric)
+{
+    const SymmetricColors& list = symmetricColorList(symmetric);
+
+    uint8_t sorted[numColors];
+    for (int i = 0; i < list.count; ++i) {
+        const uint8_t color = list.colors[i];
+        int j = i;
+        for (; j > 0 && keys[color] < keys[sorted[j - 1]]; --j)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = color;
+    }
+
+    ColorPermutation result = ColorPermutation::identity();
+    for (int i = 0; i < list.count; ++i)
+        result.map[sorted[i]] = list.colors[i];
+    return result;
+}
+
+}
+
+inline const ColorPermutation& ColorPermutation::fromIndex(int index)
+{
+    assert(index >= 0 && index < numPermutations);
+
+    static const struct Table
+    {
+        Table()
+        {
+            ColorPermutation perm = identity();
+            do {
+                permutations[perm.index()] = perm;
+            } while (std::next_permutation(perm.map, perm.map + numColors));
+        }
+        ColorPermutation permutations[numPermutations];
+    } table;
+    return table.permutations[index];
+}
+
+// The canonical hand is the hand with its symmetric colors relabeled so
+// that their bytes are ascending. All hands that only differ by
+// relabeling symmetric colors share it. perm maps hand to the result.
+inline CardMask canonicalHand(CardMask hand, const Symmetry& symmetry, ColorPermutation& perm)
+{
+    const CardMask moving = hand & ~symmetry.fixed;
+    uint8_t keys[numColors];
+    for (int c = 0; c < numColors; ++c)
+        keys[c] = uint8_t(moving >> (c * numCardTypes));
+
+    perm = Detail::sortColors(keys, symmetry.colors);
+    return perm.apply(hand, symmetry.fixed);
+}
+
+inline CardMask canonicalHand(CardMask hand, const Rules& rules, ColorPermutation& perm)
+{
+    return canonicalHand(hand, Symmetry::of(rules), perm);
+}
+
+// the same for all cards of a position, the game of the position stays the
+// same. perm, applied with the fixed cards of the game, maps position to the result.
+inline Position canonicalPosition(const Position& position, ColorPermutation& perm)
+{
+    struct Key
+    {
+        uint64_t hands;
+        uint64_t won;
+
+        bool operator<(const Key& other) const
+        {
+            return hands < other.hands || (hands == other.hands && won < other.won);
+        }
+    };
+
+    const Symmetry symmetry = Symmetry::of(*position.rules);
+    const CardMask fixed = symmetry.fixed;
+
+    // the order of the cards in the stich matters, so every card of the
+    // stich is in the key with its position
+    Key keys[numColors];
+    for (int c = 0; c < numColors; ++c) {
+        const int shift = c * numCardTypes;
+        keys[c].hands = 0;
+        keys[c].won = 0;
+        for (int i = 0; i < numPlayers - 1; ++i) {
+            const int card = position.trick[i];
+            const bool inColor = i < position.numInTrick && card / numCardTypes == c && !(fixed & cardBit(card));
+            keys[c].hands = keys[c].hands << 8 | (inColor ? card % numCardTypes + 1 : 0);
+        }
+        for (int i = 0; i < numPlayers; ++i) {
+            keys[c].hands = keys[c].hands << 8 | ((position.hands[i] & ~fixed) >> shift & 0xff);
+            keys[c].won = keys[c].won << 8 | ((position.won[i] & ~fixed) >> shift & 0xff);
+        }
+    }
+
+    perm = Detail::sortColors(keys, symmetry.colors);
+
+    Position result = position;
+    for (int i = 0; i < numPlayers; ++i) {
+        result.hands[i] = perm.apply(position.hands[i], fixed);
+        result.won[i] = perm.apply(position.won[i], fixed);
+    }
+    result.played = perm.apply(position.played, fixed);
+    for (int i = 0; i < position.numInTrick; ++i)
+        result.trick[i] = uint8_t(perm.apply(int(position.trick[i]), fixed));
+    return result;
+}
+
+}
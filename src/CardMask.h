@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Schafkopf.h"
+
+#include <cstdint>
+
+namespace SchafKopf
+{
+
+// A set of cards, bit Card::hashValue() is set for every card in the set.
+// Each color occupies one byte, within a byte the bits follow CardType.
+typedef uint32_t CardMask;
+
+constexpr int numCards = Deck::numCards;
+
+constexpr CardMask allCards = 0xffffffffu;
+
+inline int cardIndex(const Card& card)
+{
+    return card.hashValue();
+}
+
+inline CardMask cardBit(const Card& card)
+{
+    return CardMask(1) << card.hashValue();
+}
+
+inline CardMask cardBit(int index)
+{
+    assert(index >= 0 && index < numCards);
+    return CardMask(1) << index;
+}
+
+inline Card cardAt(int index)
+{
+    return Card::fromHashValue(index);
+}
+
+constexpr CardMask colorMask(Color color)
+{
+    return CardMask(0xff) << (color * numCardTypes);
+}
+
+constexpr CardMask typeMask(CardType cardType)
+{
+    return CardMask(0x01010101) << cardType;
+}
+
+inline int popCount(CardMask mask)
+{
+    return __builtin_popcount(mask);
+}
+
+// index of the lowest card in a non-empty mask
+inline int lowestCard(CardMask mask)
+{
+    assert(mask);
+    return __builtin_ctz(mask);
+}
+
+inline CardMask lowestBit(CardMask mask)
+{
+    return mask & (~mask + 1);
+}
+
+// index of the n-th lowest card in mask, n must be smaller than popCount(mask)
+inline int nthCard(CardMask mask, int n)
+{
+    assert(n >= 0 && n < popCount(mask));
+    for (; n > 0; --n)
+        mask &= mask - 1;
+    return lowestCard(mask);
+}
+
+// number of cards of cardType in the mask, adds up the four colors with
+// one multiplication instead of a popcount, which is a library call
+// unless the target has one
+inline int typeCount(CardMask mask, CardType cardType)
+{
+    return int((((mask >> cardType) & 0x01010101u) * 0x01010101u) >> 24);
+}
+
+// sum of the card points of all cards in the mask
+inline int maskPoints(CardMask mask)
+{
+    return typeCount(mask, Ass) * 11
+            + typeCount(mask, Zehner) * 10
+            + typeCount(mask, Koenig) * 4
+            + typeCount(mask, Ober) * 3
+            + typeCount(mask, Unter) * 2;
+}
+
+inline CardMask handMask(const Player& player)
+{
+    CardMask result = 0;
+    for (const auto& card : player.m_cards) {
+        if (card)
+            result |= cardBit(*card);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// SCHAFKOPF_AVX2 is defined where AVX2 kernels can be compiled (with a
+// target attribute) and selected at runtime with hasAvx2()
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(EMSCRIPTEN)
+#define SCHAFKOPF_AVX2
+#include <immintrin.h>
+#endif
+
+namespace SchafKopf
+{
+
+inline bool hasAvx2()
+{
+#ifdef SCHAFKOPF_AVX2
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+#else
+    return false;
+#endif
+}
+
+}
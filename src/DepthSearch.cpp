@@ -0,0 +1,125 @@
+#include "DepthSearch.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace SchafKopf
+{
+
+static constexpr float infinity = std::numeric_limits<float>::infinity();
+
+DepthSearch::DepthSearch(const NetEvaluator& evaluator)
+    : m_evaluator(evaluator),
+      m_rootPoints(0),
+      m_targetStiche(0),
+      m_numLeaves(0)
+{
+}
+
+void DepthSearch::prepare(const Position& root, int depth)
+{
+    assert(!root.finished());
+    m_rootPoints = root.declarerPoints();
+    m_targetStiche = root.numStiche() + 1 + depth;
+    m_numLeaves = 0;
+    std::fill(&m_history[0][0], &m_history[0][0] + numPlayers * numCards, 0u);
+}
+
+int DepthSearch::nextMove(int player, CardMask moves) const
+{
+    // the card that caused the most cutoffs so far, the lowest if none did
+    const uint32_t *history = m_history[player];
+    int result = lowestCard(moves);
+    for (CardMask rest = moves & (moves - 1); rest; rest &= rest - 1) {
+        const int card = lowestCard(rest);
+        if (history[card] > history[result])
+            result = card;
+    }
+    return result;
+}
+
+// The leaves one by one: a batch is not faster per position than single
+// calls, and a cutoff saves the rest of them.
+float DepthSearch::horizon(const Position& position, CardMask moves, bool maximize, float alpha, float beta)
+{
+    float best = maximize ? -infinity : infinity;
+    for (CardMask rest = moves; rest; rest &= rest - 1) {
+        Position next = position;
+        next.play(lowestCard(rest));
+        float value = float(next.declarerPoints() - m_rootPoints);
+        if (!next.finished()) {
+            value += m_evaluator.evaluate(next);
+            ++m_numLeaves;
+        }
+        best = maximize ? std::max(best, value) : std::min(best, value);
+        if (maximize ? best >= beta : best <= alpha)
+            break;
+    }
+    return best;
+}
+
+float DepthSearch::search(const Position& position, float alpha, float beta)
+{
+    const int player = position.toMove();
+    const bool maximize = position.isDeclarer(player);
+    CardMask moves = position.rules->representatives(position.legalMoves(), position.played);
+
+    if (position.numInTrick == numPlayers - 1
+            && (position.numStiche() + 1 >= m_targetStiche || position.numStiche() + 1 == Player::maxCards))
+        return horizon(position, moves, maximize, alpha, beta);
+
+    // plies to the horizon, cutoffs close to the root count more
+    const int left = m_targetStiche * numPlayers - popCount(position.played) - position.numInTrick;
+    float best = maximize ? -infinity : infinity;
+    while (moves) {
+        const int card = nextMove(player, moves);
+        moves &= ~cardBit(card);
+
+        Position next = position;
+        next.play(card);
+        const float value = search(next, alpha, beta);
+        if (maximize) {
+            best = std::max(best, value);
+            alpha = std::max(alpha, value);
+        } else {
+            best = std::min(best, value);
+            beta = std::min(beta, value);
+        }
+        if (alpha >= beta) {
+            m_history[player][card] += uint32_t(left * left);
+            break;
+        }
+    }
+    return best;
+}
+
+float DepthSearch::value(const Position& position, int depth)
+{
+    prepare(position, depth);
+    return search(position, -infinity, infinity);
+}
+
+int DepthSearch::moveValues(const Position& position, int depth, uint8_t *moves, float *values)
+{
+    prepare(position, depth);
+    const bool leaves = position.numInTrick == numPlayers - 1 && position.numStiche() + 1 >= m_targetStiche;
+    int count = 0;
+    for (CardMask rest = position.legalMoves(); rest; rest &= rest - 1, ++count) {
+        moves[count] = uint8_t(lowestCard(rest));
+        Position next = position;
+        next.play(moves[count]);
+        values[count] = float(next.declarerPoints() - m_rootPoints);
+        if (next.finished())
+            continue;
+        if (leaves) {
+            values[count] += m_evaluator.evaluate(next);
+            ++m_numLeaves;
+        } else {
+            // a full window, every move gets its exact value
+            values[count] = search(next, -infinity, infinity);
+        }
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ExpertPolicy.h"
+
+namespace SchafKopf
+{
+
+// Plays the cards of ExpertPolicy, which only needs what the player can
+// see. The teams are taken as the player can tell them, see knownTeam().
+class ExpertAi : public AI
+{
+public:
+    ExpertAi(const Game& game, const Player& player)
+        : m_game(game),
+          m_player(player)
+    {
+        assert(player.id >= 0 && player.id < 4);
+    }
+
+    void cardPlayed(const ActivePile&, int) override
+    {
+        // nothing, the policy reads the game on its turn
+    }
+
+    int doPlayCard(const ActivePile&) override
+    {
+        const ExpertPolicy& policy = ExpertPolicy::get(m_game.gameType, m_game.gameColor);
+        Position position = Position::fromGame(m_game, policy.rules());
+        position.declarerTeam = knownTeam(position, m_player.id, m_game.declarer);
+        const Card card = cardAt(policy.move(position));
+        for (int i = 0; i < Player::maxCards; ++i) {
+            if (m_player.m_cards[i] && *m_player.m_cards[i] == card) {
+                assert(m_game.canPutCard(i));
+                return i;
+            }
+        }
+
+        assert(false); // called on a player w/o cards
+        return 0;
+    }
+
+    void reset() override
+    {
+        // no state
+    }
+
+    // The declarer team as player can tell it. In a Sauspiel the partner
+    // is hidden until the called Sau is played, except to whoever holds
+    // it; until then the player takes the declarer to play alone.
+    static uint8_t knownTeam(const Position& position, int player, int declarer)
+    {
+        if (position.rules->type() != Game::SauSpiel)
+            return position.declarerTeam;
+        const CardMask sau = cardBit(Card{ Ass, position.rules->color() });
+        if ((position.played | position.trickMask() | position.hands[player]) & sau)
+            return position.declarerTeam;
+        return uint8_t(1u << declarer);
+    }
+
+private:
+    const Game& m_game;
+    const Player& m_player;
+};
+
+}
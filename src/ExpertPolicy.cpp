@@ -0,0 +1,166 @@
+#include "ExpertPolicy.h"
+
+#include <vector>
+
+namespace SchafKopf
+{
+
+ExpertPolicy::ExpertPolicy(const Rules& rules)
+    : m_rules(rules),
+      m_oberUnter(rules.trumps() & (typeMask(Ober) | typeMask(Unter)))
+{
+    for (int suit = 0; suit < Rules::numSuits; ++suit) {
+        for (int card = 0; card < numCards; ++card) {
+            m_beats[suit][card] = 0;
+            for (int other = 0; other < numCards; ++other) {
+                if (rules.trickKey(suit, other) > rules.trickKey(suit, card))
+                    m_beats[suit][card] |= cardBit(other);
+            }
+        }
+    }
+}
+
+const ExpertPolicy& ExpertPolicy::get(Game::Type type, Color color)
+{
+    static const struct Table
+    {
+        Table()
+        {
+            for (int type = 0; type < numGameTypes; ++type) {
+                for (int color = 0; color < numColors; ++color)
+                    policies.emplace_back(Rules::get(Game::Type(type), Color(color)));
+            }
+        }
+        std::vector<ExpertPolicy> policies;
+    } table;
+    return table.policies[size_t(type * numColors + color)];
+}
+
+int ExpertPolicy::weakest(CardMask mask) const
+{
+    const CardMask colors = mask & ~m_rules.trumps();
+    if (colors)
+        return lowestCard(colors & typeMask(CardType(__builtin_ctz(types(colors)))));
+    // the lowest trump has the highest rank
+    return m_rules.trumpOrder()[31 - __builtin_clz(m_rules.trumpRanks(mask))];
+}
+
+int ExpertPolicy::strongest(CardMask mask) const
+{
+    const CardMask trumps = mask & m_rules.trumps();
+    if (trumps)
+        return m_rules.trumpOrder()[__builtin_ctz(m_rules.trumpRanks(trumps))];
+    return lowestCard(mask & typeMask(CardType(31 - __builtin_clz(types(mask)))));
+}
+
+// card types are ordered by points
+int ExpertPolicy::cheapest(CardMask mask) const
+{
+    const CardMask colors = mask & ~m_rules.trumps();
+    const CardMask pool = colors ? colors : mask;
+    return weakest(pool & typeMask(CardType(__builtin_ctz(types(pool)))));
+}
+
+int ExpertPolicy::mostPoints(CardMask mask) const
+{
+    const CardMask smeared = mask & ~m_oberUnter;
+    if (!smeared)
+        return cheapest(mask);
+    const CardMask colors = smeared & ~m_rules.trumps();
+    const CardMask pool = colors ? colors : smeared;
+    return weakest(pool & typeMask(CardType(31 - __builtin_clz(types(pool)))));
+}
+
+int ExpertPolicy::move(const Position& position) const
+{
+    const CardMask legal = position.legalMoves();
+    if (!(legal & (legal - 1)))
+        return lowestCard(legal);
+
+    // the cards the others may still hold
+    const CardMask hand = position.hands[position.toMove()];
+    const CardMask outstanding = ~(position.played | position.trickMask() | hand);
+    return position.numInTrick ? follow(position, legal, outstanding) : lead(position, hand, outstanding);
+}
+
+int ExpertPolicy::lead(const Position& position, CardMask hand, CardMask outstanding) const
+{
+    const CardMask trumps = hand & m_rules.trumps();
+    const bool declarerTeam = position.isDeclarer(position.toMove());
+
+    // draw trumps while the others have some
+    if (declarerTeam && trumps && (outstanding & m_rules.trumps())) {
+        const int top = strongest(trumps);
+        return m_beats[Rules::trumpSuit][top] & outstanding ? weakest(trumps) : top;
+    }
+
+    const CardMask colors = hand & ~m_rules.trumps();
+    CardMask masters = 0;
+    for (CardMask rest = colors; rest; rest &= rest - 1) {
+        const int card = lowestCard(rest);
+        if (!(m_beats[m_rules.suit(card)][card] & outstanding))
+            masters |= lowestBit(rest);
+    }
+    if (masters)
+        return mostPoints(masters);
+
+    // look for the called Sau, with a low card of its color
+    if (m_rules.type() == Game::SauSpiel && !declarerTeam) {
+        const CardMask called = colors & m_rules.suitMask(m_rules.color());
+        if (called && (outstanding & cardBit(Card{ Ass, m_rules.color() })))
+            return cheapest(called);
+    }
+
+    if (!colors)
+        return weakest(trumps);
+
+    // free a color, to trump it later
+    CardMask shortest = 0;
+    for (int color = 0; color < numColors; ++color) {
+        const CardMask suit = colors & m_rules.suitMask(color);
+        if (suit && (!shortest || popCount(suit) < popCount(shortest)))
+            shortest = suit;
+    }
+    return cheapest(shortest);
+}
+
+int ExpertPolicy::follow(const Position& position, CardMask legal, CardMask outstanding) const
+{
+    const int leadSuit = m_rules.suit(position.trick[0]);
+    int winner = 0;
+    for (int i = 1; i < position.numInTrick; ++i) {
+        if ((m_beats[leadSuit][position.trick[winner]] >> position.trick[i]) & 1)
+            winner = i;
+    }
+    const int best = position.trick[winner];
+
+    const int player = position.toMove();
+    const bool declarerTeam = position.isDeclarer(player);
+    bool othersAfter = false;
+    for (int i = position.numInTrick + 1; i < numPlayers; ++i)
+        othersAfter |= position.isDeclarer((position.leader + i) & (numPlayers - 1)) != declarerTeam;
+
+    if (position.isDeclarer((position.leader + winner) & (numPlayers - 1)) == declarerTeam) {
+        const bool sure = !othersAfter || !(m_beats[leadSuit][best] & outstanding);
+        return sure ? mostPoints(legal) : cheapest(legal);
+    }
+
+    const CardMask winners = m_beats[leadSuit][best] & legal;
+    if (winners) {
+        if (!othersAfter)
+            return weakest(winners);
+
+        CardMask masters = 0;
+        for (CardMask rest = winners; rest; rest &= rest - 1) {
+            if (!(m_beats[leadSuit][lowestCard(rest)] & outstanding))
+                masters |= lowestBit(rest);
+        }
+        if (masters)
+            return weakest(masters);
+        if (maskPoints(position.trickMask()) >= 10)
+            return weakest(winners);
+    }
+    return cheapest(legal);
+}
+
+}
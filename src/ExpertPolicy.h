@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Position.h"
+
+namespace SchafKopf
+{
+
+// A card player that follows the usual rules of thumb, cheap enough for
+// rollouts.
+//
+// Leading, the declarer's team draws trumps: the highest trump if nobody
+// can beat it, a low one otherwise. Everybody else cashes the masters of
+// a color, defenders in a Sauspiel look for the called Sau, and the rest
+// leads low from the shortest color.
+//
+// Following, a player smears the most points into a stich the own team
+// takes for sure, but not Ober or Unter, and takes a stich of the other
+// team with the weakest card that nobody after can beat - or with the
+// weakest card that wins so far if nobody of the other team comes after,
+// or if the stich is worth it. Otherwise the player throws the cheapest
+// card, a color card before a trump.
+//
+// It looks at the own hand, the cards gone and the current stich only,
+// and takes the teams from the position. Rollouts with all cards known
+// pass the real ones; ExpertAi passes what the player can know.
+// Everything is masks: the cards that beat a card come from a table, and
+// the cheapest or strongest card of a mask from folding its colors.
+class ExpertPolicy
+{
+public:
+    explicit ExpertPolicy(const Rules& rules);
+
+    const Rules& rules() const { return m_rules; }
+
+    // the card the player to move plays, one of position.legalMoves()
+    int move(const Position& position) const;
+
+    // the policies of all games, built once
+    static const ExpertPolicy& get(Game::Type type, Color color);
+
+    // the cards that take a stich led with suit from card
+    CardMask beats(int suit, int card) const { return m_beats[suit][card]; }
+
+    // the card with the fewest points of mask, a color card before a
+    // trump, the weakest of equal ones
+    int cheapest(CardMask mask) const;
+
+    // the card with the most points of mask, without Ober and Unter that
+    // are trumps, a color card before a trump
+    int mostPoints(CardMask mask) const;
+
+    // the weakest and the strongest card of mask, trumps are stronger
+    // than color cards, which are compared by type
+    int weakest(CardMask mask) const;
+    int strongest(CardMask mask) const;
+
+private:
+    int lead(const Position& position, CardMask hand, CardMask outstanding) const;
+    int follow(const Position& position, CardMask legal, CardMask outstanding) const;
+
+    // bit t is set if mask has a card of type t
+    static uint32_t types(CardMask mask)
+    {
+        mask |= mask >> 16;
+        mask |= mask >> 8;
+        return mask & 0xff;
+    }
+
+    const Rules& m_rules;
+    CardMask m_beats[Rules::numSuits][numCards];
+    CardMask m_oberUnter;
+};
+
+}
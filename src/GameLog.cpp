@@ -0,0 +1,111 @@
+#include "GameLog.h"
+
+#include <cstring>
+
+namespace SchafKopf
+{
+
+// the hands from who played the cards of each stich, whether or not that was legal
+static Deal dealtHands(const GameRecord& record)
+{
+    const Rules& rules = record.rules();
+    Deal deal;
+    for (int p = 0; p < numPlayers; ++p)
+        deal.hands[p] = 0;
+    int leader = record.leader;
+    for (int i = 0; i < numCards; i += numPlayers) {
+        for (int j = 0; j < numPlayers; ++j)
+            deal.hands[(leader + j) & (numPlayers - 1)] |= cardBit(record.cards[i + j]);
+        leader = (leader + rules.trickWinner(record.cards + i)) & (numPlayers - 1);
+    }
+    return deal;
+}
+
+bool GameRecord::deal(Deal& deal) const
+{
+    if (type > Game::Solo || color >= numColors || declarer >= numPlayers || leader >= numPlayers)
+        return false;
+
+    CardMask seen = 0;
+    for (int i = 0; i < numCards; ++i) {
+        if (cards[i] >= numCards || ((seen >> cards[i]) & 1))
+            return false;
+        seen |= cardBit(cards[i]);
+    }
+
+    Position position = start();
+    for (int i = 0; i < numCards; ++i) {
+        if (!(position.legalMoves() & cardBit(cards[i])))
+            return false;
+        position.play(cards[i]);
+    }
+    deal = dealtHands(*this);
+    return true;
+}
+
+Position GameRecord::start() const
+{
+    return Position(rules(), dealtHands(*this), declarer, leader);
+}
+
+namespace GameLog
+{
+
+GameRecord record(const Position& start, int declarer, const uint8_t cards[numCards])
+{
+    GameRecord result;
+    result.type = uint8_t(start.rules->type());
+    result.color = uint8_t(start.rules->color());
+    result.declarer = uint8_t(declarer);
+    result.leader = start.leader;
+    std::copy(cards, cards + numCards, result.cards);
+    return result;
+}
+
+// 0 if there is no such file
+static std::streamoff fileSize(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return file ? std::streamoff(file.tellg()) : 0;
+}
+
+Writer::Writer(const std::string& fileName, bool append)
+{
+    // a new or empty file gets the header
+    const bool empty = !append || fileSize(fileName) == 0;
+    m_file.open(fileName, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (m_file && empty) {
+        Header header;
+        std::memcpy(header.magic, "SKGL", 4);
+        header.version = version;
+        m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+}
+
+void Writer::write(const GameRecord& record)
+{
+    m_file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+}
+
+Reader::Reader(const std::string& fileName)
+    : m_file(fileName, std::ios::binary),
+      m_valid(false)
+{
+    Header header;
+    if (m_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        m_valid = std::memcmp(header.magic, "SKGL", 4) == 0 && header.version == version;
+}
+
+size_t Reader::read(GameRecord *records, size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid)
+        return 0;
+    m_file.read(reinterpret_cast<char *>(records), std::streamsize(count * sizeof(GameRecord)));
+    // a record cut off at the end of the file is left out
+    return size_t(m_file.gcount()) / sizeof(GameRecord);
+}
+
+}
+
+}
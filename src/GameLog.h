@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Position.h"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// A played game as it is recorded: the contract, who led the first
+// stich and all cards in the order they were played. The hands follow
+// from replaying the stiche, so they are not stored.
+struct GameRecord
+{
+    uint8_t type;
+    uint8_t color;
+    uint8_t declarer;
+    uint8_t leader;
+    uint8_t cards[numCards];
+
+    const Rules& rules() const { return Rules::get(Game::Type(type), Color(color)); }
+
+    // The hands as they were dealt. false if the record is no complete
+    // game: a card is out of range or twice, or a card could not be played
+    // where it was, as far as Rules::legalMoves can tell.
+    bool deal(Deal& deal) const;
+
+    // the position at the start of the game, valid if deal() is true
+    Position start() const;
+};
+
+// Files of GameRecords after a small header, written by appending, read
+// in chunks by any number of threads.
+namespace GameLog
+{
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+};
+
+static constexpr uint32_t version = 1;
+
+// the record of the game that went from start with cards, declared by declarer
+GameRecord record(const Position& start, int declarer, const uint8_t cards[numCards]);
+
+class Writer
+{
+public:
+    // starts a new file, or appends to an existing log
+    explicit Writer(const std::string& fileName, bool append = false);
+
+    bool isOpen() const { return bool(m_file); }
+    void write(const GameRecord& record);
+
+private:
+    std::ofstream m_file;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const std::string& fileName);
+
+    // false if the file cannot be opened or has no valid header
+    bool isOpen() const { return m_valid; }
+
+    // Up to count of the next records, returns how many. Threads share a
+    // reader, each taking chunks of records to process without locking.
+    size_t read(GameRecord *records, size_t count);
+
+private:
+    std::mutex m_mutex;
+    std::ifstream m_file;
+    bool m_valid;
+};
+
+}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Schafkopf.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// A Game with an AI of type SeatAi in every seat, wired up once. Games
+// and AIs refer to each other by address, so a bundle never moves.
+template <typename SeatAi>
+struct GameBundle
+{
+    GameBundle()
+        : seats{ { game, game.players[0] }, { game, game.players[1] },
+                 { game, game.players[2] }, { game, game.players[3] } }
+    {
+        for (int i = 0; i < numPlayers; ++i)
+            game.ais[i] = &seats[i];
+    }
+
+    GameBundle(const GameBundle&) = delete;
+    GameBundle& operator=(const GameBundle&) = delete;
+
+    // plays the current deal to the end, every seat plays its AI's card
+    void play()
+    {
+        while (game.numStiche < Player::maxCards)
+            game.putCard(seats[game.m_activePlayer].doPlayCard(game.activePile));
+    }
+
+    Game game;
+    SeatAi seats[numPlayers];
+};
+
+// Hands out GameBundles to simulation workers. A worker acquires one,
+// keeps it for its lifetime and starts every game with Game::redeal(),
+// which does not clear anything: the stich history is only valid up to
+// numStiche and AIs notice the new epoch of the game themselves.
+template <typename SeatAi>
+class GamePool
+{
+public:
+    typedef GameBundle<SeatAi> Bundle;
+
+    // returns the bundle to the pool when it goes out of scope
+    class Lease
+    {
+    public:
+        Lease(GamePool& pool, std::unique_ptr<Bundle> bundle)
+            : m_pool(&pool),
+              m_bundle(std::move(bundle))
+        {}
+
+        Lease(Lease&& other) = default;
+
+        ~Lease()
+        {
+            if (m_bundle)
+                m_pool->release(std::move(m_bundle));
+        }
+
+        Bundle& operator*() const { return *m_bundle; }
+        Bundle* operator->() const { return m_bundle.get(); }
+
+    private:
+        GamePool* m_pool;
+        std::unique_ptr<Bundle> m_bundle;
+    };
+
+    // creates numBundles bundles up front, more are created when needed
+    explicit GamePool(int numBundles = 0)
+    {
+        for (int i = 0; i < numBundles; ++i)
+            m_free.emplace_back(new Bundle);
+    }
+
+    Lease acquire()
+    {
+        std::unique_ptr<Bundle> bundle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_free.empty()) {
+                bundle = std::move(m_free.back());
+                m_free.pop_back();
+            }
+        }
+        if (!bundle)
+            bundle.reset(new Bundle);
+        return Lease(*this, std::move(bundle));
+    }
+
+    size_t numFree() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_free.size();
+    }
+
+private:
+    void release(std::unique_ptr<Bundle> bundle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(std::move(bundle));
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Bundle>> m_free;
+};
+
+}
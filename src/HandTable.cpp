@@ -0,0 +1,317 @@
+#include "HandTable.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32) && !defined(EMSCRIPTEN)
+#define SCHAFKOPF_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SchafKopf
+{
+
+static constexpr int numBuckets = 256;
+
+HandTable::HandTable(const std::string& fileName)
+    : m_fileName(fileName)
+{
+}
+
+HandTable::~HandTable()
+{
+    unmap();
+}
+
+bool HandTable::load() const
+{
+    std::call_once(m_loaded, [this]() { m_valid = map(); });
+    return m_valid;
+}
+
+bool HandTable::map() const
+{
+#ifdef SCHAFKOPF_MMAP
+    const int fd = ::open(m_fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < off_t(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+
+    void *data = ::mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const char *>(data);
+    m_size = size_t(info.st_size);
+#else
+    std::ifstream file(m_fileName, std::ios::binary);
+    if (!file)
+        return false;
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    if (m_size < sizeof(Header))
+        return false;
+#endif
+
+    m_header = reinterpret_cast<const Header *>(m_data);
+    if (std::memcmp(m_header->magic, "SKHT", 4) != 0 || m_header->version != version)
+        return false;
+
+    // the sections follow the header, each with its buckets, hands and entries
+    size_t offset = sizeof(Header);
+    for (int f = 0; f < numFamilies; ++f) {
+        const size_t numHands = m_header->numHands[f];
+        const size_t size = (numBuckets + 1) * sizeof(uint32_t) + numHands * sizeof(CardMask)
+                + numHands * size_t(numSlots(Family(f))) * sizeof(Entry);
+        if (offset + size > m_size)
+            return false;
+
+        Section& section = m_sections[f];
+        section.buckets = reinterpret_cast<const uint32_t *>(m_data + offset);
+        section.hands = reinterpret_cast<const CardMask *>(section.buckets + numBuckets + 1);
+        section.entries = reinterpret_cast<const Entry *>(section.hands + numHands);
+        offset += size;
+    }
+    return offset == m_size;
+}
+
+void HandTable::unmap() const
+{
+#ifdef SCHAFKOPF_MMAP
+    if (m_data)
+        ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool HandTable::lookup(CardMask hand, const Contract& contract, ContractValue& value) const
+{
+    if (!load())
+        return false;
+
+    const Family f = family(contract.type);
+    const Section& section = m_sections[f];
+
+    ColorPermutation perm;
+    const CardMask canonical = canonicalHand(f, hand, perm);
+
+    // hands are bucketed by their highest byte
+    const uint32_t bucket = canonical >> (numCards - numCardTypes);
+    const CardMask *begin = section.hands + section.buckets[bucket];
+    const CardMask *end = section.hands + section.buckets[bucket + 1];
+    const CardMask *it = std::lower_bound(begin, end, canonical);
+    if (it == end || *it != canonical)
+        return false;
+
+    const Entry &entry = section.entries[size_t(it - section.hands) * size_t(numSlots(f))
+            + slot(contract.type, perm.apply(contract.color), perm.apply(Herz))];
+    if (entry.value == invalidValue)
+        return false;
+
+    value.contract = contract;
+    value.value = entry.value / 10.0;
+    value.winProbability = entry.winProbability / 65535.0;
+    return true;
+}
+
+HandTable::Family HandTable::family(Game::Type type)
+{
+    switch (type) {
+    case Game::Solo:
+    case Game::SauSpiel:
+        return OberUnterFamily;
+    case Game::Wenz:
+    case Game::FarbWenz:
+        return UnterFamily;
+    case Game::Geier:
+    case Game::FarbGeier:
+        return OberFamily;
+    }
+    assert(false);
+    return OberUnterFamily;
+}
+
+int HandTable::numSlots(Family family)
+{
+    return family == OberUnterFamily ? int(maxSlots) : FarbWenzSlot + numColors;
+}
+
+int HandTable::slot(Game::Type type, Color color, Color trump)
+{
+    switch (type) {
+    case Game::Wenz:
+        return WenzSlot;
+    case Game::Geier:
+        return GeierSlot;
+    case Game::FarbWenz:
+        return FarbWenzSlot + color;
+    case Game::FarbGeier:
+        return FarbGeierSlot + color;
+    case Game::Solo:
+        return SoloSlot + color;
+    case Game::SauSpiel:
+        assert(color != trump);
+        return SauSpielSlot + trump * (numColors - 1) + color - (color > trump);
+    }
+    assert(false);
+    return 0;
+}
+
+std::vector<CardMask> HandTable::canonicalHands(Family family)
+{
+    // the fixed cards are at the same place in every color
+    const CardMask fixed = symmetry(family).fixed;
+    const uint32_t fixedByte = fixed & 0xff;
+
+    std::vector<uint32_t> bytesWithCount[Player::maxCards + 1];
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        const int count = popCount(byte);
+        if (!(byte & fixedByte) && count <= Player::maxCards)
+            bytesWithCount[count].push_back(byte);
+    }
+
+    // any subset of the fixed cards, with the rest of the hand in colors
+    // of ascending bytes
+    std::vector<CardMask> result;
+    CardMask subset = 0;
+    do {
+        const int count = popCount(subset);
+        if (count > Player::maxCards)
+            continue;
+
+        for (int n3 = 0; count + n3 <= Player::maxCards; ++n3) {
+            for (uint32_t b3 : bytesWithCount[n3]) {
+                for (int n2 = 0; count + n3 + n2 <= Player::maxCards; ++n2) {
+                    for (uint32_t b2 : bytesWithCount[n2]) {
+                        if (b2 > b3)
+                            continue;
+                        for (int n1 = 0; count + n3 + n2 + n1 <= Player::maxCards; ++n1) {
+                            for (uint32_t b1 : bytesWithCount[n1]) {
+                                if (b1 > b2)
+                                    continue;
+                                for (uint32_t b0 : bytesWithCount[Player::maxCards - count - n3 - n2 - n1]) {
+                                    if (b0 <= b1)
+                                        result.push_back(subset | b3 << 24 | b2 << 16 | b1 << 8 | b0);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } while ((subset = (subset - fixed) & fixed) != 0);
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static HandTable::Entry toEntry(const ContractValue& value)
+{
+    const double clamped = std::max(-3276.7, std::min(3276.7, value.value));
+    return HandTable::Entry{ int16_t(std::lround(clamped * 10.0)), uint16_t(std::lround(value.winProbability * 65535.0)) };
+}
+
+void HandTable::evaluate(Family family, CardMask canonicalHand, ContractEvaluator& evaluator, Entry *entries)
+{
+    std::fill(entries, entries + numSlots(family), Entry{ invalidValue, 0 });
+
+    static const Contract familyContracts[numFamilies][7] = {
+        { { Game::Solo, Schelln }, { Game::Solo, Herz }, { Game::Solo, Gras }, { Game::Solo, Eichel },
+          { Game::SauSpiel, Schelln }, { Game::SauSpiel, Gras }, { Game::SauSpiel, Eichel } },
+        { { Game::Wenz, Schelln }, { Game::FarbWenz, Schelln }, { Game::FarbWenz, Herz },
+          { Game::FarbWenz, Gras }, { Game::FarbWenz, Eichel } },
+        { { Game::Geier, Schelln }, { Game::FarbGeier, Schelln }, { Game::FarbGeier, Herz },
+          { Game::FarbGeier, Gras }, { Game::FarbGeier, Eichel } }
+    };
+    const int numFamilyContracts = family == OberUnterFamily ? 7 : 5;
+
+    ContractValue values[numContracts];
+    int count = evaluator.evaluate(canonicalHand, 0, 0, familyContracts[family], numFamilyContracts, values);
+    for (int i = 0; i < count; ++i)
+        entries[slot(values[i].contract.type, values[i].contract.color)] = toEntry(values[i]);
+
+    if (family != OberUnterFamily)
+        return;
+
+    // Sauspiele with another trump color are real Sauspiele of the hand
+    // with that color swapped with Herz
+    const Contract *sauSpiele = familyContracts[family] + numColors;
+    const CardMask fixed = symmetry(family).fixed;
+    for (int trump = 0; trump < numColors; ++trump) {
+        if (trump == Herz)
+            continue;
+
+        ColorPermutation swap = ColorPermutation::identity();
+        std::swap(swap.map[trump], swap.map[Herz]);
+
+        count = evaluator.evaluate(swap.apply(canonicalHand, fixed), 0, 0, sauSpiele, numColors - 1, values);
+        for (int i = 0; i < count; ++i)
+            entries[slot(Game::SauSpiel, swap.apply(values[i].contract.color), Color(trump))] = toEntry(values[i]);
+    }
+}
+
+bool HandTable::write(const std::string& fileName, const std::vector<CardMask> hands[numFamilies],
+                      const std::vector<Entry> entries[numFamilies], int numSamples)
+{
+    Header header;
+    std::memcpy(header.magic, "SKHT", 4);
+    header.version = version;
+    for (int f = 0; f < numFamilies; ++f)
+        header.numHands[f] = uint32_t(hands[f].size());
+    header.numSamples = uint32_t(numSamples);
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (int f = 0; f < numFamilies; ++f) {
+        assert(std::is_sorted(hands[f].begin(), hands[f].end()));
+        assert(entries[f].size() == hands[f].size() * size_t(numSlots(Family(f))));
+
+        uint32_t buckets[numBuckets + 1] = {};
+        for (CardMask hand : hands[f])
+            ++buckets[(hand >> (numCards - numCardTypes)) + 1];
+        for (int i = 0; i < numBuckets; ++i)
+            buckets[i + 1] += buckets[i];
+
+        file.write(reinterpret_cast<const char *>(buckets), sizeof(buckets));
+        file.write(reinterpret_cast<const char *>(hands[f].data()), std::streamsize(hands[f].size() * sizeof(CardMask)));
+        file.write(reinterpret_cast<const char *>(entries[f].data()), std::streamsize(entries[f].size() * sizeof(Entry)));
+    }
+    return bool(file);
+}
+
+std::optional<Contract> TableBiddingAi::bid(const Auction& auction, CardMask hand)
+{
+    std::optional<Contract> result;
+    double best = m_minValue;
+    bool found = false;
+
+    for (const Contract& contract : allContracts) {
+        ContractValue value;
+        if (!m_table.lookup(hand, contract, value))
+            continue;
+        found = true;
+        if (value.value > best && auction.canBid(contract, hand)) {
+            best = value.value;
+            result = contract;
+        }
+    }
+
+    if (!found && m_fallback)
+        return m_fallback->bid(auction, hand);
+    return result;
+}
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Bidding.h"
+#include "Canonical.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// Precomputed contract values for all hands of 8 cards, as played by the
+// player who leads the first stich.
+//
+// Hands are stored once per color permutation: a hand whose colors are
+// relabeled is worth the same for the relabeled contracts. The trump Ober
+// and Unter rank by their color though, so they keep it (see Symmetry) and
+// the table has a section per family of contracts with the same trump
+// Ober and Unter. Per canonical hand, a section holds all contracts of the
+// family in the colors of that hand, including Sauspiele with any color as
+// trump, which become real Sauspiele once the trump color is mapped back
+// to Herz.
+//
+// The file is mapped into memory on the first lookup.
+class HandTable
+{
+public:
+    struct Entry
+    {
+        // average money won by the declarer, in tenths
+        int16_t value;
+        // probability to win the game, scaled to 0xffff
+        uint16_t winProbability;
+    };
+
+    // value of contracts that cannot be played with the hand
+    static constexpr int16_t invalidValue = INT16_MIN;
+
+    enum Family
+    {
+        OberUnterFamily, // Solo and Sauspiel
+        UnterFamily,     // Wenz and FarbWenz
+        OberFamily,      // Geier and FarbGeier
+        numFamilies
+    };
+
+    // slots within the section of a family
+    enum Slot
+    {
+        SoloSlot = 0,                        // + trump color
+        SauSpielSlot = SoloSlot + numColors, // + trump color * 3 + index of the called color
+        WenzSlot = 0,
+        FarbWenzSlot = 1,                    // + trump color
+        GeierSlot = 0,
+        FarbGeierSlot = 1,                   // + trump color
+        maxSlots = SauSpielSlot + numColors * (numColors - 1)
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numHands[numFamilies];
+        uint32_t numSamples;
+    };
+
+    static constexpr uint32_t version = 1;
+
+    HandTable() {}
+    explicit HandTable(const std::string& fileName);
+    ~HandTable();
+
+    HandTable(const HandTable&) = delete;
+    HandTable& operator=(const HandTable&) = delete;
+
+    const std::string& fileName() const { return m_fileName; }
+
+    // maps the file if that did not happen yet, false if it is not a valid table
+    bool load() const;
+
+    // value of the contract for hand, false if the hand is not in the table
+    // or the contract cannot be played with it
+    bool lookup(CardMask hand, const Contract& contract, ContractValue& value) const;
+
+    static Family family(Game::Type type);
+    static int numSlots(Family family);
+
+    // all four colors are symmetric, only the trump Ober and Unter are fixed
+    static Symmetry symmetry(Family family)
+    {
+        static const Game::Type types[numFamilies] = { Game::Solo, Game::Wenz, Game::Geier };
+        return Symmetry{ 0xf, Symmetry::fixedCards(types[family]) };
+    }
+
+    // the representative of hand in the section of family
+    static CardMask canonicalHand(Family family, CardMask hand, ColorPermutation& perm)
+    {
+        return SchafKopf::canonicalHand(hand, symmetry(family), perm);
+    }
+
+    // slot of contract in its section, given in the colors of the canonical
+    // hand. For a Sauspiel, trump is the color Herz became.
+    static int slot(Game::Type type, Color color, Color trump = Herz);
+
+    // all canonical hands of family, in ascending order
+    static std::vector<CardMask> canonicalHands(Family family);
+
+    // evaluates all slots of family for one canonical hand
+    static void evaluate(Family family, CardMask canonicalHand, ContractEvaluator& evaluator, Entry *entries);
+
+    // writes a table, per family hands ascending with numSlots entries each
+    static bool write(const std::string& fileName, const std::vector<CardMask> hands[numFamilies],
+                      const std::vector<Entry> entries[numFamilies], int numSamples);
+
+private:
+    bool map() const;
+    void unmap() const;
+
+    std::string m_fileName;
+
+    mutable std::once_flag m_loaded;
+    mutable bool m_valid = false;
+    mutable const char *m_data = nullptr;
+    mutable size_t m_size = 0;
+    mutable std::vector<char> m_buffer;
+
+    struct Section
+    {
+        const uint32_t *buckets;
+        const CardMask *hands;
+        const Entry *entries;
+    };
+
+    mutable const Header *m_header = nullptr;
+    mutable Section m_sections[numFamilies] = {};
+};
+
+// announces the contract with the best value in the table
+class TableBiddingAi : public BiddingAi
+{
+public:
+    // fallback is asked for hands that are not in the table
+    explicit TableBiddingAi(const HandTable& table, BiddingAi *fallback = nullptr, double minValue = 0.0)
+        : m_table(table),
+          m_fallback(fallback),
+          m_minValue(minValue)
+    {}
+
+    std::optional<Contract> bid(const Auction& auction, CardMask hand) override;
+
+private:
+    const HandTable& m_table;
+    BiddingAi *m_fallback;
+    double m_minValue;
+};
+
+}
@@ -0,0 +1,318 @@
+#include "NetEvaluator.h"
+#include "Cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace SchafKopf
+{
+
+constexpr int NetEvaluator::numInputs;
+constexpr int NetEvaluator::hidden1;
+constexpr int NetEvaluator::hidden2;
+constexpr int NetEvaluator::maxActive;
+constexpr uint32_t NetEvaluator::version;
+constexpr int NetEvaluator::activationScale;
+constexpr int NetEvaluator::weightScale;
+constexpr float NetEvaluator::pointsScale;
+
+int NetEvaluator::inputs(const Position& position, const uint8_t *voids, uint16_t *active)
+{
+    const Rules& rules = *position.rules;
+    const int player = position.toMove();
+    int count = 0;
+
+    for (CardMask rest = position.hands[player]; rest; rest &= rest - 1)
+        active[count++] = uint16_t(HandInput + lowestCard(rest));
+    for (CardMask rest = position.played; rest; rest &= rest - 1)
+        active[count++] = uint16_t(PlayedInput + lowestCard(rest));
+    for (int i = 0; i < position.numInTrick; ++i)
+        active[count++] = uint16_t(TrickInput + position.trick[i]);
+
+    for (int r = 1; r < numPlayers; ++r) {
+        const int other = (player + r) & (numPlayers - 1);
+        for (int suit = 0; suit < Rules::numSuits; ++suit) {
+            const bool isVoid = voids ? (voids[other] >> suit) & 1 : !(position.hands[other] & rules.suitMask(suit));
+            if (isVoid)
+                active[count++] = uint16_t(VoidInput + (r - 1) * Rules::numSuits + suit);
+        }
+        if (position.isDeclarer(other))
+            active[count++] = uint16_t(PartnerInput + r - 1);
+    }
+
+    active[count++] = uint16_t(TypeInput + rules.type());
+    active[count++] = uint16_t(ColorInput + rules.color());
+    if (position.isDeclarer(player))
+        active[count++] = DeclarerTeamInput;
+    active[count++] = uint16_t(SeatInput + position.numInTrick);
+    active[count++] = uint16_t(SticheInput + std::min(position.numStiche(), Player::maxCards - 1));
+    return count;
+}
+
+NetEvaluator::Weights::Weights()
+    : w1(size_t(numInputs * hidden1)),
+      b1(size_t(hidden1)),
+      w2(size_t(hidden2 * hidden1)),
+      b2(size_t(hidden2)),
+      w3(size_t(hidden2)),
+      b3(0)
+{
+}
+
+float NetEvaluator::reference(const Weights& weights, const uint16_t *active, int numActive)
+{
+    float a1[hidden1];
+    for (int h = 0; h < hidden1; ++h) {
+        float sum = weights.b1[size_t(h)];
+        for (int i = 0; i < numActive; ++i)
+            sum += weights.w1[size_t(active[i] * hidden1 + h)];
+        a1[h] = std::min(1.0f, std::max(0.0f, sum));
+    }
+
+    float out = weights.b3;
+    for (int j = 0; j < hidden2; ++j) {
+        float sum = weights.b2[size_t(j)];
+        for (int h = 0; h < hidden1; ++h)
+            sum += weights.w2[size_t(j * hidden1 + h)] * a1[h];
+        out += weights.w3[size_t(j)] * std::min(1.0f, std::max(0.0f, sum));
+    }
+    return out * pointsScale;
+}
+
+NetEvaluator::NetEvaluator()
+    : m_w1(size_t(numInputs * hidden1)),
+      m_b1(size_t(hidden1)),
+      m_w2(size_t(hidden2 * hidden1)),
+      m_b2(size_t(hidden2)),
+      m_w3(size_t(hidden2)),
+      m_b3(0),
+      m_useAvx2(hasAvx2())
+{
+}
+
+void NetEvaluator::setUseAvx2(bool use)
+{
+    m_useAvx2 = use && hasAvx2();
+}
+
+template <typename T>
+static T quantize(float value, float scale, float limit)
+{
+    return T(std::lround(std::min(limit, std::max(-limit, value * scale))));
+}
+
+// The first layer is clipped to +-2. A position has at most 52 active
+// inputs (32 cards, 12 voids, 3 partners and 5 for contract, seat and
+// stiche), so with the bias the int16 sums stay within 53 * 254 < 32767;
+// with every input active they would not. The int8 weights hold up to
+// +-127 / 64.
+void NetEvaluator::setWeights(const Weights& weights)
+{
+    const float limit1 = 2.0f * activationScale;
+    for (size_t i = 0; i < m_w1.size(); ++i)
+        m_w1[i] = quantize<int16_t>(weights.w1[i], activationScale, limit1);
+    for (size_t i = 0; i < m_b1.size(); ++i)
+        m_b1[i] = quantize<int16_t>(weights.b1[i], activationScale, limit1);
+    for (size_t i = 0; i < m_w2.size(); ++i)
+        m_w2[i] = quantize<int8_t>(weights.w2[i], weightScale, 127);
+    for (size_t i = 0; i < m_b2.size(); ++i)
+        m_b2[i] = quantize<int32_t>(weights.b2[i], activationScale * weightScale, 1e9f);
+    for (size_t i = 0; i < m_w3.size(); ++i)
+        m_w3[i] = quantize<int8_t>(weights.w3[i], weightScale, 127);
+    m_b3 = quantize<int32_t>(weights.b3, activationScale * weightScale, 1e9f);
+}
+
+template <typename T>
+static bool readVector(std::ifstream& file, std::vector<T>& values)
+{
+    return bool(file.read(reinterpret_cast<char *>(values.data()), std::streamsize(values.size() * sizeof(T))));
+}
+
+template <typename T>
+static void writeVector(std::ofstream& file, const std::vector<T>& values)
+{
+    file.write(reinterpret_cast<const char *>(values.data()), std::streamsize(values.size() * sizeof(T)));
+}
+
+bool NetEvaluator::load(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, "SKNN", 4) != 0 || header.version != version || header.numInputs != uint32_t(numInputs)
+            || header.hidden1 != uint32_t(hidden1) || header.hidden2 != uint32_t(hidden2))
+        return false;
+
+    NetEvaluator loaded;
+    if (!readVector(file, loaded.m_w1) || !readVector(file, loaded.m_b1) || !readVector(file, loaded.m_w2)
+            || !readVector(file, loaded.m_b2) || !readVector(file, loaded.m_w3)
+            || !file.read(reinterpret_cast<char *>(&loaded.m_b3), sizeof(m_b3)))
+        return false;
+
+    // weights and biases beyond what setWeights() writes could overflow
+    // the int16 sums
+    for (const std::vector<int16_t> *values : { &loaded.m_w1, &loaded.m_b1 }) {
+        for (int16_t value : *values) {
+            if (std::abs(value) > 2 * activationScale)
+                return false;
+        }
+    }
+    m_w1.swap(loaded.m_w1);
+    m_b1.swap(loaded.m_b1);
+    m_w2.swap(loaded.m_w2);
+    m_b2.swap(loaded.m_b2);
+    m_w3.swap(loaded.m_w3);
+    m_b3 = loaded.m_b3;
+    return true;
+}
+
+bool NetEvaluator::write(const std::string& fileName) const
+{
+    Header header;
+    std::memcpy(header.magic, "SKNN", 4);
+    header.version = version;
+    header.numInputs = numInputs;
+    header.hidden1 = hidden1;
+    header.hidden2 = hidden2;
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeVector(file, m_w1);
+    writeVector(file, m_b1);
+    writeVector(file, m_w2);
+    writeVector(file, m_b2);
+    writeVector(file, m_w3);
+    file.write(reinterpret_cast<const char *>(&m_b3), sizeof(m_b3));
+    return bool(file);
+}
+
+static int32_t runScalar(const int16_t *w1, const int16_t *b1, const int8_t *w2, const int32_t *b2, const int8_t *w3,
+                         int32_t b3, const uint16_t *active, int numActive)
+{
+    constexpr int hidden1 = NetEvaluator::hidden1;
+    constexpr int hidden2 = NetEvaluator::hidden2;
+
+    int32_t sums[hidden1];
+    for (int h = 0; h < hidden1; ++h)
+        sums[h] = b1[h];
+    for (int i = 0; i < numActive; ++i) {
+        const int16_t *row = w1 + active[i] * hidden1;
+        for (int h = 0; h < hidden1; ++h)
+            sums[h] += row[h];
+    }
+    uint8_t a1[hidden1];
+    for (int h = 0; h < hidden1; ++h)
+        a1[h] = uint8_t(std::min(int32_t(NetEvaluator::activationScale), std::max(0, sums[h])));
+
+    int32_t out = b3;
+    for (int j = 0; j < hidden2; ++j) {
+        int32_t sum = b2[j];
+        for (int h = 0; h < hidden1; ++h)
+            sum += a1[h] * w2[j * hidden1 + h];
+        // back to the activation scale, the weights were scaled by 64
+        const int32_t a2 = std::min(int32_t(NetEvaluator::activationScale), std::max(0, sum >> 6));
+        out += a2 * w3[j];
+    }
+    return out;
+}
+
+#ifdef SCHAFKOPF_AVX2
+
+// the 8 sums of 8 vectors of 8 int32, in order
+__attribute__((target("avx2")))
+static inline __m256i sum8(const __m256i *v)
+{
+    const __m256i u0 = _mm256_hadd_epi32(_mm256_hadd_epi32(v[0], v[1]), _mm256_hadd_epi32(v[2], v[3]));
+    const __m256i u1 = _mm256_hadd_epi32(_mm256_hadd_epi32(v[4], v[5]), _mm256_hadd_epi32(v[6], v[7]));
+    return _mm256_add_epi32(_mm256_permute2x128_si256(u0, u1, 0x20), _mm256_permute2x128_si256(u0, u1, 0x31));
+}
+
+// The first layer in 4 registers of 16 int16, packed to 64 bytes; the
+// second layer with u8 x s8 products, where a pair is at most 2 * 127 *
+// 127 and does not saturate, 8 units at a time. Two such pairs would
+// overflow int16, so the halves are widened to int32 before they are added.
+__attribute__((target("avx2")))
+static int32_t runAvx2(const int16_t *w1, const int16_t *b1, const int8_t *w2, const int32_t *b2, const int8_t *w3,
+                       int32_t b3, const uint16_t *active, int numActive)
+{
+    constexpr int hidden1 = NetEvaluator::hidden1;
+    constexpr int hidden2 = NetEvaluator::hidden2;
+    static_assert(hidden1 == 64 && hidden2 % 8 == 0, "the kernel is written for 64 first layer units");
+
+    __m256i acc[4];
+    for (int k = 0; k < 4; ++k)
+        acc[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b1 + 16 * k));
+    for (int i = 0; i < numActive; ++i) {
+        const int16_t *row = w1 + active[i] * hidden1;
+        for (int k = 0; k < 4; ++k)
+            acc[k] = _mm256_add_epi16(acc[k], _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + 16 * k)));
+    }
+
+    // packing interleaves the 128 bit lanes, the permutation puts them back
+    const __m256i top = _mm256_set1_epi16(NetEvaluator::activationScale);
+    __m256i a1[2];
+    for (int k = 0; k < 2; ++k) {
+        const __m256i packed = _mm256_packus_epi16(_mm256_min_epi16(acc[2 * k], top), _mm256_min_epi16(acc[2 * k + 1], top));
+        a1[k] = _mm256_permute4x64_epi64(packed, 0xd8);
+    }
+
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top32 = _mm256_set1_epi32(NetEvaluator::activationScale);
+    __m256i out = _mm256_setzero_si256();
+    for (int j = 0; j < hidden2; j += 8) {
+        __m256i products[8];
+        for (int u = 0; u < 8; ++u) {
+            const int8_t *row = w2 + (j + u) * hidden1;
+            const __m256i low = _mm256_maddubs_epi16(a1[0], _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row)));
+            const __m256i high = _mm256_maddubs_epi16(a1[1], _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + 32)));
+            products[u] = _mm256_add_epi32(_mm256_madd_epi16(low, ones), _mm256_madd_epi16(high, ones));
+        }
+        __m256i sums = _mm256_add_epi32(sum8(products), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b2 + j)));
+        const __m256i a2 = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(sums, 6), zero), top32);
+        const __m256i weights = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(w3 + j)));
+        out = _mm256_add_epi32(out, _mm256_mullo_epi32(a2, weights));
+    }
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(out), _mm256_extracti128_si256(out, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    return b3 + _mm_cvtsi128_si32(sum);
+}
+
+#endif
+
+NetEvaluator::Kernel NetEvaluator::kernel() const
+{
+#ifdef SCHAFKOPF_AVX2
+    if (m_useAvx2)
+        return runAvx2;
+#endif
+    return runScalar;
+}
+
+float NetEvaluator::run(Kernel kernel, const uint16_t *active, int numActive) const
+{
+    const int32_t out = kernel(m_w1.data(), m_b1.data(), m_w2.data(), m_b2.data(), m_w3.data(), m_b3, active, numActive);
+    return float(out) * (pointsScale / (activationScale * weightScale));
+}
+
+float NetEvaluator::evaluate(const Position& position, const uint8_t *voids) const
+{
+    uint16_t active[maxActive];
+    const int numActive = inputs(position, voids, active);
+    return run(kernel(), active, numActive);
+}
+
+void NetEvaluator::evaluate(const Position *positions, size_t count, float *points) const
+{
+    const Kernel chosen = kernel();
+    uint16_t active[maxActive];
+    for (size_t i = 0; i < count; ++i)
+        points[i] = run(chosen, active, inputs(positions[i], nullptr, active));
+}
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Position.h"
+
+#include <string>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// Estimates what the declarer team takes from a position on, like
+// Solver::value with the Points measure, with a small neural network
+// instead of a search.
+//
+// The inputs are seen by the player to move: the own hand, the cards of
+// finished stiche and of the current stich, the suits the others are
+// known to be free of, the contract, the seat in the stich, the number of
+// finished stiche and who plays with the declarer. They are all 0 or 1,
+// so the first layer only adds up the weight rows of the active inputs.
+//
+// The network is inputs -> 64 -> 32 -> 1 with clipped ReLUs (to [0, 1])
+// and runs in integers: the first layer has int16 weights and activations
+// scaled by 127, the other layers int8 weights scaled by 64 and int32
+// sums. The AVX2 kernel and the scalar one compute exactly the same.
+class NetEvaluator
+{
+public:
+    static constexpr int numInputs = 137;
+    static constexpr int hidden1 = 64;
+    static constexpr int hidden2 = 32;
+
+    // input offsets
+    enum Input
+    {
+        HandInput = 0,
+        PlayedInput = HandInput + numCards,
+        TrickInput = PlayedInput + numCards,
+        // per other player (next, across, previous), per suit
+        VoidInput = TrickInput + numCards,
+        TypeInput = VoidInput + (numPlayers - 1) * Rules::numSuits,
+        ColorInput = TypeInput + numGameTypes,
+        DeclarerTeamInput = ColorInput + numColors,
+        // the others that play with the declarer, next, across, previous
+        PartnerInput = DeclarerTeamInput + 1,
+        SeatInput = PartnerInput + numPlayers - 1,
+        SticheInput = SeatInput + numPlayers,
+        endOfInputs = SticheInput + Player::maxCards
+    };
+
+    static_assert(endOfInputs == numInputs, "inputs do not add up");
+
+    static constexpr int maxActive = numInputs;
+
+    // The active inputs of position, returns how many. voids has a suit
+    // mask per player with what the player to move knows; without it,
+    // the actual hands tell, as for searches with all cards known.
+    static int inputs(const Position& position, const uint8_t *voids, uint16_t *active);
+
+    // float weights, as they are trained
+    struct Weights
+    {
+        Weights();
+
+        // row i of w1 are the weights of input i
+        std::vector<float> w1;
+        std::vector<float> b1;
+        // row i of w2 are the weights into unit i of the second layer
+        std::vector<float> w2;
+        std::vector<float> b2;
+        std::vector<float> w3;
+        float b3;
+    };
+
+    // the same network in floats, without quantization
+    static float reference(const Weights& weights, const uint16_t *active, int numActive);
+
+    // all weights 0 until there are some
+    NetEvaluator();
+
+    // quantizes weights, clipping them to what the integers hold
+    void setWeights(const Weights& weights);
+
+    bool load(const std::string& fileName);
+    bool write(const std::string& fileName) const;
+
+    float evaluate(const Position& position, const uint8_t *voids = nullptr) const;
+
+    // Scores count positions with all cards known in one call. The
+    // weights stay in the cache and the kernel is chosen once.
+    void evaluate(const Position *positions, size_t count, float *points) const;
+
+    // the AVX2 kernel is used where the CPU has it, this can turn it off
+    void setUseAvx2(bool use);
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numInputs;
+        uint32_t hidden1;
+        uint32_t hidden2;
+    };
+
+    static constexpr uint32_t version = 1;
+
+    // quantization scales
+    static constexpr int activationScale = 127;
+    static constexpr int weightScale = 64;
+    static constexpr float pointsScale = 120.0f;
+
+private:
+    using Kernel = int32_t (*)(const int16_t *w1, const int16_t *b1, const int8_t *w2, const int32_t *b2,
+                               const int8_t *w3, int32_t b3, const uint16_t *active, int numActive);
+
+    // the AVX2 or the scalar kernel, as setUseAvx2() says
+    Kernel kernel() const;
+    float run(Kernel kernel, const uint16_t *active, int numActive) const;
+
+    std::vector<int16_t> m_w1;
+    std::vector<int16_t> m_b1;
+    std::vector<int8_t> m_w2;
+    std::vector<int32_t> m_b2;
+    std::vector<int8_t> m_w3;
+    int32_t m_b3;
+    bool m_useAvx2;
+};
+
+}
@@ -0,0 +1,182 @@
+#include "NetTrainer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+namespace SchafKopf
+{
+
+// what the integers of NetEvaluator hold
+static constexpr float limit1 = 2.0f;
+static constexpr float limit2 = 127.0f / NetEvaluator::weightScale;
+
+NetTrainer::NetTrainer(uint32_t seed)
+    : m_engine(seed),
+      m_numThreads(1),
+      m_learningRate(0.01f),
+      m_syncInterval(1024)
+{
+    // units start out between 0 and 1, where the gradient passes
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    for (float& w : m_weights.w1)
+        w = 0.1f * uniform(m_engine);
+    std::fill(m_weights.b1.begin(), m_weights.b1.end(), 0.5f);
+    for (float& w : m_weights.w2)
+        w = 0.25f * uniform(m_engine);
+    std::fill(m_weights.b2.begin(), m_weights.b2.end(), 0.5f);
+    for (float& w : m_weights.w3)
+        w = 0.1f * uniform(m_engine);
+    m_weights.b3 = 0.5f;
+}
+
+float NetTrainer::step(NetEvaluator::Weights& weights, const Sample& sample, float rate)
+{
+    constexpr int hidden1 = NetEvaluator::hidden1;
+    constexpr int hidden2 = NetEvaluator::hidden2;
+
+    uint16_t active[NetEvaluator::maxActive];
+    const int numActive = NetEvaluator::inputs(sample.position(), nullptr, active);
+
+    float h1[hidden1];
+    float a1[hidden1];
+    std::copy(weights.b1.begin(), weights.b1.end(), h1);
+    for (int i = 0; i < numActive; ++i) {
+        const float *row = &weights.w1[size_t(active[i] * hidden1)];
+        for (int h = 0; h < hidden1; ++h)
+            h1[h] += row[h];
+    }
+    for (int h = 0; h < hidden1; ++h)
+        a1[h] = std::min(1.0f, std::max(0.0f, h1[h]));
+
+    float h2[hidden2];
+    float a2[hidden2];
+    float out = weights.b3;
+    for (int j = 0; j < hidden2; ++j) {
+        const float *row = &weights.w2[size_t(j * hidden1)];
+        float sum = weights.b2[size_t(j)];
+        for (int h = 0; h < hidden1; ++h)
+            sum += row[h] * a1[h];
+        h2[j] = sum;
+        a2[j] = std::min(1.0f, std::max(0.0f, sum));
+        out += weights.w3[size_t(j)] * a2[j];
+    }
+
+    const float diff = out - sample.points / NetEvaluator::pointsScale;
+
+    // the gradients of clipped units are 0 outside of (0, 1)
+    float d1[hidden1] = {};
+    for (int j = 0; j < hidden2; ++j) {
+        float& w3 = weights.w3[size_t(j)];
+        const float d2 = h2[j] > 0.0f && h2[j] < 1.0f ? diff * w3 : 0.0f;
+        w3 = std::min(limit2, std::max(-limit2, w3 - rate * diff * a2[j]));
+        if (d2 == 0.0f)
+            continue;
+        float *row = &weights.w2[size_t(j * hidden1)];
+        for (int h = 0; h < hidden1; ++h) {
+            d1[h] += d2 * row[h];
+            row[h] = std::min(limit2, std::max(-limit2, row[h] - rate * d2 * a1[h]));
+        }
+        weights.b2[size_t(j)] -= rate * d2;
+    }
+    weights.b3 -= rate * diff;
+
+    for (int h = 0; h < hidden1; ++h) {
+        d1[h] = h1[h] > 0.0f && h1[h] < 1.0f ? rate * d1[h] : 0.0f;
+        float& b1 = weights.b1[size_t(h)];
+        b1 = std::min(limit1, std::max(-limit1, b1 - d1[h]));
+    }
+    for (int i = 0; i < numActive; ++i) {
+        float *row = &weights.w1[size_t(active[i] * hidden1)];
+        for (int h = 0; h < hidden1; ++h)
+            row[h] = std::min(limit1, std::max(-limit1, row[h] - d1[h]));
+    }
+
+    const float error = diff * NetEvaluator::pointsScale;
+    return error * error;
+}
+
+static void average(std::vector<float>& target, const std::vector<NetEvaluator::Weights>& all,
+                    std::vector<float> NetEvaluator::Weights::*member)
+{
+    for (size_t i = 0; i < target.size(); ++i) {
+        float sum = 0;
+        for (const NetEvaluator::Weights& weights : all)
+            sum += (weights.*member)[i];
+        target[i] = sum / all.size();
+    }
+}
+
+double NetTrainer::epoch(const std::vector<Sample>& samples)
+{
+    std::vector<uint32_t> order(samples.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), m_engine);
+
+    double squared = 0;
+    if (m_numThreads == 1) {
+        for (uint32_t i : order)
+            squared += step(m_weights, samples[i], m_learningRate);
+        return std::sqrt(squared / std::max(size_t(1), samples.size()));
+    }
+
+    const size_t round = m_syncInterval * size_t(m_numThreads);
+    std::vector<NetEvaluator::Weights> local;
+    std::vector<double> errors;
+    for (size_t start = 0; start < order.size(); start += round) {
+        const size_t end = std::min(order.size(), start + round);
+        const int numThreads = int((end - start + m_syncInterval - 1) / m_syncInterval);
+        local.assign(size_t(numThreads), m_weights);
+        errors.assign(size_t(numThreads), 0.0);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                const size_t first = start + size_t(t) * m_syncInterval;
+                const size_t last = std::min(end, first + m_syncInterval);
+                for (size_t i = first; i < last; ++i)
+                    errors[size_t(t)] += step(local[size_t(t)], samples[order[i]], m_learningRate);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        average(m_weights.w1, local, &NetEvaluator::Weights::w1);
+        average(m_weights.b1, local, &NetEvaluator::Weights::b1);
+        average(m_weights.w2, local, &NetEvaluator::Weights::w2);
+        average(m_weights.b2, local, &NetEvaluator::Weights::b2);
+        average(m_weights.w3, local, &NetEvaluator::Weights::w3);
+        float b3 = 0;
+        for (const NetEvaluator::Weights& weights : local)
+            b3 += weights.b3;
+        m_weights.b3 = b3 / numThreads;
+        for (double error : errors)
+            squared += error;
+    }
+    return std::sqrt(squared / std::max(size_t(1), samples.size()));
+}
+
+double NetTrainer::error(const NetEvaluator::Weights& weights, const std::vector<Sample>& samples)
+{
+    uint16_t active[NetEvaluator::maxActive];
+    double squared = 0;
+    for (const Sample& sample : samples) {
+        const int numActive = NetEvaluator::inputs(sample.position(), nullptr, active);
+        const double error = NetEvaluator::reference(weights, active, numActive) - sample.points;
+        squared += error * error;
+    }
+    return std::sqrt(squared / std::max(size_t(1), samples.size()));
+}
+
+double NetTrainer::error(const NetEvaluator& evaluator, const std::vector<Sample>& samples)
+{
+    double squared = 0;
+    for (const Sample& sample : samples) {
+        const double error = evaluator.evaluate(sample.position()) - sample.points;
+        squared += error * error;
+    }
+    return std::sqrt(squared / std::max(size_t(1), samples.size()));
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "NetEvaluator.h"
+#include "TrainingData.h"
+
+#include <random>
+
+namespace SchafKopf
+{
+
+// Fits the weights of a NetEvaluator to samples with stochastic gradient
+// descent on the squared error of the points the declarer team takes,
+// with all cards known, as DepthSearch asks.
+//
+// With several threads every thread runs plain SGD on its own part of the
+// next syncInterval samples per thread, starting from the same weights,
+// and the weights are averaged after each round. No thread writes what
+// another one reads, so runs with the same seed and the same number of
+// threads give the same weights.
+//
+// Weights are clipped to what NetEvaluator::setWeights keeps after every
+// step.
+class NetTrainer
+{
+public:
+    explicit NetTrainer(uint32_t seed = 1);
+
+    const NetEvaluator::Weights& weights() const { return m_weights; }
+
+    void setNumThreads(int numThreads) { m_numThreads = std::max(1, numThreads); }
+    void setLearningRate(float rate) { m_learningRate = rate; }
+    void setSyncInterval(size_t samples) { m_syncInterval = std::max(size_t(1), samples); }
+
+    // One pass over samples in random order, returns the root mean
+    // squared error in points seen during the pass.
+    double epoch(const std::vector<Sample>& samples);
+
+    // the root mean squared error of weights on samples, in points
+    static double error(const NetEvaluator::Weights& weights, const std::vector<Sample>& samples);
+    // the same for the quantized network
+    static double error(const NetEvaluator& evaluator, const std::vector<Sample>& samples);
+
+private:
+    // one step on one sample, returns the squared error before the step
+    static float step(NetEvaluator::Weights& weights, const Sample& sample, float rate);
+
+    NetEvaluator::Weights m_weights;
+    std::minstd_rand m_engine;
+    int m_numThreads;
+    float m_learningRate;
+    size_t m_syncInterval;
+};
+
+}
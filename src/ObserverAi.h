@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Beliefs.h"
+#include "Rules.h"
 #include "Schafkopf.h"
 
 namespace SchafKopf
@@ -79,11 +81,10 @@ struct GameInfo
         trumpsLeft = trumpCount;
         colorsLeft[Eichel] = colorsLeft[Gras] = colorsLeft[Herz] = colorsLeft[Schelln] = colorCardCount;
 
-        // remove our cards from game info
-        for (const auto &card : player.m_cards) {
-            assert(card);
-            cardPlayed(*card);
-        }
+        // remove our cards from game info - as dealt, some might be played already
+        const Card *dealt = m_game.deck.begin() + player.id * Player::maxCards;
+        for (int i = 0; i < Player::maxCards; ++i)
+            cardPlayed(dealt[i]);
     }
 
     void cardPlayed(const Card& card)
@@ -109,7 +110,10 @@ public:
     ObserverAi(const Game& game, const Player& player)
         : m_player(player),
           m_game(game),
-          m_gameInfo(game, player)
+          m_gameInfo(game, player),
+          m_epoch(game.epoch),
+          m_cursor(0),
+          m_beliefsCursor(-1)
     {
         updatePlayerInfo();
     }
@@ -132,10 +136,31 @@ public:
         }
     }
 
-    void cardPlayed(const ActivePile& pile, int activePlayer) override
+    void cardPlayed(const ActivePile&, int) override
+    {
+        sync();
+    }
+
+    // reads the cards that were played since the last call from the
+    // history of the game - for lazy AIs, this is what updates the state
+    void sync()
+    {
+        // the game was dealt again without telling us, see Game::redeal
+        if (m_epoch != m_game.epoch)
+            reset();
+
+        const int numPlies = m_game.numPlies();
+        for (; m_cursor < numPlies; ++m_cursor) {
+            const int position = m_cursor % numPlayers;
+            observe(m_game.history.card(m_cursor), m_game.history.card(m_cursor - position),
+                    position, m_game.history.player(m_cursor));
+        }
+    }
+
+    // playedCard was played by activePlayer as card number position of a
+    // stich that started with firstPlayedCard
+    void observe(const Card& playedCard, const Card& firstPlayedCard, int position, int activePlayer)
     {
-        const Card &playedCard = pile.lastPlayedCard();
-        const Card &firstPlayedCard = pile.firstPlayedCard();
         const bool isTrump = m_game.isTrump(playedCard);
 
         if (activePlayer == m_player.id) {
@@ -149,7 +174,7 @@ public:
         if (!isTrump && m_gameInfo.colorsLeft[playedCard.color] == 0)
             setOthersColorFree(playedCard.color);
 
-        if (pile.numCards <= 1)
+        if (position == 0)
             return; // ### TODO - what assumptions can we make?
 
         // if a player didn't play according to the first card, he must be free of that type of card
@@ -162,8 +187,73 @@ public:
         }
     }
 
+    // the cards a player cannot have according to info
+    CardMask voidCards(const PlayerInfo& info) const
+    {
+        const Rules& rules = Rules::get(m_game.gameType, m_game.gameColor);
+        CardMask result = info.trumpFree == PlayerInfo::Yes ? rules.suitMask(Rules::trumpSuit) : 0;
+        for (int c = 0; c < numColors; ++c) {
+            if (info.colorFree[c] == PlayerInfo::Yes)
+                result |= rules.suitMask(c);
+        }
+        return result;
+    }
+
+    // the cards from the beliefs' cursor up to the cursor, with the
+    // voids observe() learned from them
+    void updateBeliefs() const
+    {
+        bool othersPlayed = false;
+        for (; m_beliefsCursor < m_cursor; ++m_beliefsCursor) {
+            const int activePlayer = m_game.history.player(m_beliefsCursor);
+            m_beliefs.cardPlayed(activePlayer, cardIndex(m_game.history.card(m_beliefsCursor)));
+            othersPlayed |= activePlayer != m_player.id;
+        }
+        if (!othersPlayed)
+            return;
+        for (int i = 0; i < numPlayers; ++i)
+            m_beliefs.exclude(i, voidCards(m_playerInfo[i]));
+        m_beliefs.update();
+    }
+
+    // the beliefs from scratch, for the cards up to the cursor
+    void resetBeliefs() const
+    {
+        CardMask hidden = allCards;
+        const Card *dealt = m_game.deck.begin() + m_player.id * Player::maxCards;
+        for (int i = 0; i < Player::maxCards; ++i)
+            hidden &= ~cardBit(dealt[i]);
+
+        int handSizes[numPlayers] = { Player::maxCards, Player::maxCards, Player::maxCards, Player::maxCards };
+        for (int i = 0; i < m_cursor; ++i) {
+            hidden &= ~cardBit(m_game.history.card(i));
+            --handSizes[m_game.history.player(i)];
+        }
+        m_beliefs.reset(m_player.id, hidden, handSizes);
+        m_beliefsCursor = m_cursor;
+        if (!m_cursor)
+            return;
+        for (int i = 0; i < numPlayers; ++i)
+            m_beliefs.exclude(i, voidCards(m_playerInfo[i]));
+        m_beliefs.update();
+    }
+
+    // Where the cards the AI cannot see are, up to date after sync().
+    // Only AIs that ask pay for them: they are brought up to the cursor
+    // here, not on every observed card.
+    const Beliefs& beliefs() const
+    {
+        if (m_beliefsCursor < 0)
+            resetBeliefs();
+        else
+            updateBeliefs();
+        return m_beliefs;
+    }
+
     int suggestCard(const ActivePile& pile)
     {
+        sync();
+
         struct RemainingCards
         {
             Card card;
@@ -221,12 +311,52 @@ public:
         }
     }
 
+    // everything the AI learned, without the references to the game. A
+    // restored state is taken to be about the current deal and all played
+    // cards of the AI's game, so it is not reset lazily, see Game::redeal.
+    struct State
+    {
+        int trumpCount;
+        int colorCardCount;
+        int trumpsLeft;
+        int colorsLeft[numColors];
+        PlayerInfo playerInfo[numPlayers];
+    };
+
+    void snapshot(Snapshot& snapshot) const override
+    {
+        State state;
+        state.trumpCount = m_gameInfo.trumpCount;
+        state.colorCardCount = m_gameInfo.colorCardCount;
+        state.trumpsLeft = m_gameInfo.trumpsLeft;
+        std::copy(m_gameInfo.colorsLeft, m_gameInfo.colorsLeft + numColors, state.colorsLeft);
+        std::copy(m_playerInfo, m_playerInfo + numPlayers, state.playerInfo);
+        storeState(snapshot, state);
+    }
+
+    void restore(const Snapshot& snapshot) override
+    {
+        State state;
+        loadState(snapshot, state);
+        m_gameInfo.trumpCount = state.trumpCount;
+        m_gameInfo.colorCardCount = state.colorCardCount;
+        m_gameInfo.trumpsLeft = state.trumpsLeft;
+        std::copy(state.colorsLeft, state.colorsLeft + numColors, m_gameInfo.colorsLeft);
+        std::copy(state.playerInfo, state.playerInfo + numPlayers, m_playerInfo);
+        m_epoch = m_game.epoch;
+        m_cursor = m_game.numPlies();
+        m_beliefsCursor = -1;
+    }
+
     void reset() override
     {
+        m_epoch = m_game.epoch;
+        m_cursor = 0;
         m_gameInfo.reset(m_player);
         for (PlayerInfo& playerInfo : m_playerInfo)
             playerInfo.reset();
         updatePlayerInfo();
+        m_beliefsCursor = -1;
     }
 
     const Player& m_player;
@@ -234,6 +364,16 @@ public:
 
     GameInfo m_gameInfo;
     PlayerInfo m_playerInfo[4];
+    // not part of State, restore() builds them again from what it restored
+    mutable Beliefs m_beliefs;
+
+    // the deal of the game the state is for
+    uint32_t m_epoch;
+    // the next card in the history of the game to look at
+    int m_cursor;
+    // the same for the beliefs, which beliefs() brings up to the cursor;
+    // -1 if they have to be built from scratch
+    mutable int m_beliefsCursor;
 };
 
 }
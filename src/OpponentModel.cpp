@@ -0,0 +1,189 @@
+#include "OpponentModel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace SchafKopf
+{
+
+// the trick key of the card that takes the current stich so far, and its position
+static int bestInTrick(const Position& position, int& winner)
+{
+    const Rules& rules = *position.rules;
+    const int leadSuit = rules.suit(position.trick[0]);
+    int best = rules.trickKey(leadSuit, position.trick[0]);
+    winner = 0;
+    for (int i = 1; i < position.numInTrick; ++i) {
+        const int key = rules.trickKey(leadSuit, position.trick[i]);
+        if (key > best) {
+            best = key;
+            winner = i;
+        }
+    }
+    return best;
+}
+
+int OpponentModel::context(const Position& position)
+{
+    const Rules& rules = *position.rules;
+    const int player = position.toMove();
+    const CardMask hand = position.hands[player];
+
+    int lead = Leading;
+    int ownTeamTakes = 0;
+    if (position.numInTrick) {
+        const int leadSuit = rules.suit(position.trick[0]);
+        if (!(hand & rules.suitMask(leadSuit)))
+            lead = CannotFollow;
+        else
+            lead = leadSuit == Rules::trumpSuit ? TrumpFollowed : ColorFollowed;
+        int winner;
+        bestInTrick(position, winner);
+        ownTeamTakes = position.isDeclarer((position.leader + winner) & (numPlayers - 1)) == position.isDeclarer(player);
+    }
+
+    int result = position.numInTrick;
+    result = result * numLeads + lead;
+    result = result * 2 + ownTeamTakes;
+    result = result * Player::maxCards + position.numStiche();
+    result = result * numTrumpBuckets + std::min(popCount(hand & rules.trumps()), numTrumpBuckets - 1);
+    return result * 2 + position.isDeclarer(player);
+}
+
+int OpponentModel::cardClasses(const Position& position, CardMask moves, uint8_t *classes)
+{
+    const Rules& rules = *position.rules;
+    int leadSuit = 0;
+    int best = 0x100;
+    if (position.numInTrick) {
+        int winner;
+        leadSuit = rules.suit(position.trick[0]);
+        best = bestInTrick(position, winner);
+    }
+
+    int count = 0;
+    for (; moves; moves &= moves - 1) {
+        const int card = lowestCard(moves);
+        const int takes = rules.trickKey(leadSuit, card) > best;
+        classes[count++] = uint8_t((takes * 2 + rules.isTrump(card)) * numCardTypes + (card % numCardTypes));
+    }
+    return count;
+}
+
+OpponentModel::OpponentModel()
+    : m_rates(size_t(numContexts * numClasses), 0x8000)
+{
+}
+
+double OpponentModel::probability(const Position& position, int card) const
+{
+    const CardMask moves = position.legalMoves();
+    if (!((moves >> card) & 1))
+        return 0.0;
+
+    uint8_t classes[Player::maxCards];
+    const int count = cardClasses(position, moves, classes);
+    const uint16_t *rates = &m_rates[size_t(context(position) * numClasses)];
+    uint32_t sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += rates[classes[i]];
+    return double(rates[classes[popCount(moves & (cardBit(card) - 1))]]) / sum;
+}
+
+bool OpponentModel::load(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, "SKOM", 4) != 0 || header.version != version
+            || header.numContexts != uint32_t(numContexts) || header.numClasses != uint32_t(numClasses))
+        return false;
+
+    std::vector<uint16_t> rates(m_rates.size());
+    if (!file.read(reinterpret_cast<char *>(rates.data()), std::streamsize(rates.size() * sizeof(uint16_t))))
+        return false;
+    // a rate of 0 would rule out a legal card, and could leave no card at all
+    if (std::find(rates.begin(), rates.end(), 0) != rates.end())
+        return false;
+    m_rates.swap(rates);
+    return true;
+}
+
+bool OpponentModel::write(const std::string& fileName) const
+{
+    Header header;
+    std::memcpy(header.magic, "SKOM", 4);
+    header.version = version;
+    header.numContexts = numContexts;
+    header.numClasses = numClasses;
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(m_rates.data()), std::streamsize(m_rates.size() * sizeof(uint16_t)));
+    return bool(file);
+}
+
+PlayCounts::PlayCounts(int numShards)
+    : m_numShards(numShards),
+      m_counters(new Counter[size_t(numShards) * OpponentModel::numContexts * OpponentModel::numClasses]())
+{
+}
+
+bool PlayCounts::add(const GameRecord& record, int shard, int players)
+{
+    Deal deal;
+    if (!record.deal(deal))
+        return false;
+
+    Position position = record.start();
+    for (int i = 0; i < numCards; ++i) {
+        if ((players >> position.toMove()) & 1)
+            count(position, record.cards[i], shard);
+        position.play(record.cards[i]);
+    }
+    return true;
+}
+
+void PlayCounts::count(const Position& position, int card, int shard)
+{
+    const CardMask moves = position.legalMoves();
+    uint8_t classes[Player::maxCards];
+    const int numMoves = OpponentModel::cardClasses(position, moves, classes);
+    const int context = OpponentModel::context(position);
+
+    for (int i = 0; i < numMoves; ++i)
+        counter(shard, context, classes[i]).offered.fetch_add(1, std::memory_order_relaxed);
+    counter(shard, context, classes[popCount(moves & (cardBit(card) - 1))]).chosen.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t PlayCounts::chosen(int context, int cardClass) const
+{
+    uint64_t result = 0;
+    for (int shard = 0; shard < m_numShards; ++shard)
+        result += counter(shard, context, cardClass).chosen.load(std::memory_order_relaxed);
+    return result;
+}
+
+uint64_t PlayCounts::offered(int context, int cardClass) const
+{
+    uint64_t result = 0;
+    for (int shard = 0; shard < m_numShards; ++shard)
+        result += counter(shard, context, cardClass).offered.load(std::memory_order_relaxed);
+    return result;
+}
+
+OpponentModel PlayCounts::model() const
+{
+    OpponentModel result;
+    for (int context = 0; context < OpponentModel::numContexts; ++context) {
+        for (int cardClass = 0; cardClass < OpponentModel::numClasses; ++cardClass) {
+            const double rate = double(chosen(context, cardClass) + 1) / double(offered(context, cardClass) + 2);
+            result.setRate(context, cardClass, uint16_t(std::max(1.0, rate * 0xffff + 0.5)));
+        }
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "GameLog.h"
+#include "PlayModel.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// How the players at a table choose their cards, fit from recorded games.
+//
+// Plays are told apart by their context: the seat in the stich, what was
+// led and whether the player can follow, whether the player's team takes
+// the stich so far, the stich number, the number of trumps in hand (0, 1,
+// 2 or more than 2) and whether the player is with the declarer. Within a
+// context the cards fall into classes: trump or not, the card type and
+// whether the card would take the stich so far.
+//
+// For every context and class the model keeps the rate at which a card
+// of that class was played when it could have been. A card is played
+// with a probability in proportion to the rate of its class, among the
+// legal cards, so a query is a table lookup per legal card.
+class OpponentModel : public PlayModel
+{
+public:
+    enum Lead
+    {
+        Leading,
+        TrumpFollowed,
+        ColorFollowed,
+        CannotFollow,
+        numLeads
+    };
+
+    static constexpr int numTrumpBuckets = 4;
+    static constexpr int numContexts = numPlayers * numLeads * 2 * Player::maxCards * numTrumpBuckets * 2;
+    static constexpr int numClasses = 2 * 2 * numCardTypes;
+
+    static int context(const Position& position);
+
+    // the classes of the legal moves of position, classes[i] for the i-th lowest card
+    static int cardClasses(const Position& position, CardMask moves, uint8_t *classes);
+
+    // every card is as likely as any other until load() succeeds
+    OpponentModel();
+
+    bool load(const std::string& fileName);
+    bool write(const std::string& fileName) const;
+
+    double probability(const Position& position, int card) const override;
+
+    // the play rate of a class in a context, scaled to 0xffff
+    uint16_t rate(int context, int cardClass) const { return m_rates[size_t(context * numClasses + cardClass)]; }
+    void setRate(int context, int cardClass, uint16_t rate) { m_rates[size_t(context * numClasses + cardClass)] = rate; }
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numContexts;
+        uint32_t numClasses;
+    };
+
+    static constexpr uint32_t version = 1;
+
+private:
+    std::vector<uint16_t> m_rates;
+};
+
+// What players chose and what they could have chosen, per context and
+// class, counted from recorded games by any number of threads at once.
+//
+// Each thread counts into a shard of its own with relaxed atomic adds, so
+// threads neither lock nor share cache lines; threads may share a shard
+// as well, they only slow each other down. The shards are summed up when
+// the model is made.
+class PlayCounts
+{
+public:
+    explicit PlayCounts(int numShards = 1);
+
+    int numShards() const { return m_numShards; }
+
+    // Counts the plays of the players in the mask players, false if the
+    // record is no valid game. Then nothing is counted.
+    bool add(const GameRecord& record, int shard, int players = 0xf);
+
+    // the player to move in position played card
+    void count(const Position& position, int card, int shard);
+
+    // summed over all shards
+    uint64_t chosen(int context, int cardClass) const;
+    uint64_t offered(int context, int cardClass) const;
+
+    // rates with one play and one pass added to every count, so classes
+    // that were never seen get the rate 1/2
+    OpponentModel model() const;
+
+private:
+    struct Counter
+    {
+        std::atomic<uint32_t> chosen;
+        std::atomic<uint32_t> offered;
+    };
+
+    Counter& counter(int shard, int context, int cardClass) const
+    {
+        return m_counters[(size_t(shard) * OpponentModel::numContexts + size_t(context)) * OpponentModel::numClasses
+                + size_t(cardClass)];
+    }
+
+    int m_numShards;
+    std::unique_ptr<Counter[]> m_counters;
+};
+
+}
@@ -0,0 +1,112 @@
+#include "ParallelSolver.h"
+
+#include <thread>
+
+namespace SchafKopf
+{
+
+ParallelSolver::ParallelSolver(int numThreads, Solver::Measure measure, int tableBits)
+    : m_table(tableBits),
+      m_stop(false),
+      m_deterministic(false)
+{
+    assert(numThreads > 0);
+    for (int i = 0; i < numThreads; ++i) {
+        // the solvers only use the shared table
+        m_solvers.emplace_back(new Solver(measure, 0));
+        m_solvers.back()->setSharedTable(&m_table);
+        m_solvers.back()->setStop(&m_stop);
+        // spread the first cards of the helpers over the deck
+        m_solvers.back()->setFirstCard(i * numCards / numThreads);
+    }
+}
+
+template <typename Job>
+void ParallelSolver::run(Job job)
+{
+    m_stop = false;
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < numThreads(); ++i)
+        helpers.emplace_back([this, &job, i]() { job(i, *m_solvers[size_t(i)]); });
+    job(0, *m_solvers[0]);
+    for (std::thread& helper : helpers)
+        helper.join();
+}
+
+bool ParallelSolver::reaches(const Position& position, int threshold)
+{
+    std::atomic<int> result(-1);
+    run([&](int, Solver& solver) {
+        const bool reached = solver.reaches(position, threshold);
+        if (solver.aborted())
+            return;
+        int none = -1;
+        result.compare_exchange_strong(none, reached);
+        m_stop = true;
+    });
+    return result == 1;
+}
+
+int ParallelSolver::value(const Position& position)
+{
+    std::atomic<int> result(-1);
+    run([&](int index, Solver& solver) {
+        // the helpers approach the value from different sides
+        const int guess = index ? solver.remaining(position) * index / numThreads() : -1;
+        const int value = solver.value(position, guess);
+        if (solver.aborted())
+            return;
+        int none = -1;
+        result.compare_exchange_strong(none, value);
+        m_stop = true;
+    });
+    return result;
+}
+
+int ParallelSolver::bestMove(const Position& position)
+{
+    const int total = m_solvers[0]->won(position) + value(position);
+    const bool maximize = position.isDeclarer(position.toMove());
+
+    uint8_t cards[Player::maxCards];
+    int numMoves = 0;
+    for (CardMask moves = position.legalMoves(); moves; moves &= moves - 1)
+        cards[numMoves++] = uint8_t(lowestCard(moves));
+
+    std::atomic<int> next(0);
+    std::atomic<int> found(numCards);
+    run([&](int, Solver& solver) {
+        for (int i = next++; i < numMoves; i = next++) {
+            // the cards are handed out in order, later ones cannot be lower
+            if (cards[i] > found)
+                return;
+
+            Position child = position;
+            child.play(cards[i]);
+            // the declarer team keeps total, the defenders keep it from getting more
+            const bool reached = solver.reaches(child, maximize ? total : total + 1);
+            if (solver.aborted())
+                return;
+            if (reached != maximize)
+                continue;
+
+            int lowest = found;
+            while (cards[i] < lowest && !found.compare_exchange_weak(lowest, cards[i])) {}
+            if (!m_deterministic)
+                m_stop = true;
+        }
+    });
+
+    assert(found < numCards);
+    return found;
+}
+
+uint64_t ParallelSolver::nodes() const
+{
+    uint64_t result = 0;
+    for (const auto& solver : m_solvers)
+        result += solver->nodes();
+    return result;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Solver.h"
+
+namespace SchafKopf
+{
+
+// Solves a single position with several threads, for analysis where one
+// position has to be answered as fast as possible.
+//
+// All threads search the same root, each with its own Solver but with one
+// SharedTable (lazy SMP): the helpers try moves in other orders and start
+// MTD(f) at other guesses, and what they store cuts off the searches of
+// the others. The first thread to finish answers and stops the rest.
+class ParallelSolver
+{
+public:
+    explicit ParallelSolver(int numThreads, Solver::Measure measure = Solver::Points, int tableBits = 22);
+
+    int numThreads() const { return int(m_solvers.size()); }
+    Solver::Measure measure() const { return m_solvers[0]->measure(); }
+
+    // see Solver
+    bool reaches(const Position& position, int threshold);
+    int value(const Position& position);
+
+    // A legal card for the player to move that keeps value(position). The
+    // threads check the cards one by one. In deterministic mode this is the
+    // lowest such card, whatever the number and timing of the threads,
+    // otherwise the first card a thread finds.
+    int bestMove(const Position& position);
+
+    void setDeterministic(bool deterministic) { m_deterministic = deterministic; }
+    bool isDeterministic() const { return m_deterministic; }
+
+    void clear() { m_table.clear(); }
+
+    // searched positions of all threads
+    uint64_t nodes() const;
+
+private:
+    // runs job(index, solver) on all threads, the first one on this thread
+    template <typename Job>
+    void run(Job job);
+
+    SharedTable m_table;
+    std::vector<std::unique_ptr<Solver>> m_solvers;
+    std::atomic<bool> m_stop;
+    bool m_deterministic;
+};
+
+}
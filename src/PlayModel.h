@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Position.h"
+
+#include <cmath>
+
+namespace SchafKopf
+{
+
+// How likely a player is to play a card, for weighting imagined deals by
+// how well they explain the cards the others actually played.
+class PlayModel
+{
+public:
+    virtual ~PlayModel() {}
+
+    // the probability that the player to move in position plays card,
+    // 0 for cards that are not legal
+    virtual double probability(const Position& position, int card) const = 0;
+};
+
+// Every legal card is as likely as any other, which gives all consistent
+// deals the same weight.
+class UniformPlayModel : public PlayModel
+{
+public:
+    double probability(const Position& position, int card) const override
+    {
+        const CardMask moves = position.legalMoves();
+        return (moves >> card) & 1 ? 1.0 / popCount(moves) : 0.0;
+    }
+};
+
+// Players keep their points away from stiche the other team takes and
+// smear them into stiche their own team takes: the chance of a card grows
+// or shrinks exponentially with its points, by sharpness per point. A
+// share epsilon is spread evenly over all legal cards, so no play is
+// ruled out completely. Leads carry no information in this model.
+class SmearPlayModel : public PlayModel
+{
+public:
+    explicit SmearPlayModel(double sharpness = 0.3, double epsilon = 0.1)
+        : m_sharpness(sharpness),
+          m_epsilon(epsilon)
+    {}
+
+    double probability(const Position& position, int card) const override
+    {
+        const CardMask moves = position.legalMoves();
+        if (!((moves >> card) & 1))
+            return 0.0;
+        const int numMoves = popCount(moves);
+        if (position.numInTrick == 0)
+            return 1.0 / numMoves;
+
+        // who takes the stich so far
+        const Rules& rules = *position.rules;
+        const int leadSuit = rules.suit(position.trick[0]);
+        int winner = 0;
+        for (int i = 1; i < position.numInTrick; ++i) {
+            if (rules.trickKey(leadSuit, position.trick[i]) > rules.trickKey(leadSuit, position.trick[winner]))
+                winner = i;
+        }
+        const int player = position.toMove();
+        const bool ownTeam = position.isDeclarer((position.leader + winner) & (numPlayers - 1)) == position.isDeclarer(player);
+        const double sign = ownTeam ? m_sharpness : -m_sharpness;
+
+        double sum = 0;
+        for (CardMask rest = moves; rest; rest &= rest - 1)
+            sum += std::exp(sign * maskPoints(lowestBit(rest)));
+        const double preferred = std::exp(sign * maskPoints(cardBit(card))) / sum;
+        return (1 - m_epsilon) * preferred + m_epsilon / numMoves;
+    }
+
+private:
+    double m_sharpness;
+    double m_epsilon;
+};
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Rules.h"
+
+namespace SchafKopf
+{
+
+struct Deal
+{
+    CardMask hands[numPlayers];
+};
+
+// A game with all cards known, working on card masks only. It is cheap to
+// copy, so searches and rollouts just copy it instead of undoing moves.
+struct Position
+{
+    Position() {}
+
+    Position(const Rules& rules, const Deal& deal, int declarer, int leader)
+        : rules(&rules),
+          played(0),
+          leader(uint8_t(leader)),
+          numInTrick(0),
+          declarerTeam(uint8_t(SchafKopf::declarerTeam(rules.type(), rules.color(), declarer, deal.hands)))
+    {
+        for (int i = 0; i < numPlayers; ++i) {
+            hands[i] = deal.hands[i];
+            won[i] = 0;
+        }
+    }
+
+    // the current state of a running game
+    static Position fromGame(const Game& game, const Rules& rules);
+
+    int toMove() const
+    {
+        return (leader + numInTrick) & (numPlayers - 1);
+    }
+
+    bool isDeclarer(int player) const
+    {
+        return (declarerTeam >> player) & 1;
+    }
+
+    bool finished() const
+    {
+        return played == allCards;
+    }
+
+    int numStiche() const
+    {
+        return popCount(played) / numPlayers;
+    }
+
+    // cards that are in the current, unfinished stich
+    CardMask trickMask() const
+    {
+        CardMask result = 0;
+        for (int i = 0; i < numInTrick; ++i)
+            result |= cardBit(trick[i]);
+        return result;
+    }
+
+    CardMask legalMoves() const
+    {
+        const CardMask hand = hands[toMove()];
+        return numInTrick ? rules->legalMoves(hand, trick[0]) : hand;
+    }
+
+    CardMask teamWon(int team) const
+    {
+        CardMask result = 0;
+        for (int i = 0; i < numPlayers; ++i) {
+            if (((team >> i) & 1))
+                result |= won[i];
+        }
+        return result;
+    }
+
+    int declarerPoints() const
+    {
+        return maskPoints(teamWon(declarerTeam));
+    }
+
+    // the active player plays card, which must be one of legalMoves()
+    void play(int card)
+    {
+        assert(legalMoves() & cardBit(card));
+
+        hands[toMove()] &= ~cardBit(card);
+        trick[numInTrick++] = uint8_t(card);
+
+        if (numInTrick == numPlayers) {
+            const int winner = (leader + rules->trickWinner(trick)) & (numPlayers - 1);
+            const CardMask stich = trickMask();
+            won[winner] |= stich;
+            played |= stich;
+            leader = uint8_t(winner);
+            numInTrick = 0;
+        }
+    }
+
+    const Rules* rules;
+
+    CardMask hands[numPlayers];
+    // cards each player took in finished stiche
+    CardMask won[numPlayers];
+    // all cards of finished stiche
+    CardMask played;
+
+    uint8_t trick[numPlayers];
+    uint8_t leader;
+    uint8_t numInTrick;
+
+    // bit i is set if player i plays with the declarer
+    uint8_t declarerTeam;
+};
+
+inline Position Position::fromGame(const Game& game, const Rules& rules)
+{
+    assert(rules.type() == game.gameType);
+
+    Position result;
+    result.rules = &rules;
+    result.played = 0;
+    for (int i = 0; i < numPlayers; ++i) {
+        result.hands[i] = handMask(game.players[i]);
+        result.won[i] = game.players[i].wonCards;
+        result.played |= result.won[i];
+    }
+
+    result.numInTrick = uint8_t(game.activePile.numCards);
+    result.leader = uint8_t(result.numInTrick ? game.activePile.firstPlayer : int(game.m_activePlayer));
+    for (int i = 0; i < result.numInTrick; ++i)
+        result.trick[i] = uint8_t(cardIndex(*game.activePile.m_cards[i]));
+
+    // the team is known from the cards as they were dealt
+    Deal dealt;
+    for (int i = 0; i < numPlayers; ++i) {
+        dealt.hands[i] = 0;
+        for (int j = 0; j < Player::maxCards; ++j)
+            dealt.hands[i] |= cardBit(game.deck.cards[i * Player::maxCards + j]);
+    }
+    result.declarerTeam = uint8_t(SchafKopf::declarerTeam(game.gameType, game.gameColor, game.declarer, dealt.hands));
+
+    return result;
+}
+
+}
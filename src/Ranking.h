@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Position.h"
+
+#include <algorithm>
+#include <random>
+
+namespace SchafKopf
+{
+
+// Dense indices for hands and deals.
+//
+// A hand of 8 cards gets its rank in the combinatorial number system
+// (colex order), in [0, numHandRanks). A deal ranks the first three hands
+// among the cards that are left for them, the fourth hand is what remains.
+// There are 32! / 8!^4 deals, that is less than 2^57, so a deal fits
+// into 8 bytes.
+
+constexpr uint32_t numHandRanks = 10518300;              // C(32, 8)
+constexpr uint64_t numDealRanks = 99561092450391000ull;  // 32! / 8!^4
+
+namespace Detail
+{
+
+// binomial coefficients C(n, k) for n <= 32 and k <= 8
+inline const uint32_t (&binomials())[numCards + 1][Player::maxCards + 1]
+{
+    static const struct Table
+    {
+        Table()
+        {
+            for (int n = 0; n <= numCards; ++n) {
+                values[n][0] = 1;
+                for (int k = 1; k <= Player::maxCards; ++k)
+                    values[n][k] = n == 0 ? 0 : values[n - 1][k - 1] + values[n - 1][k];
+            }
+        }
+        uint32_t values[numCards + 1][Player::maxCards + 1];
+    } table;
+    return table.values;
+}
+
+// colex rank of a set of cards among all sets of the same size
+inline uint32_t subsetRank(CardMask mask)
+{
+    const auto& binomial = binomials();
+    uint32_t result = 0;
+    for (int i = 1; mask; ++i) {
+        result += binomial[lowestCard(mask)][i];
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+// the set of count cards below limit with that rank
+inline CardMask subsetFromRank(uint32_t rank, int count, int limit)
+{
+    const auto& binomial = binomials();
+    CardMask result = 0;
+    int card = limit - 1;
+    for (int i = count; i > 0; --i) {
+        while (binomial[card][i] > rank)
+            --card;
+        rank -= binomial[card][i];
+        result |= cardBit(card);
+        --card;
+    }
+    return result;
+}
+
+// the cards of mask, renumbered to their index within the cards of universe
+inline CardMask compress(CardMask mask, CardMask universe)
+{
+    CardMask result = 0;
+    for (; mask; mask &= mask - 1)
+        result |= cardBit(popCount(universe & (lowestBit(mask) - 1)));
+    return result;
+}
+
+// reverse of compress
+inline CardMask expand(CardMask mask, CardMask universe)
+{
+    CardMask result = 0;
+    for (; mask; mask &= mask - 1)
+        result |= cardBit(nthCard(universe, lowestCard(mask)));
+    return result;
+}
+
+}
+
+inline uint32_t handRank(CardMask hand)
+{
+    assert(popCount(hand) == Player::maxCards);
+    return Detail::subsetRank(hand);
+}
+
+inline CardMask handFromRank(uint32_t rank)
+{
+    assert(rank < numHandRanks);
+    return Detail::subsetFromRank(rank, Player::maxCards, numCards);
+}
+
+inline uint64_t dealRank(const Deal& deal)
+{
+    const auto& binomial = Detail::binomials();
+
+    uint64_t result = 0;
+    CardMask left = allCards;
+    for (int i = 0; i < numPlayers - 1; ++i) {
+        assert((deal.hands[i] & left) == deal.hands[i]);
+        const int numLeft = popCount(left);
+        result = result * binomial[numLeft][Player::maxCards]
+                + Detail::subsetRank(Detail::compress(deal.hands[i], left));
+        left &= ~deal.hands[i];
+    }
+    return result;
+}
+
+inline Deal dealFromRank(uint64_t rank)
+{
+    assert(rank < numDealRanks);
+    const auto& binomial = Detail::binomials();
+
+    // the rank of the first hand is the most significant digit
+    uint32_t ranks[numPlayers - 1];
+    for (int i = numPlayers - 2; i >= 0; --i) {
+        const uint32_t base = binomial[numCards - i * Player::maxCards][Player::maxCards];
+        ranks[i] = uint32_t(rank % base);
+        rank /= base;
+    }
+
+    Deal result;
+    CardMask left = allCards;
+    for (int i = 0; i < numPlayers - 1; ++i) {
+        const int numLeft = popCount(left);
+        result.hands[i] = Detail::expand(Detail::subsetFromRank(ranks[i], Player::maxCards, numLeft), left);
+        left &= ~result.hands[i];
+    }
+    result.hands[numPlayers - 1] = left;
+    return result;
+}
+
+// a uniformly distributed deal
+template <typename Engine>
+inline Deal randomDeal(Engine& engine)
+{
+    std::uniform_int_distribution<uint64_t> distribution(0, numDealRanks - 1);
+    return dealFromRank(distribution(engine));
+}
+
+// The hands of position as player might imagine them: player's own hand
+// stays, the cards of the others are dealt again at random and every hand
+// keeps its size. Nothing the play revealed, like a player that could not
+// follow suit, is taken into account.
+template <typename Engine>
+inline Deal randomWorld(const Position& position, int player, Engine& engine)
+{
+    uint8_t hidden[numCards];
+    int numHidden = 0;
+    for (int p = 0; p < numPlayers; ++p) {
+        if (p == player)
+            continue;
+        for (CardMask hand = position.hands[p]; hand; hand &= hand - 1)
+            hidden[numHidden++] = uint8_t(lowestCard(hand));
+    }
+    std::shuffle(hidden, hidden + numHidden, engine);
+
+    Deal result;
+    for (int p = 0, next = 0; p < numPlayers; ++p) {
+        if (p == player) {
+            result.hands[p] = position.hands[p];
+            continue;
+        }
+        result.hands[p] = 0;
+        for (int i = popCount(position.hands[p]); i > 0; --i)
+            result.hands[p] |= cardBit(hidden[next++]);
+    }
+    return result;
+}
+
+}
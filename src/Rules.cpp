@@ -0,0 +1,157 @@
+#include "Rules.h"
+#include "Cpu.h"
+
+#include <vector>
+
+namespace SchafKopf
+{
+
+Rules::Rules(Game::Type type, Color color)
+    : m_type(type),
+      m_color(color),
+      m_trumps(0),
+      m_numTrumps(0)
+{
+    for (int i = 0; i < numCards; ++i) {
+        if (!Game::isTrump(type, color, cardAt(i)))
+            continue;
+        m_trumps |= cardBit(i);
+        m_trumpOrder[m_numTrumps++] = uint8_t(i);
+    }
+    assert(m_numTrumps <= maxTrumps);
+
+    std::sort(m_trumpOrder, m_trumpOrder + m_numTrumps, [type](uint8_t a, uint8_t b) {
+        return Game::trumpScore(type, cardAt(a)) > Game::trumpScore(type, cardAt(b));
+    });
+
+    m_topTrumps[0] = 0;
+    for (int i = 0; i < m_numTrumps; ++i)
+        m_topTrumps[i + 1] = m_topTrumps[i] | cardBit(m_trumpOrder[i]);
+    std::fill(m_topTrumps + m_numTrumps + 1, m_topTrumps + maxTrumps + 1, m_trumps);
+
+    int trumpRank[numCards];
+    std::fill(trumpRank, trumpRank + numCards, -1);
+    for (int i = 0; i < m_numTrumps; ++i)
+        trumpRank[m_trumpOrder[i]] = i;
+
+    // trumps are stronger than any color card, the lowest trump has strength numCardTypes + 1
+    std::fill(m_suitMasks, m_suitMasks + numSuits, 0);
+    for (int i = 0; i < numCards; ++i) {
+        if (trumpRank[i] >= 0) {
+            m_suit[i] = trumpSuit;
+            m_strength[i] = uint8_t(numCardTypes + m_numTrumps - trumpRank[i]);
+        } else {
+            m_suit[i] = uint8_t(cardAt(i).color);
+            m_strength[i] = uint8_t(cardAt(i).cardType + 1);
+        }
+        m_suitMasks[m_suit[i]] |= cardBit(i);
+    }
+
+    // strength is at most numCardTypes + maxTrumps, so keys stay below 0x80
+    for (int suit = 0; suit < numSuits; ++suit) {
+        for (int i = 0; i < numCards; ++i) {
+            const bool canWin = m_suit[i] == suit || m_suit[i] == trumpSuit;
+            m_trickKeys[suit][i] = uint8_t(canWin ? m_strength[i] << 2 : 0);
+        }
+    }
+
+    for (int i = 0; i < numCards; ++i) {
+        m_order[i] = uint8_t(i);
+        m_points[i] = uint8_t(maskPoints(cardBit(i)));
+    }
+    std::sort(m_order, m_order + numCards, [this](uint8_t a, uint8_t b) {
+        return m_suit[a] != m_suit[b] ? m_suit[a] < m_suit[b] : m_strength[a] > m_strength[b];
+    });
+    for (int suit = 0, i = 0; suit <= numSuits; ++suit) {
+        while (i < numCards && m_suit[m_order[i]] < suit)
+            ++i;
+        m_suitStart[suit] = uint8_t(i);
+    }
+
+    for (int c = 0; c < numColors; ++c) {
+        for (int byte = 0; byte < 256; ++byte) {
+            uint16_t ranks = 0;
+            for (int t = 0; t < numCardTypes; ++t) {
+                const int rank = trumpRank[c * numCardTypes + t];
+                if ((byte & (1 << t)) && rank >= 0)
+                    ranks |= uint16_t(1 << rank);
+            }
+            m_trumpRanks[c][byte] = ranks;
+        }
+    }
+}
+
+const Rules& Rules::get(Game::Type type, Color color)
+{
+    static const struct Table
+    {
+        Table()
+        {
+            for (int type = 0; type < numGameTypes; ++type) {
+                for (int color = 0; color < numColors; ++color)
+                    rules.emplace_back(Game::Type(type), Color(color));
+            }
+        }
+        std::vector<Rules> rules;
+    } table;
+    return table.rules[size_t(type * numColors + color)];
+}
+
+#ifdef SCHAFKOPF_AVX2
+
+// 8 stiche per step: strength and suit of all 32 cards are looked up with
+// byte shuffles, the half of the table is picked by bit 4 of the card
+__attribute__((target("avx2")))
+static size_t trickWinnersAvx2(const uint8_t *strengths, const uint8_t *suits, const uint8_t *cards,
+                               size_t count, uint8_t *winners)
+{
+    const __m256i strengthsLow = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(strengths)));
+    const __m256i strengthsHigh = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(strengths + 16)));
+    const __m256i suitsLow = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(suits)));
+    const __m256i suitsHigh = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(suits + 16)));
+    const __m256i firstCard = _mm256_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+                                               0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+    const __m256i positions = _mm256_set1_epi32(0x03020100);
+    const __m256i trumpSuit = _mm256_set1_epi8(Rules::trumpSuit);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i stiche = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cards + i * numPlayers));
+        // moves bit 4 of each card to bit 7, cards are below 32 so nothing spills over
+        const __m256i high = _mm256_slli_epi16(stiche, 3);
+
+        const __m256i strength = _mm256_blendv_epi8(_mm256_shuffle_epi8(strengthsLow, stiche),
+                                                    _mm256_shuffle_epi8(strengthsHigh, stiche), high);
+        // strengths are below 0x40, so the shift stays within each byte
+        const __m256i key = _mm256_slli_epi16(strength, 2);
+        const __m256i suit = _mm256_blendv_epi8(_mm256_shuffle_epi8(suitsLow, stiche),
+                                                _mm256_shuffle_epi8(suitsHigh, stiche), high);
+        const __m256i leadSuit = _mm256_shuffle_epi8(suit, firstCard);
+        const __m256i canWin = _mm256_or_si256(_mm256_cmpeq_epi8(suit, leadSuit), _mm256_cmpeq_epi8(suit, trumpSuit));
+
+        __m256i best = _mm256_or_si256(_mm256_and_si256(key, canWin), positions);
+        best = _mm256_max_epu8(best, _mm256_srli_epi32(best, 16));
+        best = _mm256_max_epu8(best, _mm256_srli_epi32(best, 8));
+        best = _mm256_and_si256(best, _mm256_set1_epi32(numPlayers - 1));
+
+        // one winner in the low byte of each 32 bit lane
+        const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(winners + i), _mm_packus_epi16(packed, packed));
+    }
+    return i;
+}
+
+#endif
+
+void Rules::trickWinners(const uint8_t *cards, size_t count, uint8_t *winners) const
+{
+    size_t i = 0;
+#ifdef SCHAFKOPF_AVX2
+    if (hasAvx2())
+        i = trickWinnersAvx2(m_strength, m_suit, cards, count, winners);
+#endif
+    for (; i < count; ++i)
+        winners[i] = uint8_t(trickWinner(cards + i * numPlayers));
+}
+
+}
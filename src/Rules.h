@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CardMask.h"
+
+namespace SchafKopf
+{
+
+// the declarer and, in a Sauspiel, the player who holds the called Sau
+inline int declarerTeam(Game::Type type, Color color, int declarer, const CardMask hands[numPlayers])
+{
+    const int sau = cardIndex(Card{ Ass, color });
+    const CardMask isSauSpiel = type == Game::SauSpiel;
+
+    int team = 1 << declarer;
+    for (int i = 0; i < numPlayers; ++i)
+        team |= ((hands[i] >> sau) & isSauSpiel) << i;
+    return team;
+}
+
+// Precomputed tables for one game type and color. Works on card indices
+// (see Card::hashValue) and CardMasks instead of Card objects.
+class Rules
+{
+public:
+    Rules(Game::Type type, Color color);
+
+    Game::Type type() const { return m_type; }
+    Color color() const { return m_color; }
+
+    CardMask trumps() const { return m_trumps; }
+    bool isTrump(int card) const { return (m_trumps >> card) & 1; }
+
+    // all trumps are one suit, the other cards are grouped by color
+    static constexpr int trumpSuit = numColors;
+    static constexpr int numSuits = numColors + 1;
+
+    int suit(int card) const { return m_suit[card]; }
+    CardMask suitMask(int suit) const { return m_suitMasks[suit]; }
+
+    // higher values win, only comparable within a suit or against trumps
+    int strength(int card) const { return m_strength[card]; }
+
+    // the cards of hand that can be played on a stich started with firstCard
+    CardMask legalMoves(CardMask hand, int firstCard) const
+    {
+        const CardMask follow = hand & m_suitMasks[m_suit[firstCard]];
+        return follow ? follow : hand;
+    }
+
+    // Index of the winning card of a full stich, cards in the order they
+    // were played. Every card gets a key byte, strength << 2 | position,
+    // or just its position if it can neither follow the first card nor
+    // trump - the largest key wins and holds its position.
+    int trickWinner(const uint8_t cards[numPlayers]) const
+    {
+        const uint8_t *keys = m_trickKeys[m_suit[cards[0]]];
+        const uint32_t packed = keys[cards[0]]
+                | uint32_t(keys[cards[1]] | 1) << 8
+                | uint32_t(keys[cards[2]] | 2) << 16
+                | uint32_t(keys[cards[3]] | 3) << 24;
+        uint32_t best = maxBytes(packed, packed >> 16);
+        best = maxBytes(best, best >> 8);
+        return best & (numPlayers - 1);
+    }
+
+    // One card out of every group of interchangeable cards in hand. Cards
+    // are interchangeable if they have the same points and are neighbours
+    // in their suit once the cards in gone are left out, so whichever of
+    // them is played, every stich ends the same way.
+    CardMask representatives(CardMask hand, CardMask gone) const
+    {
+        CardMask result = 0;
+        for (int suit = 0; suit < numSuits; ++suit) {
+            if (!(hand & m_suitMasks[suit]))
+                continue;
+            int previous = -1;
+            for (int i = m_suitStart[suit]; i < m_suitStart[suit + 1]; ++i) {
+                const int card = m_order[i];
+                if ((gone >> card) & 1)
+                    continue;
+                if (!((hand >> card) & 1)) {
+                    previous = -1;
+                    continue;
+                }
+                if (previous < 0 || m_points[card] != m_points[previous])
+                    result |= cardBit(card);
+                previous = card;
+            }
+        }
+        return result;
+    }
+
+    // the same for count stiche of 4 cards each, written to winners
+    void trickWinners(const uint8_t *cards, size_t count, uint8_t *winners) const;
+
+    // key byte of card in a stich started with a card of leadSuit, without the position
+    int trickKey(int leadSuit, int card) const { return m_trickKeys[leadSuit][card]; }
+
+    int numTrumps() const { return m_numTrumps; }
+
+    // all cards grouped by suit, the strongest first, and where each suit starts
+    const uint8_t *suitOrder() const { return m_order; }
+    int suitStart(int suit) const { return m_suitStart[suit]; }
+
+    // card indices of all trumps, highest trump first
+    const uint8_t *trumpOrder() const { return m_trumpOrder; }
+
+    // the n highest trumps
+    CardMask topTrumps(int n) const { return m_topTrumps[n]; }
+
+    // bit i is set if cards contains the i-th highest trump
+    uint32_t trumpRanks(CardMask cards) const
+    {
+        return m_trumpRanks[0][cards & 0xff]
+                | m_trumpRanks[1][(cards >> 8) & 0xff]
+                | m_trumpRanks[2][(cards >> 16) & 0xff]
+                | m_trumpRanks[3][cards >> 24];
+    }
+
+    // number of Laufende in cards, counted "mit" (starting with the highest
+    // trump) or "ohne" (the highest trumps are all missing)
+    int laufende(CardMask cards) const
+    {
+        const uint32_t ranks = trumpRanks(cards);
+        // invert if we have the highest trump, then count the run of zeros
+        const uint32_t run = ranks ^ (0u - (ranks & 1));
+        return __builtin_ctz(run | (1u << m_numTrumps));
+    }
+
+    static constexpr int maxTrumps = 14;
+
+    // the rules of all games, built once
+    static const Rules& get(Game::Type type, Color color);
+
+private:
+    // maximum of each byte, for bytes below 0x80
+    static uint32_t maxBytes(uint32_t a, uint32_t b)
+    {
+        // the high bit of a byte is set where a >= b
+        const uint32_t greaterEqual = ((a | 0x80808080u) - b) & 0x80808080u;
+        const uint32_t mask = (greaterEqual >> 7) * 0xffu;
+        return (a & mask) | (b & ~mask);
+    }
+
+    Game::Type m_type;
+    Color m_color;
+
+    CardMask m_trumps;
+    int m_numTrumps;
+    uint8_t m_trumpOrder[maxTrumps];
+    CardMask m_topTrumps[maxTrumps + 1];
+
+    uint8_t m_suit[numCards];
+    uint8_t m_strength[numCards];
+    CardMask m_suitMasks[numSuits];
+    uint8_t m_trickKeys[numSuits][numCards];
+
+    uint8_t m_order[numCards];
+    uint8_t m_suitStart[numSuits + 1];
+    uint8_t m_points[numCards];
+
+    uint16_t m_trumpRanks[numColors][256];
+};
+
+}
@@ -1,10 +1,15 @@
 #include "Schafkopf.h"
+#include "Rules.h"
 
 namespace SchafKopf
 {
 
 Game::Game()
-    : discardPile{players}
+    : discardPile{players},
+      gameType(Solo),
+      gameColor(Herz),
+      declarer(0),
+      epoch(0)
 {
     players[0].id = 0;
     players[1].id = 1;
@@ -16,20 +21,8 @@ Game::Game()
 
 void Game::reset()
 {
-    m_activePlayer = 0;
-    m_lastStichPlayer = 0;
-    numStiche = 0;
-
-    for (auto&& player : players)
-        player.reset();
-
-    Card cards[numPlayers];
-    activePile.take(cards);
-
     deck.shuffle();
-
-    for (int i = 0; i < numPlayers; ++i)
-        players[i].deal(deck.begin() + (i * 8));
+    redeal();
 
     for (auto&& ai : ais) {
         if (ai)
@@ -37,6 +30,19 @@ void Game::reset()
     }
 }
 
+void Game::redeal()
+{
+    m_activePlayer = 0;
+    m_lastStichPlayer = 0;
+    numStiche = 0;
+    ++epoch;
+
+    activePile.clear();
+
+    for (int i = 0; i < numPlayers; ++i)
+        players[i].redeal(deck.begin() + (i * 8));
+}
+
 bool Game::canPutCard(const Card& card, const ActivePile& pile, const Player& player) const
 {
     const bool cardIsTrump = isTrump(card);
@@ -91,15 +97,16 @@ void Game::doStich()
     Card pile[numPlayers];
     activePile.take(pile);
 
-    int highestCard = 0;
-    for (int i = 1; i < numPlayers; ++i) {
-        if (sticht(pile[highestCard], pile[i]))
-            highestCard = i;
-    }
+    uint8_t cards[numPlayers];
+    for (int i = 0; i < numPlayers; ++i)
+        cards[i] = uint8_t(pile[i].hashValue());
+    const int highestCard = Rules::get(gameType, gameColor).trickWinner(cards);
 
     int topPlayer = (m_activePlayer + highestCard) % 4;
 
-    players[topPlayer].addStich(pile, m_activePlayer);
+    // already there if the cards came through putCard
+    history.add(numStiche, pile, m_activePlayer);
+    players[topPlayer].addStich(pile);
 
     // remember the player who did the last stich
     m_lastStichPlayer = topPlayer;
@@ -115,10 +122,11 @@ void Game::putCard(int c)
     assert(canPutCard(c));
 
     Card card = *activePlayer().takeCard(c);
+    history.add(numPlies(), card, m_activePlayer);
     activePile.put(std::move(card), m_activePlayer);
 
     for (auto &ai : ais) {
-        if (ai)
+        if (ai && !ai->isLazy())
             ai->cardPlayed(activePile, m_activePlayer);
     }
 
@@ -133,7 +141,12 @@ int Game::trumpScore(const Card& card) const
 {
     assert(isTrump(card));
 
-    switch (gameType) {
+    return trumpScore(gameType, card);
+}
+
+int Game::trumpScore(Type type, const Card& card)
+{
+    switch (type) {
     case Solo:
     case SauSpiel:
         if (card.cardType == Ober)
@@ -176,23 +189,35 @@ bool Game::sticht(const Card& card, const Card& other) const
 
 bool Game::isTrump(const Card& card) const
 {
-    switch (gameType) {
-    case Solo:
+    return isTrump(gameType, gameColor, card);
+}
+
+bool Game::isTrump(Type type, Color color, const Card& card)
+{
+    switch (type) {
     case SauSpiel:
+        // the color of a Sauspiel is the called Sau, Herz is always trump
+        return card.cardType == CardType::Ober
+                || card.cardType == CardType::Unter
+                || card.color == Herz;
+    case Solo:
         return card.cardType == CardType::Ober
                 || card.cardType == CardType::Unter
-                || card.color == gameColor;
+                || card.color == color;
     case Wenz:
         return card.cardType == CardType::Unter;
     case FarbWenz:
         return card.cardType == CardType::Unter
-                || card.color == gameColor;
+                || card.color == color;
     case Geier:
         return card.cardType == CardType::Ober;
     case FarbGeier:
         return card.cardType == CardType::Ober
-                || card.color == gameColor;
+                || card.color == color;
     }
+
+    assert(false);
+    return false;
 }
 
 double Game::stichProbability(const Player& player, const Card& card) const
@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cstring>
 #include <random>
 #include <set>
+#include <type_traits>
 
 namespace std
 {
@@ -134,8 +136,8 @@ struct Card
     static Card fromHashValue(int value)
     {
         Card result;
-        result.color = static_cast<Color>(value % 4);
-        result.cardType = static_cast<CardType>(value - (result.color * numCardTypes));
+        result.color = static_cast<Color>(value / numCardTypes);
+        result.cardType = static_cast<CardType>(value % numCardTypes);
         return result;
     }
 };
@@ -152,7 +154,13 @@ struct Deck
 
     void shuffle()
     {
-        std::shuffle(cards, cards + numCards, Environment::instance().engine());
+        shuffle(Environment::instance().engine());
+    }
+
+    template <typename Engine>
+    void shuffle(Engine& engine)
+    {
+        std::shuffle(cards, cards + numCards, engine);
     }
 
     const Card* begin() const { return cards; }
@@ -162,6 +170,7 @@ struct Deck
     Card cards[numCards];
 };
 
+// one finished stich, as pairs of the player and the card played
 struct Stich
 {
     bool contains(const Card &c) const
@@ -180,6 +189,46 @@ struct Stich
     std::pair<int, Card> cards[4];
 };
 
+// All cards played in a game, one byte per card in the order they were
+// played: the card's hash value and the player in the top bits. Only the
+// first Game::numPlies() entries are valid, so there is nothing to clear
+// on reset. Cards are appended as they are played, so it is also the event
+// log that lazy AIs read, see AI::isLazy().
+struct StichHistory
+{
+    void add(int ply, const Card& card, int player)
+    {
+        assert(ply >= 0 && ply < 32);
+        plies[ply] = uint8_t(card.hashValue() | (player & 3) << playerShift);
+    }
+
+    void add(int stich, const Card cards[4], int firstPlayer)
+    {
+        assert(stich >= 0 && stich < 8);
+        for (int i = 0; i < 4; ++i)
+            add(stich * 4 + i, cards[i], firstPlayer + i);
+    }
+
+    Card card(int ply) const { return Card::fromHashValue(plies[ply] & cardMask); }
+    int player(int ply) const { return plies[ply] >> playerShift; }
+
+    // the player who came out in stich
+    int leader(int stich) const { return player(stich * 4); }
+
+    Stich stich(int stich) const
+    {
+        Stich result;
+        for (int i = 0; i < 4; ++i)
+            result.cards[i] = std::make_pair(player(stich * 4 + i), card(stich * 4 + i));
+        return result;
+    }
+
+    static constexpr int playerShift = 5;
+    static constexpr uint8_t cardMask = (1 << playerShift) - 1;
+
+    uint8_t plies[32];
+};
+
 struct PlayerId
 {
     PlayerId(int playerId = 0)
@@ -202,18 +251,18 @@ struct Player
     Player()
         : id(-1),
           numStiche(0),
-          points(0)
+          points(0),
+          wonCards(0)
     {}
 
     void reset()
     {
         numStiche = 0;
         points = 0;
+        wonCards = 0;
 
         for (auto& card : m_cards)
             card = std::optional<Card>();
-        for (int i = 0; i < maxCards; ++i)
-            m_stiche[i].reset();
     }
 
     void deal(const Card cards[8])
@@ -222,6 +271,15 @@ struct Player
             m_cards[i] = cards[i];
     }
 
+    // reset() and deal() in one go, the cards are overwritten anyway
+    void redeal(const Card cards[8])
+    {
+        numStiche = 0;
+        points = 0;
+        wonCards = 0;
+        deal(cards);
+    }
+
     std::optional<Card> takeCard(int c)
     {
         std::optional<Card> result;
@@ -239,33 +297,21 @@ struct Player
         return false;
     }
 
-    void addStich(Card cards[4], PlayerId activePlayer)
+    // the stich itself is kept in the StichHistory of the game
+    void addStich(const Card cards[4])
     {
         assert(numStiche >= 0 && numStiche < 8);
-        assert(activePlayer >= 0 && activePlayer < numPlayers);
 
         for (int i = 0; i < numPlayers; ++i) {
             points += cards[i].points();
-            m_stiche[numStiche].cards[i] = std::make_pair(activePlayer, std::move(cards[i]));
-            ++activePlayer;
+            wonCards |= 1u << cards[i].hashValue();
         }
         ++numStiche;
     }
 
-    bool cardInStiche(const Card &card)
-    {
-        for (int i = 0; i < numStiche; ++i) {
-            if (m_stiche[i].contains(card))
-                return true;
-        }
-
-        return false;
-    }
-
-    const Stich &lastStich() const
+    bool cardInStiche(const Card &card) const
     {
-        assert(numStiche > 0);
-        return m_stiche[numStiche - 1];
+        return (wonCards >> card.hashValue()) & 1;
     }
 
     static constexpr int maxCards = 8;
@@ -273,8 +319,9 @@ struct Player
     int id;
     int numStiche;
     int points;
+    // bit Card::hashValue() is set for every card in the stiche the player won
+    uint32_t wonCards;
     std::optional<Card> m_cards[maxCards];
-    Stich m_stiche[maxCards];
 };
 
 struct DiscardPile
@@ -307,6 +354,12 @@ struct ActivePile
         m_cards[numCards++] = std::move(card);
     }
 
+    // cards beyond numCards are stale, there is no need to clear them
+    void clear()
+    {
+        numCards = 0;
+    }
+
     void take(Card cards[numPlayers])
     {
         for (int i = 0; i < numPlayers; ++i) {
@@ -359,6 +412,51 @@ public:
     virtual void cardPlayed(const ActivePile& pile, int activePlayer) = 0;
     virtual int doPlayCard(const ActivePile& pile) = 0;
     virtual void reset() = 0;
+
+    // A lazy AI is not told about every card. It reads the cards it has not
+    // seen yet from Game::history when it needs its state, usually on its
+    // own turn.
+    bool isLazy() const { return m_lazy; }
+    void setLazy(bool lazy) { m_lazy = lazy; }
+
+    // The state of an AI without its references to the game, so a search
+    // can play ahead with the AI and go back, or give an AI of the same
+    // type in another Game the same knowledge. Fixed size, nothing is
+    // allocated. AIs without state keep the defaults.
+    struct Snapshot
+    {
+        static constexpr size_t maxSize = 128;
+        alignas(8) unsigned char data[maxSize];
+    };
+
+    virtual void snapshot(Snapshot&) const {}
+    virtual void restore(const Snapshot&) {}
+
+    // other must be of the same type
+    void cloneFrom(const AI& other)
+    {
+        Snapshot state;
+        other.snapshot(state);
+        restore(state);
+    }
+
+protected:
+    template <typename State>
+    static void storeState(Snapshot& snapshot, const State& state)
+    {
+        static_assert(sizeof(State) <= Snapshot::maxSize, "state does not fit into a snapshot");
+        static_assert(std::is_trivially_copyable<State>::value, "state must be copyable with memcpy");
+        std::memcpy(snapshot.data, &state, sizeof(State));
+    }
+
+    template <typename State>
+    static void loadState(const Snapshot& snapshot, State& state)
+    {
+        std::memcpy(&state, snapshot.data, sizeof(State));
+    }
+
+private:
+    bool m_lazy = false;
 };
 
 static const char *GameTypeNames[] =
@@ -371,6 +469,8 @@ static const char *GameTypeNames[] =
     "Solo"
 };
 
+constexpr int numGameTypes = 6;
+
 struct Game
 {
     enum Type
@@ -393,14 +493,35 @@ struct Game
     Deck deck;
     DiscardPile discardPile;
     ActivePile activePile;
+    StichHistory history;
 
     Type gameType;
+    // for a Sauspiel, this is the color of the called Sau - Herz is always trump
     Color gameColor;
+    // the player who plays the game (and calls the Sau in a Sauspiel)
+    int declarer;
+
+    // changes with every new deal, so AIs can tell that their state is stale
+    uint32_t epoch;
 
     Game();
 
+    // new deal from the shared engine, all AIs are reset
     void reset();
 
+    // new deal without notifying the AIs, for simulations that run many
+    // games on the same objects. AIs with state compare epoch to the one
+    // they saw last and reset themselves on first use.
+    template <typename Engine>
+    void redeal(Engine& engine)
+    {
+        deck.shuffle(engine);
+        redeal();
+    }
+
+    // same, with the cards that are in the deck
+    void redeal();
+
     inline const Player& activePlayer() const
     {
         return players[m_activePlayer];
@@ -416,6 +537,40 @@ struct Game
         return players[m_lastStichPlayer];
     }
 
+    Stich stich(int i) const
+    {
+        assert(i >= 0 && i < numStiche);
+        return history.stich(i);
+    }
+
+    Stich lastStich() const
+    {
+        return stich(numStiche - 1);
+    }
+
+    // who won stich i: whoever came out in the next one, or for the last
+    // finished stich the last winner
+    int stichWinner(int i) const
+    {
+        assert(i >= 0 && i < numStiche);
+        return i + 1 < numStiche ? history.leader(i + 1) : m_lastStichPlayer;
+    }
+
+    // bit i is set for every finished stich i that player won
+    unsigned wonStiche(int player) const
+    {
+        unsigned result = 0;
+        for (int i = 0; i < numStiche; ++i)
+            result |= unsigned(stichWinner(i) == player) << i;
+        return result;
+    }
+
+    // number of cards played so far, valid entries of history
+    int numPlies() const
+    {
+        return numStiche * numPlayers + activePile.numCards;
+    }
+
     inline const Card& firstPileCard() const
     {
         assert(activePile.m_cards[0]);
@@ -437,6 +592,9 @@ struct Game
     int trumpScore(const Card& card) const;
     bool isTrump(const Card& card) const;
 
+    static int trumpScore(Type type, const Card& card);
+    static bool isTrump(Type type, Color color, const Card& card);
+
     bool hasTrump(const Player& player) const
     {
         for (const auto& card : player.m_cards) {
@@ -0,0 +1,107 @@
+#include "Scoring.h"
+
+namespace SchafKopf
+{
+
+Tariff::Tariff()
+    : schneider(10),
+      schwarz(10),
+      laufender(10)
+{
+    base[Game::SauSpiel] = 10;
+    base[Game::FarbGeier] = base[Game::Geier] = 50;
+    base[Game::FarbWenz] = base[Game::Wenz] = 50;
+    base[Game::Solo] = 50;
+
+    // Wenz and Geier only have four trumps, so two Laufende are enough
+    minLaufende[Game::SauSpiel] = minLaufende[Game::Solo] = 3;
+    minLaufende[Game::FarbGeier] = minLaufende[Game::FarbWenz] = 3;
+    minLaufende[Game::Geier] = minLaufende[Game::Wenz] = 2;
+}
+
+FinishedGame FinishedGame::fromGame(const Game& game)
+{
+    assert(game.numStiche == Player::maxCards);
+
+    FinishedGame result;
+    result.gameType = game.gameType;
+    result.gameColor = game.gameColor;
+    result.declarer = game.declarer;
+
+    for (int i = 0; i < numPlayers; ++i) {
+        const Player& player = game.players[i];
+
+        result.hands[i] = 0;
+        for (int j = 0; j < Player::maxCards; ++j)
+            result.hands[i] |= cardBit(game.deck.cards[i * Player::maxCards + j]);
+
+        result.won[i] = player.wonCards;
+    }
+
+    return result;
+}
+
+Scoring::Scoring(const Tariff& tariff)
+    : m_tariff(tariff)
+{
+    m_rules.reserve(numGameTypes * numColors);
+    for (int type = 0; type < numGameTypes; ++type) {
+        for (int color = 0; color < numColors; ++color)
+            m_rules.emplace_back(Game::Type(type), Color(color));
+    }
+}
+
+Settlement Scoring::settle(const FinishedGame& game) const
+{
+    Settlement result;
+
+    const int team = declarerTeam(game);
+    result.declarerTeam = team;
+
+    CardMask teamHands = 0;
+    CardMask teamWon = 0;
+    CardMask othersWon = 0;
+    for (int i = 0; i < numPlayers; ++i) {
+        const CardMask inTeam = 0u - CardMask((team >> i) & 1);
+        teamHands |= game.hands[i] & inTeam;
+        teamWon |= game.won[i] & inTeam;
+        othersWon |= game.won[i] & ~inTeam;
+    }
+
+    const int points = maskPoints(teamWon);
+    const int won = points > 60;
+
+    result.declarerPoints = points;
+    result.won = won;
+    result.schneider = points >= 91 || points <= 30;
+    // the losing team didn't make a single stich
+    result.schwarz = (won ? othersWon : teamWon) == 0;
+
+    const int laufende = rules(game.gameType, game.gameColor).laufende(teamHands);
+    result.laufende = laufende;
+
+    const int value = m_tariff.base[game.gameType]
+            + result.schneider * m_tariff.schneider
+            + result.schwarz * m_tariff.schwarz
+            + (laufende >= m_tariff.minLaufende[game.gameType]) * laufende * m_tariff.laufender;
+
+    // every opponent pays the value, split among the declarer's team -
+    // a solo player gets it three times, a Sauspiel partner once
+    const int teamSize = popCount(CardMask(team));
+    const int sign = won * 2 - 1;
+    const int share = (numPlayers - teamSize) / teamSize;
+    for (int i = 0; i < numPlayers; ++i) {
+        const int inTeam = (team >> i) & 1;
+        result.money[i] = sign * value * (inTeam * (share + 1) - 1);
+    }
+
+    return result;
+}
+
+void Scoring::settle(const FinishedGame* games, size_t count, Settlement* settlements) const
+{
+    for (size_t i = 0; i < count; ++i)
+        settlements[i] = settle(games[i]);
+}
+
+}
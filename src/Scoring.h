@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Rules.h"
+
+#include <vector>
+
+namespace SchafKopf
+{
+
+// The money a game is worth, configurable per table
+struct Tariff
+{
+    Tariff();
+
+    // price of a won or lost game, per game type
+    int base[numGameTypes];
+    // Laufende are only paid starting from this number, per game type
+    int minLaufende[numGameTypes];
+
+    int schneider;
+    int schwarz;
+    // price per Laufender
+    int laufender;
+};
+
+// Everything that is needed to settle a game that was played to the end
+struct FinishedGame
+{
+    Game::Type gameType;
+    Color gameColor;
+    int declarer;
+
+    // the hands as they were dealt
+    CardMask hands[numPlayers];
+    // all cards each player took in stiche
+    CardMask won[numPlayers];
+
+    static FinishedGame fromGame(const Game& game);
+};
+
+struct Settlement
+{
+    // money won (positive) or lost (negative) per player, sums up to 0
+    int money[numPlayers];
+
+    // bit i is set if player i played with the declarer
+    int declarerTeam;
+    int declarerPoints;
+    int laufende;
+
+    bool won;
+    bool schneider;
+    bool schwarz;
+};
+
+class Scoring
+{
+public:
+    explicit Scoring(const Tariff& tariff = Tariff());
+
+    const Tariff& tariff() const { return m_tariff; }
+
+    const Rules& rules(Game::Type type, Color color) const
+    {
+        return m_rules[type * numColors + color];
+    }
+
+    // the declarer and, in a Sauspiel, the player who holds the called Sau
+    static int declarerTeam(const FinishedGame& game)
+    {
+        return SchafKopf::declarerTeam(game.gameType, game.gameColor, game.declarer, game.hands);
+    }
+
+    Settlement settle(const FinishedGame& game) const;
+
+    // settles count games at once, games and settlements must not overlap
+    void settle(const FinishedGame* games, size_t count, Settlement* settlements) const;
+
+private:
+    Tariff m_tariff;
+    std::vector<Rules> m_rules;
+};
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Bidding.h"
+#include "GamePool.h"
+#include "TrainingData.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace SchafKopf
+{
+
+// Games of an AI against itself, as training data: a Sample for every
+// card played, labelled with what the declarer team took from there on.
+namespace SelfPlay
+{
+
+// Deals, picks a contract and plays one game with the AIs of bundle,
+// appending a sample per card. The declarer is a random player, the
+// contract a random one that can be announced with the declarer's hand.
+template <typename SeatAi, typename Engine>
+void playGame(GameBundle<SeatAi>& bundle, Engine& engine, std::vector<Sample>& samples)
+{
+    Game& game = bundle.game;
+    // from a fresh deck, so the deal only depends on the engine
+    game.deck = Deck();
+    game.redeal(engine);
+    game.declarer = int(engine() % numPlayers);
+    const CardMask hand = handMask(game.players[game.declarer]);
+    Contract contract;
+    do {
+        contract = allContracts[engine() % numContracts];
+    } while (!contract.isValid(hand));
+    game.gameType = contract.type;
+    game.gameColor = contract.color;
+    const Rules& rules = Rules::get(game.gameType, game.gameColor);
+
+    const size_t first = samples.size();
+    Position position = Position::fromGame(game, rules);
+    for (int ply = 0; ply < numCards; ++ply) {
+        const int index = bundle.seats[game.m_activePlayer].doPlayCard(game.activePile);
+        const int card = cardIndex(*game.activePlayer().m_cards[index]);
+        samples.push_back(Sample::make(position, card));
+        position.play(card);
+        game.putCard(index);
+    }
+
+    const int total = position.declarerPoints();
+    for (size_t i = first; i < samples.size(); ++i)
+        samples[i].points = uint8_t(total - samples[i].won);
+}
+
+// Plays numGames games on numThreads threads and hands the samples to
+// writer, gamesPerBatch games at a time. Every batch has an engine seeded
+// from seed and its number, so the games do not depend on the threads.
+// Returns the number of samples.
+template <typename SeatAi>
+size_t run(TrainingData::ShardWriter& writer, int numGames, int numThreads, uint32_t seed, int gamesPerBatch = 64)
+{
+    GamePool<SeatAi> pool;
+    std::atomic<int> nextBatch(0);
+    std::atomic<size_t> numSamples(0);
+    const int numBatches = (numGames + gamesPerBatch - 1) / gamesPerBatch;
+
+    auto worker = [&]() {
+        typename GamePool<SeatAi>::Lease bundle = pool.acquire();
+        int batch;
+        while ((batch = nextBatch++) < numBatches) {
+            std::minstd_rand engine(seed * 1000003u + unsigned(batch) + 1);
+            const int count = std::min(gamesPerBatch, numGames - batch * gamesPerBatch);
+            std::vector<Sample> samples;
+            samples.reserve(size_t(count * numCards));
+            for (int g = 0; g < count; ++g)
+                playGame(*bundle, engine, samples);
+            numSamples += samples.size();
+            writer.write(std::move(samples));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i)
+        threads.emplace_back(worker);
+    for (std::thread& thread : threads)
+        thread.join();
+    writer.flush();
+    return numSamples;
+}
+
+}
+
+}
@@ -0,0 +1,431 @@
+#include "Solver.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace SchafKopf
+{
+
+namespace
+{
+
+// the different card points, 0 2 3 4 10 11
+constexpr int numPointClasses = 6;
+
+// random numbers for every card in every hand, the leader, the declarer
+// team and the game, and for every rank in every suit with its owner and
+// points
+struct ZobristKeys
+{
+    ZobristKeys()
+    {
+        // splitmix64, so the keys are the same in every run
+        uint64_t state = 0x5c4f3a2b1d0e9f87ull;
+        auto next = [&state]() {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        };
+        for (int p = 0; p < numPlayers; ++p) {
+            for (int card = 0; card < numCards; ++card)
+                cards[p][card] = next();
+            leader[p] = next();
+        }
+        for (int t = 0; t < numTeams; ++t)
+            team[t] = next();
+        for (int g = 0; g < numGameTypes * numColors; ++g)
+            game[g] = next();
+        static const uint8_t classes[12] = { 0, 0, 1, 2, 3, 0, 0, 0, 0, 0, 4, 5 };
+        for (int card = 0; card < numCards; ++card)
+            pointClass[card] = classes[maskPoints(cardBit(card))];
+        for (int suit = 0; suit < Rules::numSuits; ++suit) {
+            for (int rank = 0; rank < maxRanks; ++rank) {
+                for (int i = 0; i < numPlayers * numPointClasses; ++i)
+                    ranks[suit][rank][i] = next();
+            }
+        }
+    }
+
+    static constexpr int numTeams = 1 << numPlayers;
+    static constexpr int maxRanks = Rules::maxTrumps;
+
+    uint64_t cards[numPlayers][numCards];
+    uint64_t leader[numPlayers];
+    uint64_t team[numTeams];
+    uint64_t game[numGameTypes * numColors];
+    uint64_t ranks[Rules::numSuits][maxRanks][numPlayers * numPointClasses];
+    uint8_t pointClass[numCards];
+};
+
+const ZobristKeys& zobrist()
+{
+    static const ZobristKeys keys;
+    return keys;
+}
+
+uint64_t gameKey(const Rules& rules)
+{
+    return zobrist().game[rules.type() * numColors + rules.color()];
+}
+
+}
+
+SharedTable::SharedTable(int tableBits)
+    : m_slots(new Slot[size_t(1) << tableBits]),
+      m_mask((uint64_t(1) << tableBits) - 1)
+{
+    clear();
+}
+
+// entries are packed as lower | upper << 16 | move << 32
+bool SharedTable::probe(uint64_t key, int& lower, int& upper, int& move) const
+{
+    const Slot& slot = m_slots[key & m_mask];
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) != key)
+        return false;
+    lower = int16_t(data);
+    upper = int16_t(data >> 16);
+    move = int(uint8_t(data >> 32));
+    return true;
+}
+
+void SharedTable::store(uint64_t key, int lower, int upper, int move)
+{
+    const uint64_t data = uint64_t(uint16_t(lower)) | uint64_t(uint16_t(upper)) << 16
+            | uint64_t(uint8_t(move)) << 32;
+    Slot& slot = m_slots[key & m_mask];
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void SharedTable::clear()
+{
+    // data 0 and check 0 match key 0, which no position has in practice
+    for (uint64_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+        m_slots[i].check.store(0, std::memory_order_relaxed);
+    }
+}
+
+Solver::Solver(Measure measure, int tableBits)
+    : m_measure(measure),
+      m_table(size_t(1) << tableBits),
+      m_mask((uint64_t(1) << tableBits) - 1),
+      m_nodes(0),
+      m_probes(0),
+      m_hits(0),
+      m_mergeEquivalent(true),
+      m_useBounds(false),
+      m_useHistory(false),
+      m_partition(false),
+      m_firstCard(0),
+      m_shared(nullptr),
+      m_stop(nullptr),
+      m_aborted(false),
+      m_rules(nullptr)
+{
+    clearHistory();
+}
+
+void Solver::clear()
+{
+    std::fill(m_table.begin(), m_table.end(), Entry{ 0, 0, 0, noMove });
+    clearHistory();
+}
+
+void Solver::clearHistory()
+{
+    std::fill(&m_history[0][0], &m_history[0][0] + numPlayers * numCards, 0u);
+}
+
+void Solver::prepare(const Position& position)
+{
+    m_rules = position.rules;
+    m_aborted = false;
+}
+
+bool Solver::probe(uint64_t key, Entry& entry) const
+{
+    if (m_shared) {
+        int lower, upper, move;
+        if (!m_shared->probe(key, lower, upper, move))
+            return false;
+        entry = Entry{ key, int16_t(lower), int16_t(upper), uint8_t(move) };
+        return true;
+    }
+    entry = m_table[key & m_mask];
+    return entry.key == key;
+}
+
+void Solver::store(const Entry& entry)
+{
+    if (m_shared)
+        m_shared->store(entry.key, entry.lower, entry.upper, entry.move);
+    else
+        m_table[entry.key & m_mask] = entry;
+}
+
+uint64_t Solver::key(const Position& position) const
+{
+    const ZobristKeys& keys = zobrist();
+    uint64_t result = keys.team[position.declarerTeam] ^ gameKey(*position.rules);
+    for (int p = 0; p < numPlayers; ++p) {
+        for (CardMask hand = position.hands[p]; hand; hand &= hand - 1)
+            result ^= keys.cards[p][lowestCard(hand)];
+    }
+    return result;
+}
+
+uint64_t Solver::partitionKey(const Position& position, uint8_t cards[numCards]) const
+{
+    const ZobristKeys& keys = zobrist();
+    const uint8_t *order = m_rules->suitOrder();
+
+    // owner and points of every card in play, as index into ZobristKeys::ranks
+    uint8_t index[numCards];
+    for (int p = 0; p < numPlayers; ++p) {
+        for (CardMask hand = position.hands[p]; hand; hand &= hand - 1) {
+            const int card = lowestCard(hand);
+            index[card] = uint8_t(p * numPointClasses + keys.pointClass[card]);
+        }
+    }
+
+    uint64_t result = keys.team[position.declarerTeam] ^ keys.leader[position.leader] ^ gameKey(*m_rules);
+    int numLeft = 0;
+    for (int suit = 0; suit < Rules::numSuits; ++suit) {
+        int rank = 0;
+        for (int i = m_rules->suitStart(suit); i < m_rules->suitStart(suit + 1); ++i) {
+            const int card = order[i];
+            if ((position.played >> card) & 1)
+                continue;
+            result ^= keys.ranks[suit][rank++][index[card]];
+            cards[numLeft++] = uint8_t(card);
+        }
+    }
+    return result;
+}
+
+int Solver::won(const Position& position) const
+{
+    const CardMask teamWon = position.teamWon(position.declarerTeam);
+    return m_measure == Points ? maskPoints(teamWon) : popCount(teamWon) / numPlayers;
+}
+
+int Solver::remaining(const Position& position) const
+{
+    return m_measure == Points ? maskPoints(allCards & ~position.played)
+                               : Player::maxCards - position.numStiche();
+}
+
+Bounds Solver::bounds(const Position& position) const
+{
+    return m_measure == Points ? pointBounds(position) : sticheBounds(position);
+}
+
+MoveMatrix Solver::solveWorlds(const Position& root, const Deal *worlds, size_t numWorlds)
+{
+    MoveMatrix result;
+    result.numWorlds = int(numWorlds);
+    result.numMoves = 0;
+    for (CardMask moves = root.legalMoves(); moves; moves &= moves - 1)
+        result.moves[result.numMoves++] = uint8_t(lowestCard(moves));
+    result.values.resize(numWorlds * size_t(result.numMoves));
+    result.weights.assign(numWorlds, 1.0 / double(numWorlds));
+
+    for (size_t w = 0; w < numWorlds; ++w) {
+        Position world = root;
+        for (int p = 0; p < numPlayers; ++p)
+            world.hands[p] = worlds[w].hands[p];
+        assert(world.hands[root.toMove()] == root.hands[root.toMove()]);
+
+        for (int m = 0; m < result.numMoves; ++m) {
+            Position child = world;
+            child.play(result.moves[m]);
+            result.values[w * size_t(result.numMoves) + size_t(m)] = int16_t(won(child) + value(child));
+        }
+    }
+    return result;
+}
+
+bool Solver::reaches(const Position& position, int threshold)
+{
+    prepare(position);
+
+    const int target = threshold - won(position);
+    if (target <= 0)
+        return true;
+    if (target > remaining(position))
+        return false;
+    return search(position, target - 1, target, key(position)) >= target;
+}
+
+int Solver::value(const Position& position, int guess)
+{
+    prepare(position);
+
+    // MTD(f): null windows around the guess until the bounds meet
+    const uint64_t rootKey = key(position);
+    int lower = 0;
+    int upper = remaining(position);
+    if (guess < 0 || guess > upper)
+        guess = upper / 2;
+    while (lower < upper && !m_aborted) {
+        const int beta = guess == lower ? guess + 1 : guess;
+        guess = search(position, beta - 1, beta, rootKey);
+        if (guess < beta)
+            upper = guess;
+        else
+            lower = guess;
+    }
+    return lower;
+}
+
+int Solver::valueAlphaBeta(const Position& position)
+{
+    prepare(position);
+    return search(position, -1, remaining(position) + 1, key(position));
+}
+
+int Solver::nextMove(int player, CardMask moves) const
+{
+    const CardMask later = moves & (allCards << m_firstCard);
+    int result = lowestCard(later ? later : moves);
+    if (!m_useHistory)
+        return result;
+
+    // the card that caused the most cutoffs so far
+    const uint32_t *history = m_history[player];
+    for (CardMask rest = moves & ~cardBit(result); rest; rest &= rest - 1) {
+        const int card = lowestCard(rest);
+        if (history[card] > history[result])
+            result = card;
+    }
+    return result;
+}
+
+int Solver::search(const Position& position, int alpha, int beta, uint64_t key)
+{
+    ++m_nodes;
+
+    if (position.finished())
+        return 0;
+
+    Entry entry;
+    bool boundary = false;
+    int move = noMove;
+    uint8_t cards[numCards];
+
+    if (position.numInTrick == 0) {
+        if (m_stop && m_stop->load(std::memory_order_relaxed)) {
+            m_aborted = true;
+            return 0;
+        }
+
+        // nothing outside of [0, remaining] is possible
+        const int left = remaining(position);
+        if (left <= alpha)
+            return left;
+        if (beta <= 0)
+            return 0;
+        boundary = true;
+        const uint64_t fullKey = m_partition ? partitionKey(position, cards) : key ^ zobrist().leader[position.leader];
+        ++m_probes;
+        if (probe(fullKey, entry)) {
+            ++m_hits;
+            if (entry.lower >= beta)
+                return entry.lower;
+            if (entry.upper <= alpha)
+                return entry.upper;
+            if (entry.lower == entry.upper)
+                return entry.lower;
+            alpha = std::max(alpha, int(entry.lower));
+            beta = std::min(beta, int(entry.upper));
+            move = entry.move;
+            if (m_partition && move != noMove)
+                move = cards[move];
+        } else {
+            // a table hit is cheaper and often decides more
+            if (m_useBounds) {
+                const Bounds sure = bounds(position);
+                if (sure.lower >= beta)
+                    return sure.lower;
+                if (sure.upper <= alpha)
+                    return sure.upper;
+            }
+            entry = Entry{ fullKey, 0, int16_t(left), noMove };
+        }
+    }
+
+    const int windowAlpha = alpha;
+    const int windowBeta = beta;
+
+    const int player = position.toMove();
+    const bool maximize = position.isDeclarer(player);
+    const bool completes = position.numInTrick == numPlayers - 1;
+    const CardMask trick = position.trickMask();
+
+    CardMask moves = position.legalMoves();
+    if (m_mergeEquivalent)
+        moves = m_rules->representatives(moves, position.played);
+    int best = maximize ? -1 : std::numeric_limits<int>::max();
+    int bestMove = noMove;
+
+    // the best move of an earlier search first
+    if (move != noMove && !(moves & cardBit(move)))
+        move = noMove;
+
+    while (moves) {
+        const int card = move != noMove ? move : nextMove(player, moves);
+        moves &= ~cardBit(card);
+        move = noMove;
+
+        Position next = position;
+        next.play(card);
+
+        int gained = 0;
+        if (completes && next.isDeclarer(next.leader))
+            gained = m_measure == Points ? maskPoints(trick | cardBit(card)) : 1;
+
+        const int value = gained + search(next, alpha - gained, beta - gained, key ^ zobrist().cards[player][card]);
+        if (m_aborted)
+            return 0;
+
+        if (maximize ? value > best : value < best) {
+            best = value;
+            bestMove = card;
+        }
+        if (maximize)
+            alpha = std::max(alpha, best);
+        else
+            beta = std::min(beta, best);
+        if (alpha >= beta) {
+            const int left = numCards - popCount(position.played);
+            m_history[player][card] += uint32_t(left * left);
+            break;
+        }
+    }
+
+    if (boundary && !m_aborted) {
+        // fail low is an upper bound, fail high a lower bound
+        if (best < windowBeta)
+            entry.upper = int16_t(std::min(int(entry.upper), best));
+        if (best > windowAlpha)
+            entry.lower = int16_t(std::max(int(entry.lower), best));
+        entry.move = uint8_t(bestMove);
+        if (m_partition) {
+            // the rank of the move among the cards left in play
+            const uint8_t *order = m_rules->suitOrder();
+            int rank = 0;
+            for (int i = 0; order[i] != bestMove; ++i)
+                rank += !((position.played >> order[i]) & 1);
+            entry.move = uint8_t(rank);
+        }
+        store(entry);
+    }
+
+    return best;
+}
+
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Bounds.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// A transposition table several solvers in different threads can use at
+// the same time without locks. Each slot is two atomic words, the packed
+// entry and the key xor the entry, so a slot that was torn by two writers
+// does not match any key and is just a miss.
+class SharedTable
+{
+public:
+    explicit SharedTable(int tableBits = 22);
+
+    // the bounds and move stored for key, false if there are none
+    bool probe(uint64_t key, int& lower, int& upper, int& move) const;
+    void store(uint64_t key, int lower, int upper, int move);
+
+    void clear();
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    uint64_t m_mask;
+};
+
+// Values of the legal moves of one position in many worlds, the total
+// (already won and to come) of the declarer team after each move.
+struct MoveMatrix
+{
+    int value(int world, int move) const { return values[size_t(world * numMoves + move)]; }
+
+    // the mean value of move over the worlds, by their weights
+    double expected(int move) const
+    {
+        double result = 0;
+        for (int w = 0; w < numWorlds; ++w)
+            result += weights[size_t(w)] * value(w, move);
+        return result;
+    }
+
+    int numWorlds;
+    int numMoves;
+    // the legal cards, lowest first
+    uint8_t moves[Player::maxCards];
+    std::vector<int16_t> values;
+    // the share of every world, adding up to 1
+    std::vector<double> weights;
+};
+
+// Solves positions with all cards known: the declarer team maximizes, the
+// other team minimizes what the declarer team takes.
+//
+// Values are what the declarer team takes from the position on, card
+// points or stiche depending on the Measure. Most questions only need a
+// yes or no ("does the declarer get 61?"), which reaches() answers with a
+// single null window search. value() finds the exact value with a series
+// of null windows (MTD(f)), valueAlphaBeta() with one full window search.
+//
+// Only one card out of every group of interchangeable cards is searched,
+// see Rules::representatives. Cards in the current stich are not counted
+// as gone, they still decide who takes it.
+//
+// With setUseBounds(), a stich start that is not in the table stops the
+// search early if the sure tricks of either team (see Bounds.h) already
+// decide the window.
+//
+// Positions at the start of a stich are kept in a transposition table,
+// keyed by the game, who holds which card, who leads and who plays with
+// the declarer. Solvers can share one SharedTable instead of their own.
+//
+// With a partition table an entry stands for all positions that only
+// differ in the cards that are already gone: within every suit the cards
+// left in play have the same order, owners and points. Those positions
+// play out the same way, so one entry covers stiche that transpose into
+// each other as well as other deals with the same structure. The best
+// move is kept as the rank of the card among the cards left in play.
+class Solver
+{
+public:
+    enum Measure
+    {
+        Points,
+        Stiche
+    };
+
+    explicit Solver(Measure measure = Points, int tableBits = 20);
+
+    Measure measure() const { return m_measure; }
+
+    // true if the declarer team ends up with at least threshold, counting
+    // what it already won
+    bool reaches(const Position& position, int threshold);
+
+    // what the declarer team takes from now on, starting MTD(f) at guess
+    // or in the middle
+    int value(const Position& position, int guess = -1);
+    int valueAlphaBeta(const Position& position);
+
+    // Solves every legal move of root in every world. The worlds replace the
+    // hands of root, they have to agree on the hand of the player to move
+    // and the cards that are gone. They all go through this solver, so with
+    // setUseHistory() later worlds are ordered by the cutoffs of earlier
+    // ones. The table is shared too, but different worlds rarely meet the
+    // same positions.
+    MoveMatrix solveWorlds(const Position& root, const Deal *worlds, size_t numWorlds);
+
+    // what the declarer team already has
+    int won(const Position& position) const;
+    // what is left to take
+    int remaining(const Position& position) const;
+    // sureTricks bounds on what the declarer team takes from now on
+    Bounds bounds(const Position& position) const;
+
+    // the usual questions about the final declarer points
+    bool declarerWins(const Position& position) { return reaches(position, 61); }
+    bool declarerSchneider(const Position& position) { return reaches(position, 91); }
+
+    // keys positions by the cards left in play instead of by cards
+    void setPartitionTable(bool partition) { m_partition = partition; clear(); }
+    bool partitionTable() const { return m_partition; }
+
+    // Cutoffs on sure tricks, off by default: they save about a fifth of
+    // the nodes, but computing the bounds costs about as much as that.
+    void setUseBounds(bool use) { m_useBounds = use; }
+    bool usesBounds() const { return m_useBounds; }
+
+    // Orders moves by how often they caused a cutoff before, after the move
+    // from the table. The history is kept until clear() or clearHistory().
+    void setUseHistory(bool use) { m_useHistory = use; }
+    bool usesHistory() const { return m_useHistory; }
+    void clearHistory();
+
+    // searches every legal card when off, for comparison
+    void setMergeEquivalent(bool merge) { m_mergeEquivalent = merge; }
+    bool mergesEquivalent() const { return m_mergeEquivalent; }
+
+    // uses table instead of its own until set to nullptr
+    void setSharedTable(SharedTable *table) { m_shared = table; }
+
+    // Searches stop as soon as stop is set, their results are meaningless
+    // then and nothing of them is stored. aborted() tells if that happened
+    // since the last call.
+    void setStop(const std::atomic<bool> *stop) { m_stop = stop; }
+    bool aborted() const { return m_aborted; }
+
+    // the card moves are tried from, wrapping around, for helper threads
+    // that should search in another order than the main one
+    void setFirstCard(int card) { m_firstCard = card; }
+
+    void clear();
+
+    // searched positions, table lookups and lookups that found an entry
+    // since the solver was created
+    uint64_t nodes() const { return m_nodes; }
+    uint64_t probes() const { return m_probes; }
+    uint64_t hits() const { return m_hits; }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        int16_t lower;
+        int16_t upper;
+        uint8_t move;
+    };
+
+    static constexpr uint8_t noMove = 0xff;
+
+    void prepare(const Position& position);
+    uint64_t key(const Position& position) const;
+    // the partition key of a position at the start of a stich, the cards
+    // left in play in the order of their rank are written to cards
+    uint64_t partitionKey(const Position& position, uint8_t cards[numCards]) const;
+    int search(const Position& position, int alpha, int beta, uint64_t key);
+    int nextMove(int player, CardMask moves) const;
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(const Entry& entry);
+
+    Measure m_measure;
+    std::vector<Entry> m_table;
+    uint64_t m_mask;
+    uint64_t m_nodes;
+    uint64_t m_probes;
+    uint64_t m_hits;
+    bool m_mergeEquivalent;
+    bool m_useBounds;
+    bool m_useHistory;
+    uint32_t m_history[numPlayers][numCards];
+    bool m_partition;
+    int m_firstCard;
+
+    SharedTable *m_shared;
+    const std::atomic<bool> *m_stop;
+    bool m_aborted;
+
+    const Rules* m_rules;
+};
+
+}
@@ -0,0 +1,205 @@
+#include "TrainingData.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace SchafKopf
+{
+
+Position Sample::position() const
+{
+    Deal deal;
+    for (int p = 0; p < numPlayers; ++p)
+        deal.hands[p] = hands[p];
+    Position result(rules(), deal, 0, leader);
+    result.played = played;
+    for (int i = 0; i < numPlayers; ++i)
+        result.trick[i] = trick[i];
+    result.numInTrick = numInTrick;
+    result.declarerTeam = declarerTeam;
+    return result;
+}
+
+Sample Sample::make(const Position& position, int move)
+{
+    Sample result;
+    for (int p = 0; p < numPlayers; ++p)
+        result.hands[p] = position.hands[p];
+    result.played = position.played;
+    for (int i = 0; i < numPlayers; ++i)
+        result.trick[i] = i < position.numInTrick ? position.trick[i] : 0;
+    result.game = uint8_t(position.rules->type() * numColors + position.rules->color());
+    result.leader = position.leader;
+    result.numInTrick = position.numInTrick;
+    result.declarerTeam = position.declarerTeam;
+    result.move = uint8_t(move);
+    result.won = uint8_t(position.declarerPoints());
+    result.points = 0;
+    result.unused = 0;
+    return result;
+}
+
+namespace TrainingData
+{
+
+std::string shardName(const std::string& prefix, int shard)
+{
+    char number[16];
+    std::snprintf(number, sizeof(number), "-%04d.bin", shard);
+    return prefix + number;
+}
+
+ShardWriter::ShardWriter(const std::string& prefix, size_t samplesPerShard, size_t maxQueued)
+    : m_prefix(prefix),
+      m_samplesPerShard(samplesPerShard),
+      m_maxQueued(maxQueued),
+      m_busy(false),
+      m_stop(false),
+      m_inShard(0),
+      m_written(0),
+      m_shards(0),
+      m_ok(true),
+      m_thread(&ShardWriter::run, this)
+{
+}
+
+ShardWriter::~ShardWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void ShardWriter::write(std::vector<Sample>&& samples)
+{
+    if (samples.empty())
+        return;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_queue.size() < m_maxQueued; });
+        m_queue.push_back(std::move(samples));
+    }
+    m_wake.notify_one();
+}
+
+void ShardWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+}
+
+bool ShardWriter::ok() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ok;
+}
+
+size_t ShardWriter::numWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+int ShardWriter::numShards() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_shards;
+}
+
+void ShardWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty())
+            break;
+
+        std::vector<Sample> samples = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+        m_done.notify_all();
+
+        writeBatch(samples);
+        lock.lock();
+        const bool idle = m_queue.empty();
+        lock.unlock();
+        if (idle)
+            m_file.flush();
+        const bool ok = bool(m_file);
+
+        lock.lock();
+        m_written += ok ? samples.size() : 0;
+        m_ok = m_ok && ok;
+        m_busy = false;
+        m_done.notify_all();
+    }
+    m_file.close();
+}
+
+// a batch can span two shards
+void ShardWriter::writeBatch(const std::vector<Sample>& samples)
+{
+    size_t start = 0;
+    while (start < samples.size()) {
+        if (!m_file.is_open() || m_inShard == m_samplesPerShard) {
+            m_file.close();
+            m_file.clear();
+            m_file.open(shardName(m_prefix, m_shards), std::ios::binary | std::ios::trunc);
+            Header header;
+            std::memcpy(header.magic, "SKTD", 4);
+            header.version = version;
+            header.sampleSize = sizeof(Sample);
+            m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            m_inShard = 0;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_shards;
+        }
+        const size_t count = std::min(samples.size() - start, m_samplesPerShard - m_inShard);
+        m_file.write(reinterpret_cast<const char *>(samples.data() + start), std::streamsize(count * sizeof(Sample)));
+        m_inShard += count;
+        start += count;
+    }
+}
+
+Reader::Reader(const std::string& fileName)
+    : m_file(fileName, std::ios::binary),
+      m_valid(false)
+{
+    Header header;
+    if (m_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        m_valid = std::memcmp(header.magic, "SKTD", 4) == 0 && header.version == version && header.sampleSize == sizeof(Sample);
+}
+
+size_t Reader::read(Sample *samples, size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid)
+        return 0;
+    m_file.read(reinterpret_cast<char *>(samples), std::streamsize(count * sizeof(Sample)));
+    // a sample cut off at the end of the file is left out
+    return size_t(m_file.gcount()) / sizeof(Sample);
+}
+
+bool readShard(const std::string& fileName, std::vector<Sample>& samples)
+{
+    Reader reader(fileName);
+    if (!reader.isOpen())
+        return false;
+    constexpr size_t chunkSize = 4096;
+    size_t count;
+    do {
+        const size_t size = samples.size();
+        samples.resize(size + chunkSize);
+        count = reader.read(samples.data() + size, chunkSize);
+        samples.resize(size + count);
+    } while (count == chunkSize);
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Position.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SchafKopf
+{
+
+// A position from a played game, the card that was played there and what
+// the declarer team took from there on. The cards each player took are
+// not kept, only the points of the declarer team.
+struct Sample
+{
+    CardMask hands[numPlayers];
+    CardMask played;
+    uint8_t trick[numPlayers];
+    // type * numColors + color
+    uint8_t game;
+    uint8_t leader;
+    uint8_t numInTrick;
+    uint8_t declarerTeam;
+    uint8_t move;
+    // what the declarer team had and what it took from here on
+    uint8_t won;
+    uint8_t points;
+    uint8_t unused;
+
+    const Rules& rules() const { return Rules::get(Game::Type(game / numColors), Color(game % numColors)); }
+
+    // the position, with nothing taken by anybody
+    Position position() const;
+
+    // the sample for the player to move in position, who plays move
+    static Sample make(const Position& position, int move);
+};
+
+static_assert(sizeof(Sample) == 32, "samples are written as they are");
+
+// Files of Samples after a small header. Writers fill shards of a fixed
+// number of samples, prefix-0000.bin, prefix-0001.bin and so on, readers
+// go through one shard at a time.
+namespace TrainingData
+{
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t sampleSize;
+};
+
+static constexpr uint32_t version = 1;
+
+std::string shardName(const std::string& prefix, int shard);
+
+// Takes batches of samples from any number of threads and writes them in
+// a thread of its own, so players never wait for the disk unless
+// maxQueued batches pile up. The destructor writes what is left.
+class ShardWriter
+{
+public:
+    explicit ShardWriter(const std::string& prefix, size_t samplesPerShard = size_t(1) << 20, size_t maxQueued = 256);
+    ~ShardWriter();
+
+    ShardWriter(const ShardWriter&) = delete;
+    ShardWriter& operator=(const ShardWriter&) = delete;
+
+    void write(std::vector<Sample>&& samples);
+
+    // waits until everything so far is written and flushed
+    void flush();
+
+    // false once a shard could not be written
+    bool ok() const;
+
+    size_t numWritten() const;
+    int numShards() const;
+
+private:
+    void run();
+    void writeBatch(const std::vector<Sample>& samples);
+
+    const std::string m_prefix;
+    const size_t m_samplesPerShard;
+    const size_t m_maxQueued;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::deque<std::vector<Sample>> m_queue;
+    bool m_busy;
+    bool m_stop;
+
+    // written by the writer thread, read under the mutex
+    std::ofstream m_file;
+    size_t m_inShard;
+    size_t m_written;
+    int m_shards;
+    bool m_ok;
+
+    std::thread m_thread;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const std::string& fileName);
+
+    // false if the file cannot be opened or has no valid header
+    bool isOpen() const { return m_valid; }
+
+    // Up to count of the next samples, returns how many. Threads may share
+    // a reader, each taking chunks of samples.
+    size_t read(Sample *samples, size_t count);
+
+private:
+    std::mutex m_mutex;
+    std::ifstream m_file;
+    bool m_valid;
+};
+
+// appends all samples of a shard to samples, false if it has no valid header
+bool readShard(const std::string& fileName, std::vector<Sample>& samples);
+
+}
+
+}
@@ -0,0 +1,325 @@
+#include "WorldCache.h"
+
+#include <limits>
+
+namespace SchafKopf
+{
+
+WorldCache::WorldCache(int player, int numWorlds, uint32_t seed)
+    : m_player(player),
+      m_numWorlds(numWorlds),
+      m_engine(seed),
+      m_model(nullptr),
+      m_hidden(0),
+      m_numDrawn(0),
+      m_numDropped(0),
+      m_numRepaired(0)
+{
+    for (int p = 0; p < numPlayers; ++p) {
+        m_handSizes[p] = 0;
+        m_excluded[p] = 0;
+    }
+}
+
+void WorldCache::reset(const Position& position)
+{
+    m_view = position;
+    m_hidden = 0;
+    for (int p = 0; p < numPlayers; ++p) {
+        m_handSizes[p] = popCount(position.hands[p]);
+        m_excluded[p] = 0;
+        if (p != m_player) {
+            m_hidden |= position.hands[p];
+            m_view.hands[p] = 0;
+        }
+    }
+    m_start = m_view;
+    m_plays.clear();
+
+    m_worlds.clear();
+    m_numDrawn = 0;
+    m_numDropped = 0;
+    m_numRepaired = 0;
+    m_solver.clear();
+}
+
+void WorldCache::exclude(int who, CardMask cards)
+{
+    if (who == m_player)
+        return;
+    m_excluded[who] |= cards & m_hidden;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_worlds.size(); ++i) {
+        if (!(m_worlds[i].deal.hands[who] & cards))
+            m_worlds[kept++] = m_worlds[i];
+    }
+    m_numDropped += int(m_worlds.size() - kept);
+    m_worlds.resize(kept);
+}
+
+void WorldCache::cardPlayed(int card)
+{
+    const int who = m_view.toMove();
+    const CardMask bit = cardBit(card);
+    const Position before = m_view;
+    m_plays.push_back(uint8_t(card));
+    --m_handSizes[who];
+
+    // the view knows no hidden cards, so the card is put into the hand to play it
+    m_view.hands[who] |= bit;
+    m_view.play(card);
+
+    if (who == m_player) {
+        for (World& world : m_worlds)
+            world.deal.hands[who] &= ~bit;
+        return;
+    }
+
+    m_hidden &= ~bit;
+    for (int p = 0; p < numPlayers; ++p)
+        m_excluded[p] &= ~bit;
+
+    // whoever does not follow has nothing of the suit that was led
+    CardMask voids = 0;
+    if (before.numInTrick) {
+        const int leadSuit = m_view.rules->suit(before.trick[0]);
+        if (m_view.rules->suit(card) != leadSuit)
+            voids = m_view.rules->suitMask(leadSuit) & m_hidden;
+    }
+    m_excluded[who] |= voids;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_worlds.size(); ++i) {
+        World& world = m_worlds[i];
+        if (!(world.deal.hands[who] & bit) || (world.deal.hands[who] & voids)) {
+            if (!repair(world.deal, who, bit))
+                continue;
+            world.deal.hands[who] &= ~bit;
+            world.logWeight = replay(world.deal);
+            world.solvedPly = -1;
+            ++m_numRepaired;
+        } else {
+            if (m_model) {
+                Position position = before;
+                for (int p = 0; p < numPlayers; ++p)
+                    position.hands[p] = world.deal.hands[p];
+                world.logWeight += std::log(m_model->probability(position, card));
+            }
+            world.deal.hands[who] &= ~bit;
+        }
+        m_worlds[kept++] = world;
+    }
+    m_numDropped += int(m_worlds.size() - kept);
+    m_worlds.resize(kept);
+}
+
+double WorldCache::replay(const Deal& deal) const
+{
+    if (!m_model)
+        return 0;
+
+    // the hands at reset() in this world
+    Position position = m_start;
+    for (int p = 0; p < numPlayers; ++p)
+        position.hands[p] = deal.hands[p];
+    {
+        Position view = m_start;
+        for (uint8_t card : m_plays) {
+            position.hands[view.toMove()] |= cardBit(card);
+            view.hands[view.toMove()] |= cardBit(card);
+            view.play(card);
+        }
+    }
+
+    double result = 0;
+    for (uint8_t card : m_plays) {
+        if (position.toMove() != m_player)
+            result += std::log(m_model->probability(position, card));
+        position.play(card);
+    }
+    return result;
+}
+
+std::vector<double> WorldCache::weights() const
+{
+    // subtract the largest log weight before going back from log space
+    double largest = -std::numeric_limits<double>::infinity();
+    for (const World& world : m_worlds)
+        largest = std::max(largest, world.logWeight);
+
+    std::vector<double> result;
+    double sum = 0;
+    for (const World& world : m_worlds) {
+        result.push_back(std::exp(world.logWeight - largest));
+        sum += result.back();
+    }
+    for (double& weight : result)
+        weight /= sum;
+    return result;
+}
+
+double WorldCache::effectiveSampleSize() const
+{
+    if (m_worlds.empty())
+        return 0;
+    double squares = 0;
+    for (double weight : weights())
+        squares += weight * weight;
+    return 1 / squares;
+}
+
+void WorldCache::resample()
+{
+    if (m_worlds.empty())
+        return;
+
+    const std::vector<double> weights = this->weights();
+    std::vector<World> result;
+    const double step = 1.0 / m_numWorlds;
+    double position = std::uniform_real_distribution<double>(0, step)(m_engine);
+    double sum = weights[0];
+    for (size_t i = 0; int(result.size()) < m_numWorlds; position += step) {
+        while (position > sum && i + 1 < weights.size())
+            sum += weights[++i];
+        result.push_back(m_worlds[i]);
+        result.back().logWeight = 0;
+    }
+    m_worlds.swap(result);
+}
+
+// swaps a card of who for one of another player that both may hold
+bool WorldCache::swapOut(Deal& deal, int who, int card)
+{
+    for (int p = 0; p < numPlayers; ++p) {
+        if (p == who || p == m_player || ((m_excluded[p] >> card) & 1))
+            continue;
+        const CardMask candidates = deal.hands[p] & ~m_excluded[who];
+        if (!candidates)
+            continue;
+        const int other = nthCard(candidates, int(m_engine() % unsigned(popCount(candidates))));
+        deal.hands[p] ^= cardBit(other) | cardBit(card);
+        deal.hands[who] ^= cardBit(other) | cardBit(card);
+        return true;
+    }
+    return false;
+}
+
+// Brings a world in line with who playing card: the card moves to who in
+// exchange for a card its holder may have, then cards of suits who has
+// shown to be void in go to other players in exchange for cards who may
+// have. false if there is no such exchange.
+bool WorldCache::repair(Deal& deal, int who, CardMask card)
+{
+    if (!(deal.hands[who] & card)) {
+        int holder = 0;
+        while (!(deal.hands[holder] & card))
+            ++holder;
+        const CardMask candidates = deal.hands[who] & ~m_excluded[holder];
+        if (!candidates)
+            return false;
+        const CardMask other = cardBit(nthCard(candidates, int(m_engine() % unsigned(popCount(candidates)))));
+        deal.hands[holder] ^= other | card;
+        deal.hands[who] ^= other | card;
+    }
+
+    for (CardMask wrong = deal.hands[who] & m_excluded[who]; wrong; wrong &= wrong - 1) {
+        if (!swapOut(deal, who, lowestCard(wrong)))
+            return false;
+    }
+    return consistent(deal);
+}
+
+bool WorldCache::consistent(const Deal& deal) const
+{
+    for (int p = 0; p < numPlayers; ++p) {
+        if (p != m_player && (deal.hands[p] & m_excluded[p]))
+            return false;
+    }
+    return true;
+}
+
+// Deals the hidden cards one by one, in random order, to a random player
+// that may have the card and still has room. The most constrained cards
+// go first, so this rarely gets stuck; it is close to uniform, though not
+// exactly, once there are many exclusions.
+bool WorldCache::draw(Deal& deal)
+{
+    uint8_t cards[numCards];
+    int numCardsLeft = 0;
+    for (CardMask hidden = m_hidden; hidden; hidden &= hidden - 1)
+        cards[numCardsLeft++] = uint8_t(lowestCard(hidden));
+    std::shuffle(cards, cards + numCardsLeft, m_engine);
+
+    auto allowed = [this](int card) {
+        int count = 0;
+        for (int p = 0; p < numPlayers; ++p)
+            count += p != m_player && !((m_excluded[p] >> card) & 1);
+        return count;
+    };
+    std::stable_sort(cards, cards + numCardsLeft, [&](uint8_t a, uint8_t b) { return allowed(a) < allowed(b); });
+
+    int room[numPlayers];
+    for (int p = 0; p < numPlayers; ++p) {
+        room[p] = p == m_player ? 0 : m_handSizes[p];
+        deal.hands[p] = p == m_player ? m_view.hands[m_player] : 0;
+    }
+    for (int i = 0; i < numCardsLeft; ++i) {
+        int candidates[numPlayers];
+        int numCandidates = 0;
+        for (int p = 0; p < numPlayers; ++p) {
+            if (room[p] && !((m_excluded[p] >> cards[i]) & 1))
+                candidates[numCandidates++] = p;
+        }
+        if (!numCandidates)
+            return false;
+        const int p = candidates[m_engine() % unsigned(numCandidates)];
+        deal.hands[p] |= cardBit(cards[i]);
+        --room[p];
+    }
+    return true;
+}
+
+void WorldCache::topUp()
+{
+    for (int tries = 0; int(m_worlds.size()) < m_numWorlds && tries < 64 * m_numWorlds; ++tries) {
+        World world;
+        if (!draw(world.deal))
+            continue;
+        assert(consistent(world.deal));
+        world.logWeight = replay(world.deal);
+        world.solvedPly = -1;
+        m_worlds.push_back(world);
+        ++m_numDrawn;
+    }
+}
+
+const MoveMatrix& WorldCache::solve(const Position& position)
+{
+    assert(position.rules == m_view.rules);
+    assert(position.played == m_view.played && position.numInTrick == m_view.numInTrick);
+    assert(position.hands[m_player] == m_view.hands[m_player]);
+
+    topUp();
+
+    MoveMatrix& matrix = m_matrix;
+    matrix.numWorlds = int(m_worlds.size());
+    matrix.numMoves = 0;
+    for (CardMask moves = position.legalMoves(); moves; moves &= moves - 1)
+        matrix.moves[matrix.numMoves++] = uint8_t(lowestCard(moves));
+    matrix.values.resize(m_worlds.size() * size_t(matrix.numMoves));
+    matrix.weights = weights();
+
+    for (size_t w = 0; w < m_worlds.size(); ++w) {
+        World& world = m_worlds[w];
+        if (world.solvedPly != ply()) {
+            const MoveMatrix values = m_solver.solveWorlds(position, &world.deal, 1);
+            std::copy(values.values.begin(), values.values.end(), world.values);
+            world.solvedPly = ply();
+        }
+        std::copy(world.values, world.values + matrix.numMoves, matrix.values.begin() + long(w) * matrix.numMoves);
+    }
+    return matrix;
+}
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "PlayModel.h"
+#include "Solver.h"
+
+#include <random>
+
+namespace SchafKopf
+{
+
+// The deals one player imagines for the cards the player cannot see,
+// kept from one decision to the next.
+//
+// Every played card is checked against the worlds. Worlds in which the
+// card was in another hand, or in which a player who did not follow suit
+// still holds that suit, are repaired by exchanging as few cards as
+// possible between the hidden hands and dropped only if that fails; the
+// others just lose the card. Only missing worlds are drawn again. The
+// solver with its table stays, and so do the values of worlds that needed
+// no repair, so later decisions of a game reuse what earlier ones searched.
+//
+// With a PlayModel every world carries the log of the likelihood of the
+// cards the others played, had they held the cards of that world. Each
+// played card adds its log probability; new and repaired worlds replay
+// the game from reset() instead. solve() passes the weights on with the
+// values, and resample() turns them back into equally weighted worlds
+// when too few of them count.
+class WorldCache
+{
+public:
+    struct World
+    {
+        // the cards every player has left in this world
+        Deal deal;
+        // log likelihood of the plays of the others, up to a constant
+        double logWeight;
+        // values of the legal moves at ply solvedPly, if solved there
+        int solvedPly;
+        int16_t values[Player::maxCards];
+    };
+
+    WorldCache(int player, int numWorlds, uint32_t seed = 1);
+
+    int player() const { return m_player; }
+    int numWorlds() const { return m_numWorlds; }
+    const std::vector<World>& worlds() const { return m_worlds; }
+
+    // Starts a game at position, of which only what player can see is
+    // used: the own hand, the cards gone and the number of cards of the
+    // others. Drops all worlds and clears the solver.
+    void reset(const Position& position);
+
+    // the player to move played card
+    void cardPlayed(int card);
+
+    // drops all worlds but keeps the solver, the next solve() draws new ones
+    void clearWorlds() { m_worlds.clear(); }
+
+    // cards who cannot have, from anything else the player knows
+    void exclude(int who, CardMask cards);
+
+    // weights the worlds from now on, nullptr weights all the same
+    void setPlayModel(const PlayModel *model) { m_model = model; }
+
+    // draws worlds until there are numWorlds, solve() does that as well
+    void topUp();
+
+    // Tops the worlds up and solves the legal moves of position, which must
+    // be the current state, in every world. Worlds that were solved at this
+    // ply before are not solved again. The matrix rows are the worlds, with
+    // weights() as their weights.
+    const MoveMatrix& solve(const Position& position);
+
+    // the weights of the worlds, adding up to 1
+    std::vector<double> weights() const;
+
+    // (sum of weights)^2 / sum of squared weights: how many equally
+    // weighted worlds the weighted ones are worth
+    double effectiveSampleSize() const;
+
+    // Draws numWorlds worlds from the current ones in proportion to their
+    // weights (systematic resampling), all weighted equally afterwards.
+    // Heavy worlds are kept several times, light ones are gone.
+    void resample();
+
+    // worlds drawn, dropped and repaired since reset()
+    int numDrawn() const { return m_numDrawn; }
+    int numDropped() const { return m_numDropped; }
+    int numRepaired() const { return m_numRepaired; }
+
+    Solver& solver() { return m_solver; }
+
+private:
+    bool consistent(const Deal& deal) const;
+    bool draw(Deal& deal);
+    bool repair(Deal& deal, int who, CardMask card);
+    bool swapOut(Deal& deal, int who, int card);
+    // the log likelihood of all plays since reset() for a new world
+    double replay(const Deal& deal) const;
+
+    int ply() const { return popCount(m_view.played) + m_view.numInTrick; }
+
+    int m_player;
+    int m_numWorlds;
+    std::minstd_rand m_engine;
+    const PlayModel *m_model;
+
+    // the game as the player sees it, with empty hands for the others,
+    // at reset() and now, and the cards played in between
+    Position m_start;
+    Position m_view;
+    std::vector<uint8_t> m_plays;
+
+    // the cards nobody but the player has seen, and how many each other player holds
+    CardMask m_hidden;
+    int m_handSizes[numPlayers];
+    CardMask m_excluded[numPlayers];
+
+    std::vector<World> m_worlds;
+    int m_numDrawn;
+    int m_numDropped;
+    int m_numRepaired;
+
+    Solver m_solver;
+    MoveMatrix m_matrix;
+};
+
+}
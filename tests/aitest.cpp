@@ -48,6 +48,16 @@ public:
         observerAi.cardPlayed(pile, player);
     }
 
+    void snapshot(Snapshot& snapshot) const override
+    {
+        observerAi.snapshot(snapshot);
+    }
+
+    void restore(const Snapshot& snapshot) override
+    {
+        observerAi.restore(snapshot);
+    }
+
     ObserverAi observerAi;
     RandomAi randomAi;
 };
@@ -78,6 +88,23 @@ TEST(TestRandomAi, randomGame)
     // make sure 8 rounds were played
     GTEST_ASSERT_EQ(8, game.numStiche);
 
+    // the stiche of every player add up to the cards the player won
+    unsigned allStiche = 0;
+    for (const Player& player : game.players) {
+        const unsigned stiche = game.wonStiche(player.id);
+        GTEST_ASSERT_EQ(0u, allStiche & stiche);
+        allStiche |= stiche;
+        uint32_t cards = 0;
+        for (int i = 0; i < game.numStiche; ++i) {
+            if (!((stiche >> i) & 1))
+                continue;
+            for (const auto& played : game.stich(i).cards)
+                cards |= 1u << played.second.hashValue();
+        }
+        GTEST_ASSERT_EQ(player.wonCards, cards);
+    }
+    GTEST_ASSERT_EQ(0xffu, allStiche);
+
     // total acquired points must be 120
     int points = 0;
     for(const Player& player : game.players)
@@ -114,6 +141,20 @@ void testObservations(const Game& game, const TestAi testAi[4])
                 else if (info.colorFree[color] == PlayerInfo::No)
                     ASSERT_TRUE(hasColor[color]) << "Player " << player + 1 << " ai " << i + 1 << " color " << colorNames[color] << std::endl << game.activePile;
             }
+
+            // the beliefs never rule out a card the player holds
+            if (i == player)
+                continue;
+            const Beliefs& beliefs = testAi[i].observerAi.beliefs();
+            const CardMask hand = handMask(game.players[player]);
+            float sum = 0;
+            for (int card = 0; card < numCards; ++card) {
+                if ((hand >> card) & 1) {
+                    ASSERT_GT(beliefs.probability(player, card), 0.0f);
+                }
+                sum += beliefs.probability(player, card);
+            }
+            ASSERT_NEAR(popCount(hand), sum, 1e-2);
         }
     }
 }
@@ -149,8 +190,166 @@ TEST(TestAi, randomObservedGame)
         }
 
         if (verbose) {
-            std::cout << game.lastStichPlayer().lastStich() << std::endl;
+            std::cout << game.lastStich() << std::endl;
             std::cout << "-> winner: " << game.m_lastStichPlayer + 1 << std::endl;
         }
     }
 }
+
+static bool sameSnapshot(const AI& ai, const AI& other)
+{
+    AI::Snapshot a;
+    AI::Snapshot b;
+    ai.snapshot(a);
+    other.snapshot(b);
+    return std::memcmp(a.data, b.data, sizeof(ObserverAi::State)) == 0;
+}
+
+TEST(TestAi, snapshots)
+{
+    Game game;
+    game.gameType = Game::Solo;
+    game.gameColor = Color::Herz;
+
+    TestAi testAi[4] = {
+        {game, game.players[0]},
+        {game, game.players[1]},
+        {game, game.players[2]},
+        {game, game.players[3]}
+    };
+    for (int i = 0; i < 4; ++i)
+        game.ais[i] = &testAi[i];
+
+    // the same deal in a second game, observed by a second set of AIs
+    Game simulation;
+    simulation.gameType = game.gameType;
+    simulation.gameColor = game.gameColor;
+    simulation.deck = game.deck;
+    simulation.redeal();
+    ObserverAi simulated[4] = {
+        {simulation, simulation.players[0]},
+        {simulation, simulation.players[1]},
+        {simulation, simulation.players[2]},
+        {simulation, simulation.players[3]}
+    };
+    for (int i = 0; i < 4; ++i)
+        simulation.ais[i] = &simulated[i];
+
+    // the cards of the simulation are at other places in the hands
+    auto playInSimulation = [&simulation](const Card& played) {
+        int card = 0;
+        while (!simulation.activePlayer().m_cards[card] || !(*simulation.activePlayer().m_cards[card] == played))
+            ++card;
+        simulation.putCard(card);
+    };
+
+    // the simulated AIs only observe from the clone on
+    for (int i = 0; i < 4; ++i)
+        simulation.ais[i] = nullptr;
+
+    AI::Snapshot snapshots[4];
+    for (int ply = 0; ply < 32; ++ply) {
+        if (ply == 10) {
+            for (int i = 0; i < 4; ++i) {
+                testAi[i].observerAi.snapshot(snapshots[i]);
+                simulated[i].cloneFrom(testAi[i].observerAi);
+                simulation.ais[i] = &simulated[i];
+            }
+        }
+
+        const int card = testAi[game.m_activePlayer].doPlayCard(game.activePile);
+        const Card played = *game.activePlayer().m_cards[card];
+        game.putCard(card);
+        playInSimulation(played);
+
+        if (ply >= 10) {
+            for (int i = 0; i < 4; ++i) {
+                ASSERT_TRUE(sameSnapshot(simulated[i], testAi[i].observerAi));
+                // rebuilt by restore() instead of updated card by card
+                for (int card = 0; card < numCards; ++card)
+                    ASSERT_NEAR(testAi[i].observerAi.beliefs().probability((i + 1) % 4, card),
+                                simulated[i].beliefs().probability((i + 1) % 4, card), 1e-2);
+            }
+        }
+    }
+
+    // going back to the snapshot
+    AI::Snapshot before;
+    testAi[0].observerAi.snapshot(before);
+    testAi[0].observerAi.restore(snapshots[0]);
+    AI::Snapshot restored;
+    testAi[0].observerAi.snapshot(restored);
+    ASSERT_EQ(0, std::memcmp(restored.data, snapshots[0].data, sizeof(ObserverAi::State)));
+    ASSERT_NE(0, std::memcmp(restored.data, before.data, sizeof(ObserverAi::State)));
+}
+
+// looks at the played cards only on its own turn
+class LazyTestAi : public TestAi
+{
+public:
+    LazyTestAi(const Game& game, const Player& player)
+        : TestAi(game, player)
+    {
+        setLazy(true);
+    }
+
+    int doPlayCard(const ActivePile &pile) override
+    {
+        observerAi.sync();
+        return TestAi::doPlayCard(pile);
+    }
+};
+
+TEST(TestAi, lazyObservers)
+{
+    Game game;
+    game.gameType = Game::Solo;
+    game.gameColor = Color::Herz;
+
+    LazyTestAi lazyAi[4] = {
+        {game, game.players[0]},
+        {game, game.players[1]},
+        {game, game.players[2]},
+        {game, game.players[3]}
+    };
+    // pushed to, but not playing
+    ObserverAi observers[4] = {
+        {game, game.players[0]},
+        {game, game.players[1]},
+        {game, game.players[2]},
+        {game, game.players[3]}
+    };
+    for (int i = 0; i < 4; ++i)
+        game.ais[i] = &lazyAi[i];
+
+    auto sameState = [](const AI& ai, const AI& other) {
+        AI::Snapshot a;
+        AI::Snapshot b;
+        ai.snapshot(a);
+        other.snapshot(b);
+        return std::memcmp(a.data, b.data, sizeof(ObserverAi::State)) == 0;
+    };
+
+    std::minstd_rand engine(59);
+    for (int round = 0; round < 3; ++round) {
+        for (int ply = 0; ply < 32; ++ply) {
+            // the lazy AI catches up on its turn
+            const int player = game.m_activePlayer;
+            const int card = lazyAi[player].doPlayCard(game.activePile);
+            // after a redeal, the pushed observers only reset with the first card
+            observers[player].sync();
+            ASSERT_TRUE(sameState(lazyAi[player], observers[player]));
+
+            game.putCard(card);
+            for (ObserverAi& observer : observers)
+                observer.cardPlayed(game.activePile, player);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            lazyAi[i].observerAi.sync();
+            ASSERT_TRUE(sameState(lazyAi[i], observers[i]));
+        }
+
+        game.redeal(engine);
+    }
+}
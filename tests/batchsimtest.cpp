@@ -0,0 +1,79 @@
+#include <BatchSim.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+TEST(TestBatchSim, firstLegal)
+{
+    std::minstd_rand engine(19);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Eichel);
+        constexpr size_t numGames = 21;
+        BatchSim sim(rules, numGames);
+
+        Position positions[numGames];
+        for (size_t i = 0; i < numGames; ++i) {
+            const Deal deal = randomDeal(engine);
+            const int declarer = int(i % numPlayers);
+            const int leader = int(i / numPlayers % numPlayers);
+            sim.setGame(i, deal, declarer, leader);
+            positions[i] = Position(rules, deal, declarer, leader);
+            while (!positions[i].finished())
+                positions[i].play(lowestCard(positions[i].legalMoves()));
+        }
+
+        sim.run(BatchSim::FirstLegal);
+        for (size_t i = 0; i < numGames; ++i) {
+            for (int p = 0; p < numPlayers; ++p)
+                ASSERT_EQ(positions[i].won[p], sim.won(i, p));
+            ASSERT_EQ(positions[i].declarerTeam, sim.declarerTeam(i));
+            ASSERT_EQ(positions[i].declarerPoints(), sim.declarerPoints(i));
+        }
+    }
+}
+
+TEST(TestBatchSim, randomLegal)
+{
+    std::minstd_rand engine(23);
+    const Rules rules(Game::SauSpiel, Gras);
+    constexpr size_t numGames = 100;
+
+    BatchSim scalar(rules, numGames);
+    BatchSim simd(rules, numGames);
+    scalar.setUseAvx2(false);
+    ASSERT_FALSE(scalar.usesAvx2());
+
+    for (size_t i = 0; i < numGames; ++i) {
+        const Deal deal = randomDeal(engine);
+        scalar.setGame(i, deal, 1, 0);
+        simd.setGame(i, deal, 1, 0);
+    }
+
+    scalar.run(BatchSim::RandomLegal, 7);
+    simd.run(BatchSim::RandomLegal, 7);
+
+    for (size_t i = 0; i < numGames; ++i) {
+        CardMask all = 0;
+        for (int p = 0; p < numPlayers; ++p) {
+            ASSERT_EQ(scalar.won(i, p), simd.won(i, p));
+            ASSERT_EQ(0u, all & scalar.won(i, p));
+            all |= scalar.won(i, p);
+        }
+        ASSERT_EQ(allCards, all);
+        ASSERT_EQ(scalar.declarerPoints(i), simd.declarerPoints(i));
+    }
+
+    // the same deals with another seed are played differently
+    const CardMask won = simd.won(0, 0);
+    int numDifferent = 0;
+    simd.run(BatchSim::RandomLegal, 8);
+    for (size_t i = 0; i < numGames; ++i)
+        numDifferent += simd.won(i, 0) != scalar.won(i, 0);
+    ASSERT_GT(numDifferent, 0);
+
+    simd.run(BatchSim::RandomLegal, 7);
+    ASSERT_EQ(won, simd.won(0, 0));
+}
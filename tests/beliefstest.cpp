@@ -0,0 +1,115 @@
+#include <Beliefs.h>
+#include <Position.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+static void assertSums(const Beliefs& beliefs)
+{
+    for (int card = 0; card < numCards; ++card) {
+        float sum = 0;
+        for (int p = 0; p < numPlayers; ++p)
+            sum += beliefs.probability(p, card);
+        ASSERT_NEAR((beliefs.hidden() >> card) & 1 ? 1.0f : 0.0f, sum, 1e-4);
+    }
+    for (int p = 0; p < numPlayers; ++p) {
+        if (p == beliefs.player())
+            continue;
+        float sum = 0;
+        for (int card = 0; card < numCards; ++card)
+            sum += beliefs.probability(p, card);
+        ASSERT_NEAR(beliefs.handSize(p), sum, Beliefs::tolerance);
+    }
+}
+
+// without any voids, every hidden card is with each of the others alike
+TEST(TestBeliefs, uniform)
+{
+    const int handSizes[numPlayers] = { 8, 8, 8, 8 };
+    Beliefs beliefs;
+    beliefs.reset(2, ~colorMask(Eichel), handSizes);
+
+    for (int card = 0; card < numCards; ++card) {
+        const bool hidden = !((colorMask(Eichel) >> card) & 1);
+        ASSERT_EQ(0.0f, beliefs.probability(2, card));
+        for (int p : { 0, 1, 3 })
+            ASSERT_NEAR(hidden ? 1.0f / 3 : 0.0f, beliefs.probability(p, card), 1e-6);
+    }
+}
+
+// Six cards, two for each of the others, and player 1 has no Schelln:
+// the two Schelln split between players 2 and 3, the rest is filled up.
+// Here the fitted matrix is also what all 36 consistent deals give.
+TEST(TestBeliefs, voids)
+{
+    const CardMask schelln = cardBit(Card{ Ass, Schelln }) | cardBit(Card{ Koenig, Schelln });
+    const CardMask others = cardBit(Card{ Ass, Gras }) | cardBit(Card{ Koenig, Gras })
+            | cardBit(Card{ Ass, Herz }) | cardBit(Card{ Koenig, Herz });
+    const int handSizes[numPlayers] = { 2, 2, 2, 2 };
+
+    for (int avx2 = 0; avx2 < 2; ++avx2) {
+        Beliefs beliefs;
+        beliefs.setUseAvx2(avx2);
+        beliefs.reset(0, schelln | others, handSizes);
+        beliefs.exclude(1, schelln);
+        beliefs.update();
+        ASSERT_NO_FATAL_FAILURE(assertSums(beliefs));
+
+        for (CardMask rest = schelln; rest; rest &= rest - 1) {
+            ASSERT_EQ(0.0f, beliefs.probability(1, lowestCard(rest)));
+            ASSERT_NEAR(0.5f, beliefs.probability(2, lowestCard(rest)), 1e-3);
+        }
+        for (CardMask rest = others; rest; rest &= rest - 1) {
+            ASSERT_NEAR(0.5f, beliefs.probability(1, lowestCard(rest)), 1e-3);
+            ASSERT_NEAR(0.25f, beliefs.probability(3, lowestCard(rest)), 1e-3);
+        }
+        ASSERT_NEAR(2.0f, beliefs.expected(1, others), 1e-3);
+    }
+}
+
+// following a game card by card, the AVX2 kernel and the scalar one agree
+TEST(TestBeliefs, followsGame)
+{
+    std::minstd_rand engine(103);
+    const Rules rules(Game::Solo, Gras);
+
+    for (int game = 0; game < 20; ++game) {
+        Position position(rules, randomDeal(engine), game % numPlayers, 0);
+        int handSizes[numPlayers];
+        for (int p = 0; p < numPlayers; ++p)
+            handSizes[p] = popCount(position.hands[p]);
+        const CardMask hidden = allCards & ~position.hands[0];
+
+        Beliefs beliefs[2];
+        for (int avx2 = 0; avx2 < 2; ++avx2) {
+            beliefs[avx2].setUseAvx2(avx2);
+            beliefs[avx2].reset(0, hidden, handSizes);
+        }
+
+        while (popCount(position.played) < 24) {
+            const int who = position.toMove();
+            const CardMask moves = position.legalMoves();
+            const int card = nthCard(moves, int(engine() % popCount(moves)));
+            const int leadSuit = position.numInTrick ? rules.suit(position.trick[0]) : -1;
+            position.play(card);
+
+            for (Beliefs& b : beliefs) {
+                b.cardPlayed(who, card);
+                if (leadSuit >= 0 && rules.suit(card) != leadSuit)
+                    b.exclude(who, rules.suitMask(leadSuit));
+                b.update();
+            }
+            ASSERT_NO_FATAL_FAILURE(assertSums(beliefs[0]));
+            for (int p = 1; p < numPlayers; ++p) {
+                for (int c = 0; c < numCards; ++c) {
+                    ASSERT_NEAR(beliefs[0].probability(p, c), beliefs[1].probability(p, c), 1e-4);
+                    if ((position.hands[p] >> c) & 1) {
+                        ASSERT_GT(beliefs[0].probability(p, c), 0.0f);
+                    }
+                }
+            }
+        }
+    }
+}
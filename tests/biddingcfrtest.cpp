@@ -0,0 +1,121 @@
+#include <BiddingCfr.h>
+#include <Canonical.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+using namespace SchafKopf;
+
+TEST(TestBiddingCfr, abstraction)
+{
+    std::minstd_rand engine(23);
+    for (int i = 0; i < 500; ++i) {
+        const CardMask hand = randomDeal(engine).hands[0];
+        const int bucket = CfrStrategy::bucket(hand);
+        ASSERT_GE(bucket, 0);
+        ASSERT_LT(bucket, CfrStrategy::numBuckets);
+
+        // the counts do not depend on the colors, only the Sauspiel does
+        for (int p = 0; p < ColorPermutation::numPermutations; ++p)
+            ASSERT_EQ(bucket >> 1, CfrStrategy::bucket(ColorPermutation::fromIndex(p).apply(hand)) >> 1);
+
+        for (int k = CfrStrategy::SauSpielKind; k < CfrStrategy::numKinds; ++k) {
+            if (k == CfrStrategy::SauSpielKind && !(bucket & 1))
+                continue;
+            const Contract contract = CfrStrategy::contract(CfrStrategy::Kind(k), hand);
+            ASSERT_TRUE(contract.isValid(hand));
+            ASSERT_EQ(k, CfrStrategy::kind(contract));
+        }
+    }
+
+    // a partner never doubles, the declarer may always say Re
+    const int node = CfrStrategy::doubleNode(CfrStrategy::SauSpielKind, 1, 0);
+    ASSERT_EQ(1u, CfrStrategy::legalActions(node, true, 0));
+    ASSERT_EQ(3u, CfrStrategy::legalActions(node, false, 0));
+    ASSERT_EQ(3u, CfrStrategy::legalActions(CfrStrategy::doubleNode(CfrStrategy::SoloKind, 2, CfrStrategy::reStage), true, 0));
+    // after a Wenz, only a Solo
+    ASSERT_EQ(1u | 1u << CfrStrategy::SoloKind,
+              CfrStrategy::legalActions(CfrStrategy::auctionNode(2, CfrStrategy::WenzKind, 0), false, 1));
+}
+
+TEST(TestBiddingCfr, solves)
+{
+    CfrSolver solver;
+    solver.run(15000, 1, 5);
+    solver.run(5000, 2, 6);
+    ASSERT_EQ(20000u, solver.numIterations());
+    const CfrStrategy strategy = solver.strategy();
+
+    for (int node = 0; node < CfrStrategy::numNodes; ++node) {
+        for (int team = 0; team < 2; ++team) {
+            for (int b = 0; b < CfrStrategy::numBuckets; ++b) {
+                const int infoSet = CfrStrategy::infoSet(node, team, b);
+                const unsigned legal = CfrStrategy::legalActions(node, team, b);
+                double total = 0;
+                for (int a = 0; a < CfrStrategy::numActions; ++a) {
+                    if (!((legal >> a) & 1)) {
+                        ASSERT_EQ(0.0, strategy.probability(infoSet, a));
+                    }
+                    total += strategy.probability(infoSet, a);
+                }
+                ASSERT_NEAR(1.0, total, 1e-3);
+            }
+        }
+    }
+
+    // the first seat announces more often with more trumps
+    std::minstd_rand engine(29);
+    double announced[2] = {};
+    int counts[2] = {};
+    for (int i = 0; i < 5000; ++i) {
+        const CardMask hand = randomDeal(engine).hands[0];
+        const int bucket = CfrStrategy::bucket(hand);
+        const int trumps = bucket / 128;
+        if (trumps != 0 && trumps < 3)
+            continue;
+        const int infoSet = CfrStrategy::infoSet(CfrStrategy::auctionNode(0, CfrStrategy::NoGame, 0), false, bucket);
+        announced[trumps != 0] += 1.0 - strategy.probability(infoSet, CfrStrategy::NoGame);
+        ++counts[trumps != 0];
+    }
+    ASSERT_LT(announced[0] / counts[0] + 0.2, announced[1] / counts[1]);
+
+    const std::string fileName = "biddingcfrtest.bin";
+    ASSERT_TRUE(strategy.write(fileName));
+    CfrStrategy loaded;
+    ASSERT_TRUE(loaded.load(fileName));
+    std::remove(fileName.c_str());
+    for (int infoSet = 0; infoSet < CfrStrategy::numInfoSets; infoSet += 97) {
+        for (int a = 0; a < CfrStrategy::numActions; ++a)
+            ASSERT_EQ(strategy.probability(infoSet, a), loaded.probability(infoSet, a));
+    }
+
+    // whatever it samples is a bid the auction takes
+    CfrBiddingAi ai(strategy, 31);
+    for (int i = 0; i < 500; ++i) {
+        const Deal deal = randomDeal(engine);
+        Auction auction(i % numPlayers);
+        while (!auction.finished()) {
+            const CardMask hand = deal.hands[auction.activeSeat()];
+            const std::optional<Contract> contract = ai.bid(auction, hand);
+            if (contract) {
+                ASSERT_TRUE(auction.canBid(*contract, hand));
+            }
+            auction.bid(contract);
+        }
+        if (!auction.hasContract())
+            continue;
+        const int declarer = auction.declarer();
+        const Contract& contract = auction.contract();
+        const int team = declarerTeam(contract.type, contract.color, declarer, deal.hands);
+        for (int s = 1; s < numPlayers; ++s) {
+            const int seat = (declarer + s) % numPlayers;
+            const bool doubles = ai.kontra(auction, seat, deal.hands[seat], (team >> seat) & 1);
+            if ((team >> seat) & 1) {
+                ASSERT_FALSE(doubles);
+            }
+        }
+        ai.re(auction, deal.hands[declarer]);
+    }
+}
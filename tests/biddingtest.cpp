@@ -0,0 +1,123 @@
+#include <Bidding.h>
+#include <RandomAi.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+static CardMask cards(std::initializer_list<Card> list)
+{
+    CardMask result = 0;
+    for (const Card& card : list)
+        result |= cardBit(card);
+    return result;
+}
+
+TEST(TestPosition, sameSticheAsGame)
+{
+    for (int type = 0; type < numGameTypes; ++type) {
+        Game game;
+        game.gameType = Game::Type(type);
+        game.gameColor = Gras;
+
+        RandomAi randomAi[4] = {
+            {game, game.players[0]},
+            {game, game.players[1]},
+            {game, game.players[2]},
+            {game, game.players[3]}
+        };
+
+        const Rules rules(game.gameType, game.gameColor);
+        Position position = Position::fromGame(game, rules);
+
+        for (int i = 0; i < 32; ++i) {
+            ASSERT_EQ(int(game.m_activePlayer), position.toMove());
+
+            const int c = randomAi[game.m_activePlayer].doPlayCard(game.activePile);
+            const Card card = *game.activePlayer().m_cards[c];
+            ASSERT_TRUE(position.legalMoves() & cardBit(card));
+
+            game.putCard(c);
+            position.play(cardIndex(card));
+
+            if (game.activePile.isEmpty()) {
+                ASSERT_EQ(game.m_lastStichPlayer, position.leader) << GameTypeNames[type];
+            }
+        }
+
+        ASSERT_TRUE(position.finished());
+        for (int i = 0; i < numPlayers; ++i)
+            ASSERT_EQ(game.players[i].points, maskPoints(position.won[i]));
+    }
+}
+
+TEST(TestBidding, auction)
+{
+    const CardMask hand = cards({{Siebner, Gras}, {Ass, Eichel}});
+
+    // cannot call the Herz Sau, a Sau of one's own or a color without cards
+    ASSERT_FALSE((Contract{Game::SauSpiel, Herz}).isValid(hand));
+    ASSERT_FALSE((Contract{Game::SauSpiel, Eichel}).isValid(hand));
+    ASSERT_FALSE((Contract{Game::SauSpiel, Schelln}).isValid(hand));
+    ASSERT_TRUE((Contract{Game::SauSpiel, Gras}).isValid(hand));
+
+    Auction auction(2);
+    ASSERT_EQ(2, auction.activeSeat());
+    auction.bid(Contract{Game::SauSpiel, Gras});
+
+    // a Sauspiel cannot beat a Sauspiel, a Wenz can
+    ASSERT_EQ(3, auction.activeSeat());
+    ASSERT_FALSE(auction.canBid(Contract{Game::SauSpiel, Gras}, hand));
+    ASSERT_TRUE(auction.canBid(Contract{Game::Wenz, Schelln}, hand));
+    auction.bid(Contract{Game::Wenz, Schelln});
+
+    // the earlier seat wins with the same priority
+    ASSERT_EQ(0, auction.activeSeat());
+    ASSERT_FALSE(auction.canBid(Contract{Game::Geier, Schelln}, hand));
+    auction.bid(std::optional<Contract>());
+
+    ASSERT_TRUE(auction.canBid(Contract{Game::Solo, Schelln}, hand));
+    auction.bid(Contract{Game::Solo, Schelln});
+
+    ASSERT_TRUE(auction.finished());
+    ASSERT_TRUE(auction.hasContract());
+    ASSERT_EQ(1, auction.declarer());
+    ASSERT_TRUE(auction.contract() == (Contract{Game::Solo, Schelln}));
+}
+
+TEST(TestBidding, evaluator)
+{
+    // all Ober and Unter - a sure Solo, Wenz or Geier
+    const CardMask strong = typeMask(Ober) | typeMask(Unter);
+
+    ContractEvaluator evaluator(32, 1);
+    ContractValue values[numContracts];
+    const int count = evaluator.evaluate(strong, 1, 0, values);
+
+    // no Sauspiel possible without color cards
+    ASSERT_EQ(numContracts - 3, count);
+    for (int i = 0; i < count; ++i) {
+        ASSERT_NE(Game::SauSpiel, values[i].contract.type);
+        if (values[i].contract.type == Game::Solo) {
+            ASSERT_EQ(1.0, values[i].winProbability);
+        }
+    }
+
+    // the same with expert rollouts, a sure game stays sure
+    evaluator.setExpertRollouts(true);
+    ContractValue expertValues[numContracts];
+    ASSERT_EQ(count, evaluator.evaluate(strong, 1, 0, expertValues));
+    for (int i = 0; i < count; ++i) {
+        if (expertValues[i].contract.type == Game::Solo) {
+            ASSERT_EQ(1.0, expertValues[i].winProbability);
+        }
+    }
+    evaluator.setExpertRollouts(false);
+
+    EvaluatorBiddingAi ai(evaluator);
+    Auction auction(0);
+    auction.bid(std::optional<Contract>());
+    const std::optional<Contract> contract = ai.bid(auction, strong);
+    ASSERT_TRUE(bool(contract));
+    ASSERT_EQ(2, contract->priority());
+}
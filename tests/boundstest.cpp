@@ -0,0 +1,84 @@
+#include <Bounds.h>
+#include <Ranking.h>
+#include <Solver.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+TEST(TestBounds, masterTrumps)
+{
+    const Rules& rules = Rules::get(Game::Solo, Herz);
+
+    // the declarer holds the four Ober, the others share the rest
+    Deal deal;
+    deal.hands[0] = typeMask(Ober) | typeMask(Siebner);
+    deal.hands[1] = typeMask(Unter) | typeMask(Achter);
+    deal.hands[2] = typeMask(Ass) | typeMask(Neuner);
+    deal.hands[3] = typeMask(Zehner) | typeMask(Koenig);
+    const Position position(rules, deal, 0, 1);
+
+    const SureTricks declarer = sureTricks(position, position.declarerTeam);
+    ASSERT_EQ(4, declarer.stiche);
+    ASSERT_EQ(12, declarer.points);
+
+    // the defenders lead a Schelln Achter, the declarer has to follow with the Siebner
+    const SureTricks defenders = sureTricks(position, ~position.declarerTeam & 0xf);
+    ASSERT_EQ(1, defenders.stiche);
+    ASSERT_EQ(4, defenders.points);
+
+    const Bounds points = pointBounds(position);
+    ASSERT_EQ(12, points.lower);
+    ASSERT_EQ(116, points.upper);
+    ASSERT_EQ(4, sticheBounds(position).lower);
+    ASSERT_EQ(7, sticheBounds(position).upper);
+}
+
+TEST(TestBounds, cashing)
+{
+    const Rules& rules = Rules::get(Game::Solo, Herz);
+
+    Deal deal;
+    deal.hands[0] = typeMask(Ober) | typeMask(Siebner);
+    deal.hands[1] = typeMask(Unter) | typeMask(Achter);
+    deal.hands[2] = typeMask(Ass) | typeMask(Neuner);
+    deal.hands[3] = typeMask(Zehner) | typeMask(Koenig);
+    const Position position(rules, deal, 0, 0);
+
+    // four Ober, the Herz Achter and three Unter have to follow, the others
+    // give their cheapest cards
+    const SureTricks declarer = sureTricks(position, position.declarerTeam);
+    ASSERT_EQ(4, declarer.stiche);
+    ASSERT_EQ(12 + 6 + 0 + 16, declarer.points);
+    ASSERT_EQ(0, sureTricks(position, ~position.declarerTeam & 0xf).stiche);
+}
+
+// the bounds hold against the exact values, also in the middle of a stich
+TEST(TestBounds, exact)
+{
+    std::minstd_rand engine(53);
+    Solver points;
+    Solver stiche(Solver::Stiche);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Herz);
+        for (int i = 0; i < 40; ++i) {
+            Position position(rules, randomDeal(engine), int(engine() % numPlayers), int(engine() % numPlayers));
+            const int plies = 12 + int(engine() % 8);
+            while (numCards - popCount(position.played) - position.numInTrick > plies) {
+                const CardMask moves = position.legalMoves();
+                position.play(nthCard(moves, int(engine() % popCount(moves))));
+            }
+
+            const int value = points.value(position);
+            const Bounds pointsBounds = pointBounds(position);
+            ASSERT_LE(pointsBounds.lower, value);
+            ASSERT_GE(pointsBounds.upper, value);
+
+            const int numStiche = stiche.value(position);
+            const Bounds sticheBound = sticheBounds(position);
+            ASSERT_LE(sticheBound.lower, numStiche);
+            ASSERT_GE(sticheBound.upper, numStiche);
+        }
+    }
+}
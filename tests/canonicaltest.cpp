@@ -0,0 +1,119 @@
+#include <Canonical.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace SchafKopf;
+
+static Deal randomDeal(std::minstd_rand& engine)
+{
+    Deck deck;
+    std::shuffle(deck.cards, deck.cards + Deck::numCards, engine);
+    Deal deal;
+    for (int i = 0; i < numPlayers; ++i) {
+        deal.hands[i] = 0;
+        for (int j = 0; j < Player::maxCards; ++j)
+            deal.hands[i] |= cardBit(deck.cards[i * Player::maxCards + j]);
+    }
+    return deal;
+}
+
+// a random permutation that only relabels the symmetric colors
+static ColorPermutation randomSymmetry(std::minstd_rand& engine, int symmetric)
+{
+    for (;;) {
+        const ColorPermutation& perm = ColorPermutation::fromIndex(int(engine() % ColorPermutation::numPermutations));
+        bool valid = true;
+        for (int c = 0; c < numColors; ++c)
+            valid &= (symmetric & (1 << c)) ? bool(symmetric & (1 << perm.map[c])) : perm.map[c] == c;
+        if (valid)
+            return perm;
+    }
+}
+
+TEST(TestCanonical, permutations)
+{
+    for (int i = 0; i < ColorPermutation::numPermutations; ++i) {
+        const ColorPermutation& perm = ColorPermutation::fromIndex(i);
+        ASSERT_EQ(i, perm.index());
+        ASSERT_TRUE(perm.inverse().inverse() == perm);
+
+        const CardMask mask = 0x12345678;
+        const CardMask fixed = typeMask(Ober);
+        ASSERT_EQ(mask, perm.inverse().apply(perm.apply(mask)));
+        ASSERT_EQ(mask & fixed, perm.apply(mask, fixed) & fixed);
+        for (int card = 0; card < numCards; ++card) {
+            ASSERT_EQ(cardBit(perm.apply(card)), perm.apply(cardBit(card)));
+            ASSERT_EQ(cardBit(perm.apply(card, fixed)), perm.apply(cardBit(card), fixed));
+        }
+    }
+    ASSERT_EQ(0, ColorPermutation::identity().index());
+}
+
+TEST(TestCanonical, hands)
+{
+    std::minstd_rand engine(11);
+
+    ASSERT_EQ(0xf, Symmetry::of(Game::Wenz, Gras).colors);
+    ASSERT_EQ(typeMask(Unter), Symmetry::of(Game::Wenz, Gras).fixed);
+    ASSERT_EQ(0xf & ~(1 << Gras), Symmetry::of(Game::Solo, Gras).colors);
+    ASSERT_EQ((1 << Schelln) | (1 << Eichel), Symmetry::of(Game::SauSpiel, Gras).colors);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Symmetry symmetry = Symmetry::of(Game::Type(type), Eichel);
+        for (int i = 0; i < 50; ++i) {
+            const CardMask hand = randomDeal(engine).hands[0];
+
+            ColorPermutation perm;
+            const CardMask canonical = canonicalHand(hand, symmetry, perm);
+            ASSERT_EQ(canonical, perm.apply(hand, symmetry.fixed));
+
+            const CardMask relabeled = randomSymmetry(engine, symmetry.colors).apply(hand, symmetry.fixed);
+            ASSERT_EQ(canonical, canonicalHand(relabeled, symmetry, perm));
+            ASSERT_EQ(canonical, perm.apply(relabeled, symmetry.fixed));
+        }
+    }
+}
+
+TEST(TestCanonical, positions)
+{
+    std::minstd_rand engine(13);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Gras);
+        const Symmetry symmetric = Symmetry::of(rules);
+
+        for (int i = 0; i < 20; ++i) {
+            Position position(rules, randomDeal(engine), 0, 0);
+            const ColorPermutation symmetry = randomSymmetry(engine, symmetric.colors);
+            Position relabeled = position;
+            for (int p = 0; p < numPlayers; ++p)
+                relabeled.hands[p] = symmetry.apply(position.hands[p], symmetric.fixed);
+
+            // play the same random game on both, the canonical positions must always match
+            for (int ply = 0; ply < numCards; ++ply) {
+                ColorPermutation perm;
+                ColorPermutation relabeledPerm;
+                const Position canonical = canonicalPosition(position, perm);
+                const Position relabeledCanonical = canonicalPosition(relabeled, relabeledPerm);
+
+                for (int p = 0; p < numPlayers; ++p) {
+                    ASSERT_EQ(canonical.hands[p], relabeledCanonical.hands[p]);
+                    ASSERT_EQ(canonical.won[p], relabeledCanonical.won[p]);
+                }
+                ASSERT_EQ(canonical.numInTrick, relabeledCanonical.numInTrick);
+                for (int t = 0; t < canonical.numInTrick; ++t)
+                    ASSERT_EQ(canonical.trick[t], relabeledCanonical.trick[t]);
+                ASSERT_EQ(canonical.legalMoves(), perm.apply(position.legalMoves(), symmetric.fixed));
+
+                const CardMask legal = position.legalMoves();
+                const int card = nthCard(legal, int(engine() % unsigned(popCount(legal))));
+                position.play(card);
+                relabeled.play(symmetry.apply(card, symmetric.fixed));
+            }
+
+            ASSERT_EQ(position.declarerPoints(), relabeled.declarerPoints());
+        }
+    }
+}
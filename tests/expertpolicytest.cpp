@@ -0,0 +1,194 @@
+#include <ExpertAi.h>
+#include <RandomAi.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+CardMask cards(std::initializer_list<Card> list)
+{
+    CardMask result = 0;
+    for (const Card& card : list)
+        result |= cardBit(card);
+    return result;
+}
+
+// the cards of hands, and the others out of the game, then the trick is played
+Position position(const Rules& rules, std::initializer_list<CardMask> hands, int declarer, int leader,
+                  std::initializer_list<Card> trick = {})
+{
+    Deal deal;
+    int p = 0;
+    CardMask all = 0;
+    for (CardMask hand : hands) {
+        deal.hands[p++] = hand;
+        all |= hand;
+    }
+    Position result(rules, deal, declarer, leader);
+    result.played = ~all;
+    for (const Card& card : trick)
+        result.play(cardIndex(card));
+    return result;
+}
+
+}
+
+TEST(TestExpertPolicy, declarerDrawsTrumps)
+{
+    const ExpertPolicy& policy = ExpertPolicy::get(Game::Solo, Gras);
+    const CardMask others = cards({ { Unter, Eichel }, { Siebner, Schelln }, { Achter, Schelln } });
+
+    // the highest trump, if nobody can beat it
+    Position leading = position(policy.rules(), { cards({ { Ober, Eichel }, { Siebner, Gras }, { Ass, Schelln } }), others, 0, 0 }, 0, 0);
+    ASSERT_EQ(cardIndex(Card{ Ober, Eichel }), policy.move(leading));
+
+    // a low one otherwise
+    leading = position(policy.rules(), { cards({ { Ober, Gras }, { Siebner, Gras }, { Ass, Schelln } }),
+                                         cards({ { Ober, Eichel }, { Siebner, Schelln }, { Achter, Schelln } }), 0, 0 }, 0, 0);
+    ASSERT_EQ(cardIndex(Card{ Siebner, Gras }), policy.move(leading));
+
+    // a defender cashes the Ass instead
+    leading = position(policy.rules(), { others, cards({ { Ober, Gras }, { Siebner, Gras }, { Ass, Schelln } }), 0, 0 }, 0, 1);
+    ASSERT_EQ(cardIndex(Card{ Ass, Schelln }), policy.move(leading));
+}
+
+TEST(TestExpertPolicy, smearsToPartner)
+{
+    const ExpertPolicy& policy = ExpertPolicy::get(Game::Solo, Gras);
+
+    // the defenders take the stich, player 1 comes last
+    const Position last = position(policy.rules(),
+                                   { cards({ { Koenig, Schelln } }),
+                                     cards({ { Zehner, Schelln }, { Neuner, Schelln }, { Ober, Eichel } }),
+                                     cards({ { Ass, Schelln } }), cards({ { Siebner, Schelln } }) },
+                                   0, 2, { { Ass, Schelln }, { Siebner, Schelln }, { Koenig, Schelln } });
+    ASSERT_EQ(cardIndex(Card{ Zehner, Schelln }), policy.move(last));
+
+    // a trump is led: the trump Ass, not the Ober
+    const Position trump = position(policy.rules(),
+                                    { cards({ { Unter, Herz } }), cards({ { Ass, Gras }, { Ober, Gras } }),
+                                      cards({ { Ober, Eichel } }), cards({ { Siebner, Gras } }) },
+                                    0, 2, { { Ober, Eichel }, { Siebner, Gras }, { Unter, Herz } });
+    ASSERT_EQ(cardIndex(Card{ Ass, Gras }), policy.move(trump));
+
+    // the declarer comes after and may still trump in: nothing given away
+    const Position unsure = position(policy.rules(),
+                                     { cards({ { Unter, Herz }, { Neuner, Eichel } }),
+                                       cards({ { Siebner, Schelln }, { Achter, Eichel } }),
+                                       cards({ { Ass, Schelln }, { Siebner, Eichel } }),
+                                       cards({ { Zehner, Schelln }, { Neuner, Schelln } }) },
+                                     0, 2, { { Ass, Schelln } });
+    ASSERT_EQ(cardIndex(Card{ Neuner, Schelln }), policy.move(unsure));
+}
+
+TEST(TestExpertPolicy, takesCheaplyOrDiscardsLow)
+{
+    const ExpertPolicy& policy = ExpertPolicy::get(Game::Solo, Gras);
+
+    // last, the declarer takes with the König, not the Ass
+    const Position take = position(policy.rules(),
+                                   { cards({ { Koenig, Herz }, { Ass, Herz } }), cards({ { Neuner, Herz } }),
+                                     cards({ { Siebner, Herz } }), cards({ { Achter, Herz } }) },
+                                   0, 1, { { Neuner, Herz }, { Siebner, Herz }, { Achter, Herz } });
+    ASSERT_EQ(cardIndex(Card{ Koenig, Herz }), policy.move(take));
+
+    // cannot follow and there is nothing to take: the Schelln 7 goes
+    const Position discard = position(policy.rules(),
+                                      { cards({ { Ass, Eichel }, { Siebner, Schelln } }),
+                                        cards({ { Ober, Eichel }, { Koenig, Eichel } }),
+                                        cards({ { Siebner, Herz }, { Neuner, Eichel } }),
+                                        cards({ { Achter, Herz }, { Achter, Eichel } }) },
+                                      1, 1, { { Ober, Eichel }, { Siebner, Herz }, { Achter, Herz } });
+    ASSERT_EQ(cardIndex(Card{ Siebner, Schelln }), policy.move(discard));
+}
+
+// with the same deals, an expert declarer takes more than a random one
+TEST(TestExpertPolicy, beatsRandom)
+{
+    std::minstd_rand engine(137);
+    const ExpertPolicy& policy = ExpertPolicy::get(Game::Solo, Eichel);
+    const Rules& rules = policy.rules();
+
+    int points[2] = { 0, 0 };
+    for (int game = 0; game < 200; ++game) {
+        const Deal deal = randomDeal(engine);
+        int declarer = 0;
+        for (int p = 1; p < numPlayers; ++p) {
+            if (popCount(deal.hands[p] & rules.trumps()) > popCount(deal.hands[declarer] & rules.trumps()))
+                declarer = p;
+        }
+
+        for (int expert = 0; expert < 2; ++expert) {
+            std::minstd_rand random(unsigned(game) + 1);
+            Position position(rules, deal, declarer, game % numPlayers);
+            while (!position.finished()) {
+                const CardMask legal = position.legalMoves();
+                if (expert && position.toMove() == declarer)
+                    position.play(policy.move(position));
+                else
+                    position.play(nthCard(legal, int(random() % unsigned(popCount(legal)))));
+            }
+            points[expert] += position.declarerPoints();
+        }
+    }
+    ASSERT_GT(points[1], points[0] + 200 * 5);
+}
+
+// ExpertAi plays whole games through Game
+TEST(TestExpertAi, game)
+{
+    Game game;
+    game.gameType = Game::Solo;
+    game.gameColor = Color::Herz;
+
+    ExpertAi experts[2] = { { game, game.players[0] }, { game, game.players[2] } };
+    RandomAi randoms[2] = { { game, game.players[1] }, { game, game.players[3] } };
+    game.ais[0] = &experts[0];
+    game.ais[1] = &randoms[0];
+    game.ais[2] = &experts[1];
+    game.ais[3] = &randoms[1];
+
+    for (int ply = 0; ply < numCards; ++ply)
+        game.putCard(game.ais[game.m_activePlayer]->doPlayCard(game.activePile));
+
+    ASSERT_EQ(8, game.numStiche);
+    int points = 0;
+    for (const Player& player : game.players)
+        points += player.points;
+    ASSERT_EQ(120, points);
+}
+
+// the partner in a Sauspiel is only known to the Sau, until it is played
+TEST(TestExpertAi, knownTeam)
+{
+    const Rules& rules = Rules::get(Game::SauSpiel, Gras);
+    const int sau = cardIndex(Card{ Ass, Gras });
+    std::minstd_rand engine(61);
+    for (int i = 0; i < 50; ++i) {
+        const Deal deal = randomDeal(engine);
+        const int declarer = i % numPlayers;
+        if ((deal.hands[declarer] >> sau) & 1)
+            continue;
+        Position position(rules, deal, declarer, declarer);
+        const uint8_t team = position.declarerTeam;
+
+        bool sauPlayed = false;
+        while (!position.finished()) {
+            for (int player = 0; player < numPlayers; ++player) {
+                const bool knows = sauPlayed || ((position.hands[player] >> sau) & 1);
+                ASSERT_EQ(knows ? team : uint8_t(1u << declarer), ExpertAi::knownTeam(position, player, declarer));
+            }
+            const CardMask moves = position.legalMoves();
+            const int card = nthCard(moves, int(engine() % popCount(moves)));
+            sauPlayed |= card == sau;
+            position.play(card);
+        }
+    }
+
+    const Position solo(Rules::get(Game::Solo, Gras), randomDeal(engine), 1, 0);
+    ASSERT_EQ(solo.declarerTeam, ExpertAi::knownTeam(solo, 2, 1));
+}
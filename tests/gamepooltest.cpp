@@ -0,0 +1,99 @@
+#include <GamePool.h>
+#include <ObserverAi.h>
+#include <RandomAi.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+struct ObservingRandomAi : public AI
+{
+    ObservingRandomAi(const Game& game, const Player& player)
+        : observerAi(game, player),
+          randomAi(game, player)
+    {}
+
+    void reset() override { observerAi.reset(); }
+    int doPlayCard(const ActivePile& pile) override { return randomAi.doPlayCard(pile); }
+    void cardPlayed(const ActivePile& pile, int player) override { observerAi.cardPlayed(pile, player); }
+
+    ObserverAi observerAi;
+    RandomAi randomAi;
+};
+
+}
+
+static bool sameState(const ObserverAi& ai, const ObserverAi& other)
+{
+    if (ai.m_gameInfo.trumpsLeft != other.m_gameInfo.trumpsLeft)
+        return false;
+    for (int c = 0; c < numColors; ++c) {
+        if (ai.m_gameInfo.colorsLeft[c] != other.m_gameInfo.colorsLeft[c])
+            return false;
+    }
+    for (int p = 0; p < numPlayers; ++p) {
+        if (ai.m_playerInfo[p].trumpFree != other.m_playerInfo[p].trumpFree)
+            return false;
+        for (int c = 0; c < numColors; ++c) {
+            if (ai.m_playerInfo[p].colorFree[c] != other.m_playerInfo[p].colorFree[c])
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST(TestGamePool, acquire)
+{
+    GamePool<RandomAi> pool(2);
+    ASSERT_EQ(2u, pool.numFree());
+    {
+        GamePool<RandomAi>::Lease a = pool.acquire();
+        GamePool<RandomAi>::Lease b = pool.acquire();
+        GamePool<RandomAi>::Lease c = pool.acquire();
+        ASSERT_EQ(0u, pool.numFree());
+        ASSERT_EQ(&c->seats[2], c->game.ais[2]);
+
+        std::minstd_rand engine(43);
+        for (int i = 0; i < 10; ++i) {
+            const uint32_t epoch = a->game.epoch;
+            a->game.redeal(engine);
+            ASSERT_EQ(epoch + 1, a->game.epoch);
+            a->play();
+
+            int points = 0;
+            for (const Player& player : a->game.players)
+                points += player.points;
+            ASSERT_EQ(120, points);
+        }
+    }
+    ASSERT_EQ(3u, pool.numFree());
+}
+
+TEST(TestGamePool, lazyReset)
+{
+    GameBundle<ObservingRandomAi> lazy;
+    GameBundle<ObservingRandomAi> eager;
+    std::minstd_rand engine(47);
+
+    for (int i = 0; i < 10; ++i) {
+        lazy.game.redeal(engine);
+        eager.game.deck = lazy.game.deck;
+        eager.game.redeal();
+        for (ObservingRandomAi& seat : eager.seats)
+            seat.reset();
+
+        while (lazy.game.numStiche < Player::maxCards) {
+            const int card = lazy.seats[lazy.game.m_activePlayer].doPlayCard(lazy.game.activePile);
+            lazy.game.putCard(card);
+            eager.game.putCard(card);
+
+            for (int p = 0; p < numPlayers; ++p)
+                ASSERT_TRUE(sameState(lazy.seats[p].observerAi, eager.seats[p].observerAi));
+        }
+    }
+}
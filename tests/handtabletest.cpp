@@ -0,0 +1,92 @@
+#include <HandTable.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+using namespace SchafKopf;
+
+static CardMask randomHand(std::minstd_rand& engine)
+{
+    Deck deck;
+    std::shuffle(deck.cards, deck.cards + Deck::numCards, engine);
+    CardMask hand = 0;
+    for (int i = 0; i < Player::maxCards; ++i)
+        hand |= cardBit(deck.cards[i]);
+    return hand;
+}
+
+TEST(TestHandTable, canonicalHands)
+{
+    std::minstd_rand engine(3);
+
+    for (int f = 0; f < HandTable::numFamilies; ++f) {
+        const HandTable::Family family = HandTable::Family(f);
+        const std::vector<CardMask> canonicalHands = HandTable::canonicalHands(family);
+        ASSERT_TRUE(std::adjacent_find(canonicalHands.begin(), canonicalHands.end()) == canonicalHands.end());
+
+        for (int i = 0; i < 100; ++i) {
+            const CardMask hand = randomHand(engine);
+            ColorPermutation perm;
+            const CardMask canonical = HandTable::canonicalHand(family, hand, perm);
+
+            ASSERT_TRUE(std::binary_search(canonicalHands.begin(), canonicalHands.end(), canonical));
+            ASSERT_EQ(canonical, perm.apply(hand, HandTable::symmetry(family).fixed));
+        }
+
+        // every canonical hand is its own representative
+        for (size_t i = 0; i < canonicalHands.size(); i += 997) {
+            ColorPermutation perm;
+            ASSERT_EQ(canonicalHands[i], HandTable::canonicalHand(family, canonicalHands[i], perm));
+        }
+    }
+}
+
+TEST(TestHandTable, writeAndLookup)
+{
+    std::minstd_rand engine(5);
+    const CardMask hand = randomHand(engine);
+
+    ContractEvaluator evaluator(8, 1);
+    std::vector<CardMask> hands[HandTable::numFamilies];
+    std::vector<HandTable::Entry> entries[HandTable::numFamilies];
+    ColorPermutation perms[HandTable::numFamilies];
+    for (int f = 0; f < HandTable::numFamilies; ++f) {
+        const HandTable::Family family = HandTable::Family(f);
+        hands[f] = { HandTable::canonicalHand(family, hand, perms[f]) };
+        entries[f].resize(size_t(HandTable::numSlots(family)));
+        HandTable::evaluate(family, hands[f][0], evaluator, entries[f].data());
+    }
+
+    const std::string fileName = "handtabletest.bin";
+    ASSERT_TRUE(HandTable::write(fileName, hands, entries, evaluator.numSamples()));
+
+    {
+        HandTable table(fileName);
+        ASSERT_TRUE(table.load());
+
+        for (const Contract& contract : allContracts) {
+            ContractValue value;
+            const bool found = table.lookup(hand, contract, value);
+            ASSERT_EQ(contract.isValid(hand), found);
+            if (!found)
+                continue;
+
+            const int f = HandTable::family(contract.type);
+            const int slot = HandTable::slot(contract.type, perms[f].apply(contract.color), perms[f].apply(Herz));
+            ASSERT_EQ(entries[f][size_t(slot)].value / 10.0, value.value);
+            ASSERT_GE(value.winProbability, 0.0);
+            ASSERT_LE(value.winProbability, 1.0);
+        }
+
+        // a hand that is not in the table
+        ContractValue value;
+        ASSERT_FALSE(table.lookup(hand ^ 0x3, Contract{Game::Solo, Herz}, value));
+    }
+
+    std::remove(fileName.c_str());
+
+    HandTable missing("does-not-exist.bin");
+    ContractValue value;
+    ASSERT_FALSE(missing.lookup(hand, Contract{Game::Solo, Herz}, value));
+}
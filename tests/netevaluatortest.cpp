@@ -0,0 +1,219 @@
+#include <DepthSearch.h>
+#include <Ranking.h>
+#include <Solver.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+NetEvaluator::Weights randomWeights(std::minstd_rand& engine)
+{
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    NetEvaluator::Weights weights;
+    for (float& w : weights.w1)
+        w = 0.1f * uniform(engine);
+    for (float& b : weights.b1)
+        b = 0.5f * uniform(engine);
+    for (float& w : weights.w2)
+        w = 0.5f * uniform(engine);
+    for (float& b : weights.b2)
+        b = 0.2f * uniform(engine);
+    for (float& w : weights.w3)
+        w = 0.3f * uniform(engine);
+    weights.b3 = 0.3f;
+    return weights;
+}
+
+// a random game with plies cards left to play
+Position randomPosition(const Rules& rules, std::minstd_rand& engine, int plies)
+{
+    Position position(rules, randomDeal(engine), int(engine() % numPlayers), int(engine() % numPlayers));
+    while (numCards - popCount(position.played) - position.numInTrick > plies) {
+        const CardMask moves = position.legalMoves();
+        position.play(nthCard(moves, int(engine() % popCount(moves))));
+    }
+    return position;
+}
+
+}
+
+TEST(TestNetEvaluator, inputs)
+{
+    std::minstd_rand engine(5);
+    uint16_t active[NetEvaluator::maxActive];
+    for (int i = 0; i < 50; ++i) {
+        const Rules& rules = Rules::get(Game::Type(i % numGameTypes), Color(i % numColors));
+        const Position position = randomPosition(rules, engine, 1 + i % 31);
+        const int count = NetEvaluator::inputs(position, nullptr, active);
+
+        int hand = 0, played = 0, trick = 0, seat = 0, type = 0;
+        for (int j = 0; j < count; ++j) {
+            ASSERT_LT(active[j], NetEvaluator::numInputs);
+            if (j) {
+                ASSERT_NE(active[j - 1], active[j]);
+            }
+            hand += active[j] < NetEvaluator::PlayedInput;
+            played += active[j] >= NetEvaluator::PlayedInput && active[j] < NetEvaluator::TrickInput;
+            trick += active[j] >= NetEvaluator::TrickInput && active[j] < NetEvaluator::VoidInput;
+            type += active[j] == NetEvaluator::TypeInput + rules.type();
+            seat += active[j] == NetEvaluator::SeatInput + position.numInTrick;
+        }
+        ASSERT_EQ(popCount(position.hands[position.toMove()]), hand);
+        ASSERT_EQ(popCount(position.played), played);
+        ASSERT_EQ(int(position.numInTrick), trick);
+        ASSERT_EQ(1, type);
+        ASSERT_EQ(1, seat);
+    }
+
+    // voids as the player to move knows them
+    const Position position = randomPosition(Rules::get(Game::SauSpiel, Eichel), engine, 32);
+    const uint8_t voids[numPlayers] = { 0, 0x1f, 0, 0 };
+    const int count = NetEvaluator::inputs(position, voids, active);
+    int numVoids = 0;
+    for (int j = 0; j < count; ++j)
+        numVoids += active[j] >= NetEvaluator::VoidInput && active[j] < NetEvaluator::TypeInput;
+    ASSERT_EQ(position.toMove() == 1 ? 0 : Rules::numSuits, numVoids);
+}
+
+TEST(TestNetEvaluator, avx2MatchesScalar)
+{
+    std::minstd_rand engine(7);
+    NetEvaluator scalar, avx2;
+    const NetEvaluator::Weights weights = randomWeights(engine);
+    scalar.setWeights(weights);
+    avx2.setWeights(weights);
+    scalar.setUseAvx2(false);
+    avx2.setUseAvx2(true);
+
+    std::vector<Position> positions;
+    for (int i = 0; i < 200; ++i)
+        positions.push_back(randomPosition(Rules::get(Game::Type(i % numGameTypes), Color(i % numColors)), engine, 1 + i % 32));
+    std::vector<float> batched(positions.size());
+    avx2.evaluate(positions.data(), positions.size(), batched.data());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        ASSERT_EQ(scalar.evaluate(positions[i]), avx2.evaluate(positions[i]));
+        ASSERT_EQ(scalar.evaluate(positions[i]), batched[i]);
+    }
+}
+
+// weights at the limits setWeights() clips to, where sums of products
+// no longer fit into int16
+TEST(TestNetEvaluator, avx2MatchesScalarAtLimits)
+{
+    std::minstd_rand engine(19);
+    const float firstLayer[] = { 0.5f, 2.0f, -2.0f };
+    const float otherLayers[] = { 1.9f, 2.0f, -2.0f };
+    for (float w1 : firstLayer) {
+        for (float w2 : otherLayers) {
+            NetEvaluator::Weights weights;
+            std::fill(weights.w1.begin(), weights.w1.end(), w1);
+            std::fill(weights.b1.begin(), weights.b1.end(), w1);
+            std::fill(weights.w2.begin(), weights.w2.end(), w2);
+            std::fill(weights.w3.begin(), weights.w3.end(), w2);
+            NetEvaluator scalar, avx2;
+            scalar.setWeights(weights);
+            avx2.setWeights(weights);
+            scalar.setUseAvx2(false);
+            avx2.setUseAvx2(true);
+
+            uint16_t active[NetEvaluator::maxActive];
+            for (int i = 0; i < 20; ++i) {
+                const Position position = randomPosition(Rules::get(Game::Type(i % numGameTypes), Color(i % numColors)), engine, 1 + i);
+                ASSERT_EQ(scalar.evaluate(position), avx2.evaluate(position));
+                const float reference = NetEvaluator::reference(weights, active, NetEvaluator::inputs(position, nullptr, active));
+                ASSERT_NEAR(reference, scalar.evaluate(position), std::abs(reference) * 0.05f + 1.0f);
+            }
+        }
+    }
+}
+
+TEST(TestNetEvaluator, quantization)
+{
+    std::minstd_rand engine(11);
+    const NetEvaluator::Weights weights = randomWeights(engine);
+    NetEvaluator evaluator;
+    evaluator.setWeights(weights);
+
+    uint16_t active[NetEvaluator::maxActive];
+    double error = 0;
+    const int count = 500;
+    for (int i = 0; i < count; ++i) {
+        const Position position = randomPosition(Rules::get(Game::Type(i % numGameTypes), Color(i % numColors)), engine, 1 + i % 32);
+        const float reference = NetEvaluator::reference(weights, active, NetEvaluator::inputs(position, nullptr, active));
+        const float quantized = evaluator.evaluate(position);
+        ASSERT_NEAR(reference, quantized, 6.0f);
+        error += std::abs(reference - quantized);
+    }
+    ASSERT_LT(error / count, 1.5);
+}
+
+TEST(TestNetEvaluator, roundTrip)
+{
+    std::minstd_rand engine(13);
+    NetEvaluator evaluator;
+    evaluator.setWeights(randomWeights(engine));
+
+    const std::string fileName = "netevaluatortest.bin";
+    ASSERT_TRUE(evaluator.write(fileName));
+    NetEvaluator loaded;
+    ASSERT_TRUE(loaded.load(fileName));
+
+    // a bias beyond what setWeights() clips to is refused
+    {
+        std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(std::streamoff(sizeof(NetEvaluator::Header) + NetEvaluator::numInputs * NetEvaluator::hidden1 * sizeof(int16_t)));
+        const int16_t bias = 2 * NetEvaluator::activationScale + 1;
+        file.write(reinterpret_cast<const char *>(&bias), sizeof(bias));
+    }
+    NetEvaluator refused;
+    ASSERT_FALSE(refused.load(fileName));
+    std::remove(fileName.c_str());
+    ASSERT_FALSE(loaded.load(fileName));
+
+    for (int i = 0; i < 20; ++i) {
+        const Position position = randomPosition(Rules::get(Game::Solo, Color(i % numColors)), engine, 32 - i);
+        ASSERT_EQ(evaluator.evaluate(position), loaded.evaluate(position));
+    }
+}
+
+TEST(TestDepthSearch, matchesSolver)
+{
+    std::minstd_rand engine(17);
+    NetEvaluator evaluator;
+    evaluator.setWeights(randomWeights(engine));
+    DepthSearch search(evaluator);
+    Solver solver;
+
+    for (int i = 0; i < 30; ++i) {
+        const Rules& rules = Rules::get(Game::Type(i % numGameTypes), Color(i % numColors));
+        const Position position = randomPosition(rules, engine, 5 + i % 7);
+
+        // deep enough to reach the end, the evaluator is never asked
+        ASSERT_EQ(float(solver.value(position)), search.value(position, 3));
+        ASSERT_EQ(0u, search.numLeaves());
+
+        uint8_t moves[Player::maxCards];
+        float values[Player::maxCards];
+        const int count = search.moveValues(position, 3, moves, values);
+        ASSERT_EQ(popCount(position.legalMoves()), count);
+        for (int m = 0; m < count; ++m) {
+            Position next = position;
+            next.play(moves[m]);
+            const int taken = next.declarerPoints() - position.declarerPoints();
+            ASSERT_EQ(float(taken + solver.value(next)), values[m]);
+        }
+
+        // one stich less, the leaves are estimated
+        if (position.numInTrick) {
+            search.value(position, 0);
+            ASSERT_LT(0u, search.numLeaves());
+        }
+    }
+}
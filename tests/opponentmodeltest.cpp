@@ -0,0 +1,186 @@
+#include <OpponentModel.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+using namespace SchafKopf;
+
+// a game of random cards, played by model
+template <typename Engine>
+static GameRecord playGame(const Rules& rules, const PlayModel& model, Engine& engine)
+{
+    const int declarer = int(engine() % numPlayers);
+    const Position start(rules, randomDeal(engine), declarer, int(engine() % numPlayers));
+    Position position = start;
+    std::uniform_real_distribution<double> uniform(0, 1);
+    uint8_t cards[numCards];
+    for (int i = 0; i < numCards; ++i) {
+        const CardMask moves = position.legalMoves();
+        double x = uniform(engine);
+        int card = lowestCard(moves);
+        for (CardMask rest = moves; rest; rest &= rest - 1) {
+            card = lowestCard(rest);
+            x -= model.probability(position, card);
+            if (x <= 0)
+                break;
+        }
+        cards[i] = uint8_t(card);
+        position.play(card);
+    }
+    return GameLog::record(start, declarer, cards);
+}
+
+TEST(TestGameLog, roundTrip)
+{
+    std::minstd_rand engine(109);
+    const UniformPlayModel model;
+    std::vector<GameRecord> games;
+    for (int i = 0; i < 10; ++i)
+        games.push_back(playGame(Rules::get(Game::Type(i % 6), Color(i % numColors)), model, engine));
+
+    const std::string fileName = "gamelogtest.bin";
+    {
+        GameLog::Writer writer(fileName);
+        ASSERT_TRUE(writer.isOpen());
+        for (int i = 0; i < 6; ++i)
+            writer.write(games[size_t(i)]);
+    }
+    {
+        GameLog::Writer writer(fileName, true);
+        for (size_t i = 6; i < games.size(); ++i)
+            writer.write(games[i]);
+    }
+
+    GameLog::Reader reader(fileName);
+    ASSERT_TRUE(reader.isOpen());
+    GameRecord records[16];
+    ASSERT_EQ(games.size(), reader.read(records, 16));
+    ASSERT_EQ(0u, reader.read(records, 16));
+    std::remove(fileName.c_str());
+
+    for (size_t i = 0; i < games.size(); ++i) {
+        ASSERT_EQ(0, std::memcmp(&games[i], &records[i], sizeof(GameRecord)));
+        Deal deal;
+        ASSERT_TRUE(records[i].deal(deal));
+        CardMask all = 0;
+        for (int p = 0; p < numPlayers; ++p) {
+            ASSERT_EQ(int(Player::maxCards), popCount(deal.hands[p]));
+            all |= deal.hands[p];
+        }
+        ASSERT_EQ(allCards, all);
+    }
+
+    // a card twice, and a game that does not exist
+    GameRecord broken = games[0];
+    broken.cards[5] = broken.cards[4];
+    Deal deal;
+    ASSERT_FALSE(broken.deal(deal));
+    broken = games[0];
+    broken.type = Game::Solo + 1;
+    ASSERT_FALSE(broken.deal(deal));
+}
+
+// Schelln Ass is led, and the next player throws Herz Ass while still
+// holding Schelln 7, which is played in the second stich
+TEST(TestGameLog, notFollowing)
+{
+    GameRecord record;
+    record.type = Game::Wenz;
+    record.color = Eichel;
+    record.declarer = 0;
+    record.leader = 0;
+
+    const Card first[] = { { Ass, Schelln }, { Ass, Herz }, { Ass, Gras }, { Ass, Eichel }, { Koenig, Schelln }, { Siebner, Schelln } };
+    CardMask rest = allCards;
+    int count = 0;
+    for (const Card& card : first) {
+        record.cards[count++] = uint8_t(cardIndex(card));
+        rest &= ~cardBit(card);
+    }
+    for (; rest; rest &= rest - 1)
+        record.cards[count++] = uint8_t(lowestCard(rest));
+
+    Deal deal;
+    ASSERT_FALSE(record.deal(deal));
+}
+
+// threads counting into separate or shared shards count the same
+TEST(TestOpponentModel, shards)
+{
+    std::minstd_rand engine(113);
+    const Rules& rules = Rules::get(Game::SauSpiel, Eichel);
+    const UniformPlayModel model;
+    std::vector<GameRecord> games;
+    for (int i = 0; i < 200; ++i)
+        games.push_back(playGame(rules, model, engine));
+
+    PlayCounts single;
+    for (const GameRecord& game : games)
+        ASSERT_TRUE(single.add(game, 0));
+
+    constexpr int numThreads = 4;
+    PlayCounts sharded(2);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = size_t(t); i < games.size(); i += numThreads)
+                sharded.add(games[i], t % 2);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    uint64_t total = 0;
+    for (int context = 0; context < OpponentModel::numContexts; ++context) {
+        for (int cardClass = 0; cardClass < OpponentModel::numClasses; ++cardClass) {
+            ASSERT_EQ(single.chosen(context, cardClass), sharded.chosen(context, cardClass));
+            ASSERT_EQ(single.offered(context, cardClass), sharded.offered(context, cardClass));
+            total += single.chosen(context, cardClass);
+        }
+    }
+    ASSERT_EQ(uint64_t(games.size() * numCards), total);
+}
+
+// fit to games played by SmearPlayModel, the model explains new games of
+// it better than uniform play, and survives writing and loading
+TEST(TestOpponentModel, learnsSmearing)
+{
+    std::minstd_rand engine(127);
+    const Rules& rules = Rules::get(Game::SauSpiel, Gras);
+    const SmearPlayModel smear;
+
+    PlayCounts counts;
+    for (int i = 0; i < 3000; ++i)
+        counts.add(playGame(rules, smear, engine), 0);
+    OpponentModel model = counts.model();
+
+    const std::string fileName = "opponentmodeltest.bin";
+    ASSERT_TRUE(model.write(fileName));
+    OpponentModel loaded;
+    ASSERT_TRUE(loaded.load(fileName));
+    std::remove(fileName.c_str());
+
+    const UniformPlayModel uniform;
+    double logLikelihood[2] = { 0, 0 };
+    for (int i = 0; i < 200; ++i) {
+        const GameRecord game = playGame(rules, smear, engine);
+        Position position = game.start();
+        for (int c = 0; c < numCards; ++c) {
+            const CardMask moves = position.legalMoves();
+            double sum = 0;
+            for (CardMask rest = moves; rest; rest &= rest - 1)
+                sum += loaded.probability(position, lowestCard(rest));
+            ASSERT_NEAR(1.0, sum, 1e-9);
+            ASSERT_EQ(model.probability(position, game.cards[c]), loaded.probability(position, game.cards[c]));
+
+            logLikelihood[0] += std::log(uniform.probability(position, game.cards[c]));
+            logLikelihood[1] += std::log(loaded.probability(position, game.cards[c]));
+            position.play(game.cards[c]);
+        }
+    }
+    ASSERT_GT(logLikelihood[1], logLikelihood[0] + 200);
+}
@@ -0,0 +1,67 @@
+#include <ParallelSolver.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+static Position randomPosition(const Rules& rules, std::minstd_rand& engine, int numStiche)
+{
+    Position position(rules, randomDeal(engine), int(engine() % numPlayers), int(engine() % numPlayers));
+    while (position.numStiche() < numStiche) {
+        const CardMask moves = position.legalMoves();
+        position.play(nthCard(moves, int(engine() % popCount(moves))));
+    }
+    return position;
+}
+
+TEST(TestParallelSolver, sameAsSolver)
+{
+    std::minstd_rand engine(61);
+    Solver solver;
+    ParallelSolver parallel(4, Solver::Points, 18);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Gras);
+        for (int i = 0; i < 4; ++i) {
+            const Position position = randomPosition(rules, engine, 4);
+            const int value = solver.value(position);
+            ASSERT_EQ(value, parallel.value(position));
+            ASSERT_EQ(solver.declarerWins(position), parallel.reaches(position, 61));
+
+            // the card keeps the value
+            const int card = parallel.bestMove(position);
+            ASSERT_TRUE(position.legalMoves() & cardBit(card));
+            Position child = position;
+            child.play(card);
+            ASSERT_EQ(solver.won(position) + value, solver.won(child) + solver.value(child));
+        }
+    }
+}
+
+TEST(TestParallelSolver, deterministic)
+{
+    std::minstd_rand engine(67);
+    const Rules rules(Game::Solo, Eichel);
+    Solver solver;
+
+    for (int i = 0; i < 6; ++i) {
+        const Position position = randomPosition(rules, engine, 4);
+        const int total = solver.won(position) + solver.value(position);
+
+        // the lowest card that keeps the value
+        int expected = -1;
+        for (CardMask moves = position.legalMoves(); expected < 0; moves &= moves - 1) {
+            Position child = position;
+            child.play(lowestCard(moves));
+            if (solver.won(child) + solver.value(child) == total)
+                expected = lowestCard(moves);
+        }
+
+        for (int numThreads = 1; numThreads <= 4; numThreads *= 2) {
+            ParallelSolver parallel(numThreads, Solver::Points, 16);
+            parallel.setDeterministic(true);
+            ASSERT_EQ(expected, parallel.bestMove(position));
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace SchafKopf;
+
+TEST(TestRanking, hands)
+{
+    ASSERT_EQ(0xffu, handFromRank(0));
+    ASSERT_EQ(0xff000000u, handFromRank(numHandRanks - 1));
+
+    for (uint32_t rank = 0; rank < numHandRanks; rank += 9973) {
+        const CardMask hand = handFromRank(rank);
+        ASSERT_EQ(int(Player::maxCards), popCount(hand));
+        ASSERT_EQ(rank, handRank(hand));
+    }
+
+    // colex order: the next hand has the next rank
+    CardMask hand = 0xff;
+    for (uint32_t rank = 0; rank < 1000; ++rank) {
+        ASSERT_EQ(rank, handRank(hand));
+        const CardMask t = hand | (hand - 1);
+        hand = (t + 1) | (((~t & -~t) - 1) >> (lowestCard(hand) + 1));
+    }
+}
+
+TEST(TestRanking, deals)
+{
+    std::minstd_rand engine(17);
+
+    Deal first = dealFromRank(0);
+    Deal last = dealFromRank(numDealRanks - 1);
+    ASSERT_EQ(0u, dealRank(first));
+    ASSERT_EQ(numDealRanks - 1, dealRank(last));
+
+    std::set<uint64_t> ranks;
+    for (int i = 0; i < 1000; ++i) {
+        const Deal deal = randomDeal(engine);
+        CardMask all = 0;
+        for (int p = 0; p < numPlayers; ++p) {
+            ASSERT_EQ(int(Player::maxCards), popCount(deal.hands[p]));
+            ASSERT_EQ(0u, all & deal.hands[p]);
+            all |= deal.hands[p];
+        }
+        ASSERT_EQ(allCards, all);
+
+        const uint64_t rank = dealRank(deal);
+        ASSERT_LT(rank, numDealRanks);
+        ranks.insert(rank);
+
+        const Deal unranked = dealFromRank(rank);
+        for (int p = 0; p < numPlayers; ++p)
+            ASSERT_EQ(deal.hands[p], unranked.hands[p]);
+    }
+    ASSERT_EQ(1000u, ranks.size());
+}
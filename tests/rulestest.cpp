@@ -0,0 +1,108 @@
+#include <Rules.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace SchafKopf;
+
+// random stiche of 4 different cards
+static std::vector<uint8_t> randomStiche(std::minstd_rand& engine, size_t count)
+{
+    std::vector<uint8_t> result;
+    uint8_t deck[numCards];
+    for (int i = 0; i < numCards; ++i)
+        deck[i] = uint8_t(i);
+    for (size_t i = 0; i < count; ++i) {
+        std::shuffle(deck, deck + numCards, engine);
+        result.insert(result.end(), deck, deck + numPlayers);
+    }
+    return result;
+}
+
+TEST(TestRules, trickWinner)
+{
+    std::minstd_rand engine(31);
+    Game game;
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        for (int color = 0; color < numColors; ++color) {
+            const Rules& rules = Rules::get(Game::Type(type), Color(color));
+            ASSERT_EQ(type, rules.type());
+            ASSERT_EQ(color, rules.color());
+
+            game.gameType = Game::Type(type);
+            game.gameColor = Color(color);
+
+            const std::vector<uint8_t> stiche = randomStiche(engine, 1000);
+            for (size_t i = 0; i < stiche.size(); i += numPlayers) {
+                int winner = 0;
+                for (int j = 1; j < numPlayers; ++j) {
+                    if (game.sticht(cardAt(stiche[i + size_t(winner)]), cardAt(stiche[i + size_t(j)])))
+                        winner = j;
+                }
+                ASSERT_EQ(winner, rules.trickWinner(&stiche[i]));
+            }
+        }
+    }
+}
+
+TEST(TestRules, trickWinners)
+{
+    std::minstd_rand engine(37);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules& rules = Rules::get(Game::Type(type), Gras);
+
+        // not a multiple of the batch size
+        const size_t count = 1003;
+        const std::vector<uint8_t> stiche = randomStiche(engine, count);
+        std::vector<uint8_t> winners(count);
+        rules.trickWinners(stiche.data(), count, winners.data());
+
+        for (size_t i = 0; i < count; ++i)
+            ASSERT_EQ(rules.trickWinner(&stiche[i * numPlayers]), winners[i]);
+    }
+}
+
+TEST(TestRules, representatives)
+{
+    const Rules& rules = Rules::get(Game::Solo, Herz);
+    auto bit = [](CardType type, Color color) { return cardBit(Card{ type, color }); };
+
+    // Herz 9 and 7 only become neighbours once the Herz 8 is gone
+    const CardMask low = bit(Neuner, Herz) | bit(Siebner, Herz);
+    ASSERT_EQ(low, rules.representatives(low, 0));
+    ASSERT_EQ(1, popCount(rules.representatives(low, bit(Achter, Herz))));
+
+    // a run of Ober in one hand
+    const CardMask ober = bit(Ober, Eichel) | bit(Ober, Gras) | bit(Ober, Herz);
+    ASSERT_EQ(1, popCount(rules.representatives(ober, 0)));
+
+    // Zehner and Koenig are neighbours, but not worth the same
+    const CardMask high = bit(Zehner, Gras) | bit(Koenig, Gras);
+    ASSERT_EQ(high, rules.representatives(high, 0));
+
+    // a run in one hand
+    const CardMask run = bit(Neuner, Gras) | bit(Achter, Gras) | bit(Siebner, Gras);
+    ASSERT_EQ(1, popCount(rules.representatives(run, 0)));
+}
+
+TEST(TestRules, representativesCoverHand)
+{
+    std::minstd_rand engine(41);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules& rules = Rules::get(Game::Type(type), Schelln);
+        for (int i = 0; i < 1000; ++i) {
+            const CardMask hand = CardMask(engine()) & CardMask(engine());
+            const CardMask gone = CardMask(engine()) & ~hand;
+            const CardMask representatives = rules.representatives(hand, gone);
+            ASSERT_EQ(representatives, representatives & hand);
+            ASSERT_EQ(bool(hand), bool(representatives));
+            // at least one card of every suit in hand
+            for (int suit = 0; suit < Rules::numSuits; ++suit)
+                ASSERT_EQ(bool(hand & rules.suitMask(suit)), bool(representatives & rules.suitMask(suit)));
+        }
+    }
+}
@@ -0,0 +1,195 @@
+#include <Scoring.h>
+#include <RandomAi.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+static CardMask cards(std::initializer_list<Card> list)
+{
+    CardMask result = 0;
+    for (const Card& card : list)
+        result |= cardBit(card);
+    return result;
+}
+
+static void playRandomGame(Game& game)
+{
+    RandomAi randomAi[4] = {
+        {game, game.players[0]},
+        {game, game.players[1]},
+        {game, game.players[2]},
+        {game, game.players[3]}
+    };
+
+    for (int i = 0; i < 32; ++i)
+        game.putCard(randomAi[game.m_activePlayer].doPlayCard(game.activePile));
+}
+
+TEST(TestScoring, laufende)
+{
+    Rules solo(Game::Solo, Herz);
+    ASSERT_EQ(14, solo.numTrumps());
+    ASSERT_EQ(cardIndex(Card{Ober, Eichel}), solo.trumpOrder()[0]);
+    ASSERT_EQ(cardIndex(Card{Siebner, Herz}), solo.trumpOrder()[13]);
+
+    // "mit drei"
+    ASSERT_EQ(3, solo.laufende(cards({{Ober, Eichel}, {Ober, Gras}, {Ober, Herz}, {Unter, Eichel}})));
+    // "ohne zwei"
+    ASSERT_EQ(2, solo.laufende(cards({{Ober, Herz}, {Ass, Schelln}})));
+    // no trump at all counts all of them
+    ASSERT_EQ(14, solo.laufende(cards({{Ass, Schelln}, {Ass, Gras}})));
+
+    Rules wenz(Game::Wenz, Schelln);
+    ASSERT_EQ(4, wenz.numTrumps());
+    ASSERT_EQ(4, wenz.laufende(cards({{Unter, Eichel}, {Unter, Gras}, {Unter, Herz}, {Unter, Schelln}})));
+    ASSERT_EQ(1, wenz.laufende(cards({{Unter, Gras}, {Ober, Eichel}})));
+}
+
+TEST(TestScoring, solo)
+{
+    FinishedGame game;
+    game.gameType = Game::Solo;
+    game.gameColor = Eichel;
+    game.declarer = 2;
+
+    // hands only matter for the Laufende
+    game.hands[0] = game.hands[1] = game.hands[3] = 0;
+    game.hands[2] = cards({{Ober, Eichel}, {Ober, Gras}, {Ober, Herz}, {Ober, Schelln}});
+
+    // declarer takes everything except one stich
+    game.won[0] = game.won[1] = 0;
+    game.won[3] = cards({{Siebner, Gras}, {Achter, Gras}, {Neuner, Gras}, {Koenig, Gras}});
+    game.won[2] = allCards & ~game.won[3];
+
+    Scoring scoring;
+    Settlement settlement = scoring.settle(game);
+    ASSERT_EQ(1 << 2, settlement.declarerTeam);
+    ASSERT_EQ(116, settlement.declarerPoints);
+    ASSERT_TRUE(settlement.won);
+    ASSERT_TRUE(settlement.schneider);
+    ASSERT_FALSE(settlement.schwarz);
+    ASSERT_EQ(4, settlement.laufende);
+
+    const int value = 50 + 10 + 4 * 10;
+    ASSERT_EQ(3 * value, settlement.money[2]);
+    ASSERT_EQ(-value, settlement.money[0]);
+    ASSERT_EQ(-value, settlement.money[1]);
+    ASSERT_EQ(-value, settlement.money[3]);
+
+    // the same game with all stiche is schwarz
+    game.won[2] = allCards;
+    game.won[3] = 0;
+    settlement = scoring.settle(game);
+    ASSERT_TRUE(settlement.schwarz);
+    ASSERT_EQ(3 * (value + 10), settlement.money[2]);
+}
+
+TEST(TestScoring, sauspiel)
+{
+    FinishedGame game;
+    game.gameType = Game::SauSpiel;
+    game.gameColor = Gras;
+    game.declarer = 0;
+
+    // player 3 holds the Gras Sau and therefore plays with the declarer
+    game.hands[0] = cards({{Ober, Gras}});
+    game.hands[1] = cards({{Ober, Eichel}});
+    game.hands[2] = cards({{Ass, Gras}});
+    game.hands[3] = 0;
+
+    // declarer team ends with 60 points, which is not enough
+    game.won[0] = cards({{Ass, Eichel}, {Ass, Schelln}, {Ass, Herz}});
+    game.won[2] = cards({{Zehner, Eichel}, {Zehner, Schelln}, {Koenig, Eichel}, {Ober, Schelln}});
+    game.won[1] = allCards & ~(game.won[0] | game.won[2]);
+    game.won[3] = 0;
+
+    Scoring scoring;
+    const Settlement settlement = scoring.settle(game);
+    ASSERT_EQ((1 << 0) | (1 << 2), settlement.declarerTeam);
+    ASSERT_EQ(60, settlement.declarerPoints);
+    ASSERT_FALSE(settlement.won);
+    ASSERT_FALSE(settlement.schneider);
+    // "ohne einen", which is not enough for a Sauspiel
+    ASSERT_EQ(1, settlement.laufende);
+
+    ASSERT_EQ(-10, settlement.money[0]);
+    ASSERT_EQ(10, settlement.money[1]);
+    ASSERT_EQ(-10, settlement.money[2]);
+    ASSERT_EQ(10, settlement.money[3]);
+}
+
+TEST(TestScoring, randomGames)
+{
+    Scoring scoring;
+    FinishedGame games[numGameTypes];
+    Settlement settlements[numGameTypes];
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        Game game;
+        game.gameType = Game::Type(type);
+        game.gameColor = Eichel;
+        game.declarer = type % numPlayers;
+
+        playRandomGame(game);
+        games[type] = FinishedGame::fromGame(game);
+
+        // all cards were dealt and taken
+        CardMask dealt = 0, won = 0;
+        for (int i = 0; i < numPlayers; ++i) {
+            dealt |= games[type].hands[i];
+            won |= games[type].won[i];
+            ASSERT_EQ(game.players[i].points, maskPoints(games[type].won[i]));
+        }
+        ASSERT_EQ(allCards, dealt);
+        ASSERT_EQ(allCards, won);
+    }
+
+    scoring.settle(games, numGameTypes, settlements);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Settlement settlement = scoring.settle(games[type]);
+        int sum = 0;
+        for (int i = 0; i < numPlayers; ++i) {
+            ASSERT_EQ(settlement.money[i], settlements[type].money[i]);
+            sum += settlement.money[i];
+        }
+        ASSERT_EQ(0, sum);
+    }
+}
+
+TEST(TestScoring, schneiderBoundaries)
+{
+    FinishedGame game;
+    game.gameType = Game::Solo;
+    game.gameColor = Eichel;
+    game.declarer = 1;
+    game.hands[0] = game.hands[1] = game.hands[2] = game.hands[3] = 0;
+    game.won[2] = game.won[3] = 0;
+
+    const CardMask points29 = cards({{Ass, Eichel}, {Zehner, Eichel}, {Ober, Eichel}, {Ober, Gras}, {Unter, Eichel}});
+    const CardMask points30 = cards({{Ass, Eichel}, {Zehner, Eichel}, {Ober, Eichel}, {Ober, Gras}, {Ober, Herz}});
+    const CardMask points31 = cards({{Ass, Eichel}, {Ass, Gras}, {Ober, Eichel}, {Ober, Gras}, {Ober, Herz}});
+
+    // the defenders are schneiderfrei with 30, so it takes 91
+    const struct
+    {
+        CardMask won;
+        int points;
+        bool schneider;
+    } cases[] = {
+        { points30, 30, true },
+        { points31, 31, false },
+        { allCards & ~points30, 90, false },
+        { allCards & ~points29, 91, true },
+    };
+
+    Scoring scoring;
+    for (const auto& c : cases) {
+        game.won[1] = c.won;
+        game.won[0] = allCards & ~c.won;
+        const Settlement settlement = scoring.settle(game);
+        ASSERT_EQ(c.points, settlement.declarerPoints);
+        ASSERT_EQ(c.schneider, settlement.schneider);
+    }
+}
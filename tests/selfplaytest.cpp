@@ -0,0 +1,126 @@
+#include <ExpertAi.h>
+#include <NetTrainer.h>
+#include <Ranking.h>
+#include <SelfPlay.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace SchafKopf;
+
+namespace
+{
+
+// plays numGames games on numThreads threads, returns all samples
+std::vector<Sample> selfPlay(int numGames, int numThreads, size_t samplesPerShard)
+{
+    const std::string prefix = "selfplaytest";
+    std::vector<Sample> samples;
+    TrainingData::ShardWriter writer(prefix, samplesPerShard);
+    EXPECT_EQ(size_t(numGames * numCards), SelfPlay::run<ExpertAi>(writer, numGames, numThreads, 3, 8));
+    EXPECT_TRUE(writer.ok());
+    EXPECT_EQ(size_t(numGames * numCards), writer.numWritten());
+    for (int s = 0; s < writer.numShards(); ++s) {
+        EXPECT_TRUE(TrainingData::readShard(TrainingData::shardName(prefix, s), samples));
+        std::remove(TrainingData::shardName(prefix, s).c_str());
+    }
+    return samples;
+}
+
+double meanError(const std::vector<Sample>& samples)
+{
+    double mean = 0;
+    for (const Sample& sample : samples)
+        mean += sample.points;
+    mean /= samples.size();
+    double squared = 0;
+    for (const Sample& sample : samples)
+        squared += (sample.points - mean) * (sample.points - mean);
+    return std::sqrt(squared / samples.size());
+}
+
+}
+
+TEST(TestSelfPlay, samples)
+{
+    std::minstd_rand engine(19);
+    Position position(Rules::get(Game::Wenz, Gras), randomDeal(engine), 2, 1);
+    uint16_t expected[NetEvaluator::maxActive];
+    uint16_t actual[NetEvaluator::maxActive];
+    while (!position.finished()) {
+        const CardMask moves = position.legalMoves();
+        const int card = nthCard(moves, int(engine() % popCount(moves)));
+        const Sample sample = Sample::make(position, card);
+        ASSERT_EQ(card, sample.move);
+        ASSERT_EQ(position.declarerPoints(), sample.won);
+
+        const Position restored = sample.position();
+        ASSERT_EQ(position.legalMoves(), restored.legalMoves());
+        const int count = NetEvaluator::inputs(position, nullptr, expected);
+        ASSERT_EQ(count, NetEvaluator::inputs(restored, nullptr, actual));
+        ASSERT_EQ(0, std::memcmp(expected, actual, size_t(count) * sizeof(uint16_t)));
+        position.play(card);
+    }
+}
+
+TEST(TestSelfPlay, shards)
+{
+    const std::vector<Sample> samples = selfPlay(50, 1, 500);
+    ASSERT_EQ(size_t(50 * numCards), samples.size());
+
+    // a game is the samples of its cards in order, its points add up
+    for (size_t g = 0; g < samples.size(); g += numCards) {
+        const int total = samples[g].won + samples[g].points;
+        ASSERT_EQ(0, samples[g].won);
+        // a contract of a real auction, a Sauspiel has two declarers
+        const Rules& rules = samples[g].rules();
+        if (rules.type() == Game::SauSpiel) {
+            ASSERT_EQ(2, popCount(samples[g].declarerTeam));
+        } else {
+            ASSERT_EQ(1, popCount(samples[g].declarerTeam));
+        }
+        if (rules.type() == Game::Wenz || rules.type() == Game::Geier) {
+            ASSERT_EQ(Schelln, rules.color());
+        }
+        CardMask played = 0;
+        for (size_t i = g; i < g + numCards; ++i) {
+            ASSERT_EQ(total, samples[i].won + samples[i].points);
+            ASSERT_TRUE(samples[i].position().legalMoves() & cardBit(samples[i].move));
+            played |= cardBit(samples[i].move);
+        }
+        ASSERT_EQ(allCards, played);
+    }
+
+    // the same games on more threads, in another order
+    std::vector<Sample> threaded = selfPlay(50, 3, 300);
+    ASSERT_EQ(samples.size(), threaded.size());
+    auto less = [](const Sample& a, const Sample& b) { return std::memcmp(&a, &b, sizeof(Sample)) < 0; };
+    std::vector<Sample> sorted = samples;
+    std::sort(sorted.begin(), sorted.end(), less);
+    std::sort(threaded.begin(), threaded.end(), less);
+    ASSERT_EQ(0, std::memcmp(sorted.data(), threaded.data(), sorted.size() * sizeof(Sample)));
+}
+
+TEST(TestNetTrainer, learns)
+{
+    std::vector<Sample> samples = selfPlay(600, 1, size_t(1) << 20);
+    const std::vector<Sample> heldBack(samples.end() - 100 * numCards, samples.end());
+    samples.resize(samples.size() - heldBack.size());
+
+    for (int numThreads : { 1, 3 }) {
+        NetTrainer trainer(7);
+        trainer.setNumThreads(numThreads);
+        trainer.setSyncInterval(256);
+        for (int e = 0; e < 4; ++e)
+            trainer.epoch(samples);
+
+        NetEvaluator evaluator;
+        evaluator.setWeights(trainer.weights());
+        const double error = NetTrainer::error(trainer.weights(), heldBack);
+        ASSERT_LT(error, 0.9 * meanError(heldBack));
+        ASSERT_NEAR(error, NetTrainer::error(evaluator, heldBack), 1.0);
+    }
+}
@@ -0,0 +1,179 @@
+#include <Solver.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+// plain minimax over everything the declarer team takes from now on
+static int minimax(const Position& position, Solver::Measure measure)
+{
+    if (position.finished())
+        return 0;
+
+    const bool maximize = position.isDeclarer(position.toMove());
+    const bool completes = position.numInTrick == numPlayers - 1;
+    const CardMask trick = position.trickMask();
+    int best = maximize ? -1 : 1000;
+    for (CardMask moves = position.legalMoves(); moves; moves &= moves - 1) {
+        const int card = lowestCard(moves);
+        Position next = position;
+        next.play(card);
+        int value = minimax(next, measure);
+        if (completes && next.isDeclarer(next.leader))
+            value += measure == Solver::Points ? maskPoints(trick | cardBit(card)) : 1;
+        best = maximize ? std::max(best, value) : std::min(best, value);
+    }
+    return best;
+}
+
+// a random game with plies cards left to play
+static Position randomPosition(const Rules& rules, std::minstd_rand& engine, int plies)
+{
+    Position position(rules, randomDeal(engine), int(engine() % numPlayers), int(engine() % numPlayers));
+    while (numCards - popCount(position.played) - position.numInTrick > plies) {
+        const CardMask moves = position.legalMoves();
+        position.play(nthCard(moves, int(engine() % popCount(moves))));
+    }
+    return position;
+}
+
+TEST(TestSolver, points)
+{
+    std::minstd_rand engine(31);
+    Solver solver;
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Schelln);
+        for (int i = 0; i < 12; ++i) {
+            const Position position = randomPosition(rules, engine, 14 + i % 4);
+            const int expected = minimax(position, Solver::Points);
+
+            ASSERT_EQ(expected, solver.value(position));
+            ASSERT_EQ(expected, solver.valueAlphaBeta(position));
+
+            const int total = solver.won(position) + expected;
+            ASSERT_TRUE(solver.reaches(position, total));
+            ASSERT_FALSE(solver.reaches(position, total + 1));
+            ASSERT_EQ(total >= 61, solver.declarerWins(position));
+            ASSERT_EQ(total >= 91, solver.declarerSchneider(position));
+        }
+    }
+}
+
+TEST(TestSolver, stiche)
+{
+    std::minstd_rand engine(37);
+    Solver solver(Solver::Stiche);
+    const Rules rules(Game::Wenz, Eichel);
+
+    for (int i = 0; i < 20; ++i) {
+        const Position position = randomPosition(rules, engine, 16 + i % 3);
+        const int expected = minimax(position, Solver::Stiche);
+
+        ASSERT_EQ(expected, solver.value(position));
+        ASSERT_EQ(expected, solver.valueAlphaBeta(position));
+
+        // schwarz for the declarer team
+        const bool schwarz = solver.won(position) + expected == int(Player::maxCards);
+        ASSERT_EQ(schwarz, solver.reaches(position, Player::maxCards));
+    }
+}
+
+TEST(TestSolver, mergeEquivalent)
+{
+    std::minstd_rand engine(43);
+    Solver merged;
+    Solver all;
+    all.setMergeEquivalent(false);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Gras);
+        for (int i = 0; i < 8; ++i) {
+            const Position position = randomPosition(rules, engine, 20);
+            ASSERT_EQ(all.value(position), merged.value(position));
+        }
+    }
+    ASSERT_LT(merged.nodes(), all.nodes());
+}
+
+TEST(TestSolver, partitionTable)
+{
+    std::minstd_rand engine(47);
+    Solver exact;
+    Solver partition;
+    partition.setPartitionTable(true);
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Eichel);
+        for (int i = 0; i < 8; ++i) {
+            const Position position = randomPosition(rules, engine, 18 + i % 3);
+            const int expected = exact.value(position);
+            ASSERT_EQ(expected, partition.value(position));
+            ASSERT_EQ(expected, partition.valueAlphaBeta(position));
+        }
+    }
+    ASSERT_GT(partition.hits(), 0u);
+}
+
+TEST(TestSolver, bounds)
+{
+    std::minstd_rand engine(59);
+    Solver withBounds;
+    withBounds.setUseBounds(true);
+    Solver without;
+
+    for (int type = 0; type < numGameTypes; ++type) {
+        const Rules rules(Game::Type(type), Schelln);
+        for (int i = 0; i < 8; ++i) {
+            const Position position = randomPosition(rules, engine, 20);
+            ASSERT_EQ(without.value(position), withBounds.value(position));
+            ASSERT_EQ(without.declarerWins(position), withBounds.declarerWins(position));
+        }
+    }
+    ASSERT_LT(withBounds.nodes(), without.nodes());
+}
+
+TEST(TestSolver, terminal)
+{
+    std::minstd_rand engine(41);
+    Solver solver;
+    const Rules rules(Game::Solo, Herz);
+    const Position position = randomPosition(rules, engine, 0);
+    ASSERT_TRUE(position.finished());
+    ASSERT_EQ(0, solver.value(position));
+    ASSERT_EQ(position.declarerPoints(), solver.won(position));
+    ASSERT_EQ(position.declarerPoints() >= 61, solver.declarerWins(position));
+}
+
+TEST(TestSolver, worlds)
+{
+    std::minstd_rand engine(71);
+    const Rules rules(Game::SauSpiel, Eichel);
+
+    for (int i = 0; i < 4; ++i) {
+        const Position root = randomPosition(rules, engine, 16 + i);
+        std::vector<Deal> worlds;
+        for (int w = 0; w < 6; ++w)
+            worlds.push_back(randomWorld(root, root.toMove(), engine));
+
+        Solver batch;
+        batch.setUseHistory(true);
+        const MoveMatrix matrix = batch.solveWorlds(root, worlds.data(), worlds.size());
+        ASSERT_EQ(6, matrix.numWorlds);
+        ASSERT_EQ(popCount(root.legalMoves()), matrix.numMoves);
+
+        // the same as every world and move on its own
+        for (int w = 0; w < matrix.numWorlds; ++w) {
+            Position world = root;
+            for (int p = 0; p < numPlayers; ++p)
+                world.hands[p] = worlds[size_t(w)].hands[p];
+            for (int m = 0; m < matrix.numMoves; ++m) {
+                Position child = world;
+                child.play(matrix.moves[m]);
+                Solver single;
+                ASSERT_EQ(single.won(child) + single.value(child), matrix.value(w, m));
+            }
+        }
+    }
+}
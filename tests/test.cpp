@@ -92,3 +92,56 @@ TEST(TestSchafKopf, sticheInGame)
                    Card{Siebner, Herz},
                    1));
 }
+
+TEST(TestSchafKopf, history)
+{
+    Game game;
+    game.gameType = Game::Solo;
+    game.gameColor = Color::Herz;
+
+    ASSERT_NO_FATAL_FAILURE(
+        testStiche(game,
+                   Card{Ass, Schelln},
+                   Card{Zehner, Schelln},
+                   Card{Unter, Schelln},
+                   Card{Siebner, Schelln},
+                   2));
+
+    ASSERT_NO_FATAL_FAILURE(
+        testStiche(game,
+                   Card{Zehner, Gras},
+                   Card{Ass, Eichel},
+                   Card{Achter, Schelln},
+                   Card{Neuner, Schelln},
+                   2));
+
+    ASSERT_EQ(2, game.numStiche);
+    ASSERT_EQ(2, game.players[2].numStiche);
+    ASSERT_EQ(0, game.players[0].numStiche);
+    ASSERT_EQ(11 + 10 + 2 + 10 + 11, game.players[2].points);
+    ASSERT_EQ(2, game.history.leader(1));
+
+    ASSERT_TRUE(game.players[2].cardInStiche(Card{Ass, Eichel}));
+    ASSERT_FALSE(game.players[1].cardInStiche(Card{Ass, Eichel}));
+    ASSERT_TRUE(game.discardPile.contains(Card{Unter, Schelln}));
+    ASSERT_FALSE(game.discardPile.contains(Card{Ober, Schelln}));
+
+    const Stich first = game.stich(0);
+    ASSERT_EQ(0, first.cards[0].first);
+    ASSERT_TRUE(first.cards[2].second == (Card{Unter, Schelln}));
+
+    // the leader of the second stich came out first
+    const Stich last = game.lastStich();
+    for (int i = 0; i < numPlayers; ++i)
+        ASSERT_EQ((2 + i) % numPlayers, last.cards[i].first);
+    ASSERT_TRUE(last.cards[1].second == (Card{Ass, Eichel}));
+
+    ASSERT_EQ(2, game.stichWinner(0));
+    ASSERT_EQ(2, game.stichWinner(1));
+    ASSERT_EQ(3u, game.wonStiche(2));
+    ASSERT_EQ(0u, game.wonStiche(0));
+
+    game.reset();
+    ASSERT_EQ(0, game.players[2].numStiche);
+    ASSERT_FALSE(game.discardPile.contains(Card{Unter, Schelln}));
+}
@@ -0,0 +1,148 @@
+#include <WorldCache.h>
+#include <Ranking.h>
+
+#include <gtest/gtest.h>
+
+using namespace SchafKopf;
+
+// plays a game with random cards, player 0 asks its cache at every turn
+TEST(TestWorldCache, followsGame)
+{
+    std::minstd_rand engine(79);
+    const Rules rules(Game::Solo, Schelln);
+    Position position(rules, randomDeal(engine), 1, 0);
+
+    WorldCache cache(0, 8, 3);
+    cache.reset(position);
+
+    Solver solver;
+    while (!position.finished()) {
+        const int who = position.toMove();
+        if (who == 0 && position.numStiche() >= 3) {
+            const MoveMatrix& matrix = cache.solve(position);
+            ASSERT_EQ(8, matrix.numWorlds);
+            for (double weight : matrix.weights)
+                ASSERT_DOUBLE_EQ(1.0 / 8, weight);
+            ASSERT_EQ(popCount(position.legalMoves()), matrix.numMoves);
+
+            CardMask hidden = 0;
+            for (int p = 1; p < numPlayers; ++p)
+                hidden |= position.hands[p];
+            for (int w = 0; w < matrix.numWorlds; ++w) {
+                const Deal& deal = cache.worlds()[size_t(w)].deal;
+                ASSERT_EQ(position.hands[0], deal.hands[0]);
+                CardMask all = 0;
+                for (int p = 1; p < numPlayers; ++p) {
+                    ASSERT_EQ(popCount(position.hands[p]), popCount(deal.hands[p]));
+                    all |= deal.hands[p];
+                }
+                ASSERT_EQ(hidden, all);
+            }
+
+            // kept values are the values of the world now
+            const Deal& deal = cache.worlds()[0].deal;
+            Position world = position;
+            for (int p = 0; p < numPlayers; ++p)
+                world.hands[p] = deal.hands[p];
+            Position child = world;
+            child.play(matrix.moves[0]);
+            ASSERT_EQ(solver.won(child) + solver.value(child), matrix.value(0, 0));
+
+            // asking again solves nothing
+            const uint64_t nodes = cache.solver().nodes();
+            cache.solve(position);
+            ASSERT_EQ(nodes, cache.solver().nodes());
+        }
+
+        const CardMask moves = position.legalMoves();
+        const int card = nthCard(moves, int(engine() % popCount(moves)));
+        position.play(card);
+        cache.cardPlayed(card);
+    }
+
+    // the worlds lived on, repaired where the play contradicted them
+    ASSERT_GT(cache.numRepaired(), 0);
+    ASSERT_LT(cache.numDrawn(), 8 * 5);
+}
+
+TEST(TestWorldCache, voids)
+{
+    const Rules& rules = Rules::get(Game::Wenz, Eichel);
+    std::minstd_rand engine(83);
+    const Position position(rules, randomDeal(engine), 0, 0);
+
+    WorldCache cache(0, 16);
+    cache.reset(position);
+    cache.exclude(2, rules.suitMask(Gras));
+    cache.solve(position);
+    for (const WorldCache::World& world : cache.worlds())
+        ASSERT_EQ(0u, world.deal.hands[2] & rules.suitMask(Gras) & ~position.hands[0]);
+}
+
+// the incremental log weights are the likelihood of all plays since reset()
+TEST(TestWorldCache, likelihood)
+{
+    std::minstd_rand engine(97);
+    const Rules rules(Game::SauSpiel, Schelln);
+    const SmearPlayModel model;
+
+    Position position(rules, randomDeal(engine), 2, 0);
+    for (int i = 0; i < 12; ++i)
+        position.play(lowestCard(position.legalMoves()));
+
+    const Position start = position;
+    WorldCache cache(3, 24, 7);
+    cache.reset(start);
+    cache.setPlayModel(&model);
+    cache.topUp();
+
+    std::vector<int> plays;
+    for (int i = 0; i < 9; ++i) {
+        const CardMask moves = position.legalMoves();
+        const int card = nthCard(moves, int(engine() % popCount(moves)));
+        plays.push_back(card);
+        position.play(card);
+        cache.cardPlayed(card);
+    }
+
+    for (const WorldCache::World& world : cache.worlds()) {
+        // the hands of the world at the start
+        Position replay = start;
+        for (int p = 0; p < numPlayers; ++p)
+            replay.hands[p] = world.deal.hands[p];
+        Position view = start;
+        for (int card : plays) {
+            replay.hands[view.toMove()] |= cardBit(card);
+            view.play(card);
+        }
+
+        double expected = 0;
+        for (int card : plays) {
+            if (replay.toMove() != cache.player())
+                expected += std::log(model.probability(replay, card));
+            replay.play(card);
+        }
+        ASSERT_NEAR(expected, world.logWeight, 1e-9);
+    }
+
+    double sum = 0;
+    for (double weight : cache.weights())
+        sum += weight;
+    ASSERT_NEAR(1.0, sum, 1e-9);
+
+    // solve() hands the weights on with the values
+    const MoveMatrix& matrix = cache.solve(position);
+    ASSERT_EQ(cache.weights(), matrix.weights);
+    double expected = 0;
+    for (int w = 0; w < matrix.numWorlds; ++w)
+        expected += matrix.weights[size_t(w)] * matrix.value(w, 0);
+    ASSERT_NEAR(expected, matrix.expected(0), 1e-9);
+
+    const double ess = cache.effectiveSampleSize();
+    ASSERT_GE(ess, 1.0);
+    ASSERT_LT(ess, 24.0);
+
+    cache.resample();
+    ASSERT_EQ(24u, cache.worlds().size());
+    ASSERT_NEAR(24.0, cache.effectiveSampleSize(), 1e-9);
+}
@@ -0,0 +1,49 @@
+#include <BiddingCfr.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace SchafKopf;
+
+// Solves the bidding game of BiddingCfr.h and writes the average strategy,
+// indexed by node, team and hand bucket, for CfrBiddingAi.
+//
+// Usage: schafbiddingcfr <strategy file> <iterations> [-j threads] [-s seed]
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <strategy file> <iterations> [-j threads] [-s seed]" << std::endl;
+        return 1;
+    }
+
+    const std::string fileName = argv[1];
+    const uint64_t numIterations = uint64_t(std::max(1ll, std::atoll(argv[2])));
+    int numThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    uint32_t seed = 1;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        if (option == "-j")
+            numThreads = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "-s")
+            seed = uint32_t(std::atoll(argv[i + 1]));
+    }
+
+    CfrSolver solver;
+    // in rounds, to show progress
+    constexpr int numRounds = 10;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < numRounds; ++r) {
+        const uint64_t count = numIterations * uint64_t(r + 1) / numRounds - solver.numIterations();
+        solver.run(count, numThreads, seed + uint32_t(r) * 7919u);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << solver.numIterations() << " iterations, " << solver.numIterations() / seconds << "/s" << std::endl;
+    }
+
+    if (!solver.strategy().write(fileName)) {
+        std::cerr << "Cannot write " << fileName << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << fileName << std::endl;
+    return 0;
+}
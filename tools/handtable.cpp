@@ -0,0 +1,77 @@
+#include <HandTable.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace SchafKopf;
+
+// Generates the table of contract values for all hands, see HandTable.h
+//
+// Usage: schafhandtable <file> [samples] [threads] [max hands per family]
+
+static constexpr size_t chunkSize = 256;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file> [samples] [threads] [max hands per family]" << std::endl;
+        return 1;
+    }
+
+    const std::string fileName = argv[1];
+    const int numSamples = argc > 2 ? std::atoi(argv[2]) : 48;
+    const int numThreads = argc > 3 ? std::atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<CardMask> hands[HandTable::numFamilies];
+    std::vector<HandTable::Entry> entries[HandTable::numFamilies];
+
+    for (int f = 0; f < HandTable::numFamilies; ++f) {
+        const HandTable::Family family = HandTable::Family(f);
+        const size_t numSlots = size_t(HandTable::numSlots(family));
+
+        hands[f] = HandTable::canonicalHands(family);
+        const size_t numHands = hands[f].size();
+        if (argc > 4)
+            hands[f].resize(std::min(hands[f].size(), size_t(std::max(1ll, std::atoll(argv[4])))));
+
+        std::cout << "Evaluating " << hands[f].size() << " of " << numHands << " hands of family " << f
+                  << " with " << numSamples << " samples on " << numThreads << " threads" << std::endl;
+
+        entries[f].resize(hands[f].size() * numSlots);
+        std::atomic<size_t> nextChunk(0);
+        std::atomic<size_t> done(0);
+
+        auto worker = [&]() {
+            for (;;) {
+                const size_t chunk = nextChunk++;
+                const size_t begin = chunk * chunkSize;
+                if (begin >= hands[f].size())
+                    return;
+                const size_t end = std::min(hands[f].size(), begin + chunkSize);
+
+                // seeded per chunk, so the table does not depend on the number of threads
+                ContractEvaluator evaluator(numSamples, unsigned(chunk) + 1);
+                for (size_t i = begin; i < end; ++i)
+                    HandTable::evaluate(family, hands[f][i], evaluator, &entries[f][i * numSlots]);
+
+                const size_t total = done += end - begin;
+                if (total * 100 / hands[f].size() != (total - (end - begin)) * 100 / hands[f].size())
+                    std::cout << "    " << total * 100 / hands[f].size() << "%" << std::endl;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back(worker);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    if (!HandTable::write(fileName, hands, entries, numSamples)) {
+        std::cerr << "Cannot write " << fileName << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << fileName << std::endl;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <OpponentModel.h>
+
+#include <thread>
+
+using namespace SchafKopf;
+
+// Fits an OpponentModel to recorded games, see GameLog.h. The logs are
+// streamed in chunks, every thread counting into its own shard.
+//
+// Usage: schafplaymodel <model file> <log file>... [-j threads]
+
+static constexpr size_t chunkSize = 1024;
+
+int main(int argc, char *argv[])
+{
+    int numThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::string> logs;
+    for (int i = 2; i < argc; ++i) {
+        if (std::string(argv[i]) == "-j" && i + 1 < argc)
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        else
+            logs.push_back(argv[i]);
+    }
+    if (argc < 3 || logs.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <model file> <log file>... [-j threads]" << std::endl;
+        return 1;
+    }
+
+    PlayCounts counts(numThreads);
+    std::atomic<size_t> numGames(0);
+    std::atomic<size_t> numInvalid(0);
+
+    for (const std::string& log : logs) {
+        GameLog::Reader reader(log);
+        if (!reader.isOpen()) {
+            std::cerr << "Cannot read " << log << std::endl;
+            return 1;
+        }
+
+        auto worker = [&](int shard) {
+            std::vector<GameRecord> records(chunkSize);
+            size_t count;
+            while ((count = reader.read(records.data(), records.size())) > 0) {
+                size_t invalid = 0;
+                for (size_t i = 0; i < count; ++i)
+                    invalid += !counts.add(records[i], shard);
+                numGames += count - invalid;
+                numInvalid += invalid;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back(worker, i);
+        for (std::thread& thread : threads)
+            thread.join();
+        std::cout << "Read " << log << ", " << numGames << " games so far" << std::endl;
+    }
+
+    if (numInvalid)
+        std::cout << "Skipped " << numInvalid << " records that are no valid games" << std::endl;
+
+    const std::string fileName = argv[1];
+    if (!counts.model().write(fileName)) {
+        std::cerr << "Cannot write " << fileName << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << fileName << std::endl;
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <ExpertAi.h>
+#include <RandomAi.h>
+#include <SelfPlay.h>
+
+#include <chrono>
+
+using namespace SchafKopf;
+
+// Plays games of an AI against itself and writes a sample for every card
+// played to shards prefix-0000.bin, prefix-0001.bin and so on, see
+// TrainingData.h.
+//
+// Usage: schafselfplay <prefix> <games> [-ai expert|random] [-j threads] [-s seed]
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <prefix> <games> [-ai expert|random] [-j threads] [-s seed]" << std::endl;
+        return 1;
+    }
+
+    const std::string prefix = argv[1];
+    const int numGames = std::max(1, std::atoi(argv[2]));
+    std::string ai = "expert";
+    int numThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    uint32_t seed = 1;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        if (option == "-ai")
+            ai = argv[i + 1];
+        else if (option == "-j")
+            numThreads = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "-s")
+            seed = uint32_t(std::atoll(argv[i + 1]));
+    }
+    if (ai != "expert" && ai != "random") {
+        std::cerr << "Unknown AI " << ai << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    TrainingData::ShardWriter writer(prefix);
+    const size_t numSamples = ai == "expert" ? SelfPlay::run<ExpertAi>(writer, numGames, numThreads, seed)
+                                             : SelfPlay::run<RandomAi>(writer, numGames, numThreads, seed);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!writer.ok()) {
+        std::cerr << "Cannot write " << TrainingData::shardName(prefix, writer.numShards() - 1) << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << numSamples << " samples of " << numGames << " games to " << writer.numShards()
+              << " shards in " << seconds << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <NetTrainer.h>
+#include <OpponentModel.h>
+
+#include <thread>
+
+using namespace SchafKopf;
+
+// Fits a NetEvaluator to self-play samples, see SelfPlay.h, and writes
+// the quantized weights for NetEvaluator::load. The last twentieth of the
+// samples is held back to report the error on games the trainer did not
+// see. With -p it also fits an OpponentModel to the cards that were
+// played, a policy that imitates the AI of the games.
+//
+// Usage: schaftrainnet <net file> <shard>... [-j threads] [-e epochs] [-r learning rate] [-p policy file]
+
+int main(int argc, char *argv[])
+{
+    int numThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    int numEpochs = 8;
+    float rate = 0.01f;
+    std::string policyFile;
+    std::vector<std::string> shards;
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "-j" && i + 1 < argc)
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        else if (option == "-e" && i + 1 < argc)
+            numEpochs = std::max(1, std::atoi(argv[++i]));
+        else if (option == "-r" && i + 1 < argc)
+            rate = float(std::atof(argv[++i]));
+        else if (option == "-p" && i + 1 < argc)
+            policyFile = argv[++i];
+        else
+            shards.push_back(option);
+    }
+    if (argc < 3 || shards.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <net file> <shard>... [-j threads] [-e epochs] [-r learning rate] [-p policy file]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Sample> samples;
+    for (const std::string& shard : shards) {
+        if (!TrainingData::readShard(shard, samples)) {
+            std::cerr << "Cannot read " << shard << std::endl;
+            return 1;
+        }
+    }
+    // whole games, a game has a sample per card
+    const size_t numHeldBack = samples.size() / 20 / numCards * numCards;
+    std::vector<Sample> heldBack(samples.end() - std::ptrdiff_t(numHeldBack), samples.end());
+    samples.resize(samples.size() - numHeldBack);
+    std::cout << "Read " << samples.size() << " samples, " << heldBack.size() << " held back" << std::endl;
+
+    NetTrainer trainer;
+    trainer.setNumThreads(numThreads);
+    for (int e = 0; e < numEpochs; ++e) {
+        // halves the rate over the second half of the epochs
+        trainer.setLearningRate(e < numEpochs / 2 ? rate : rate / 2);
+        const double trainError = trainer.epoch(samples);
+        std::cout << "Epoch " << e + 1 << ": " << trainError << " points, held back "
+                  << NetTrainer::error(trainer.weights(), heldBack) << std::endl;
+    }
+
+    NetEvaluator evaluator;
+    evaluator.setWeights(trainer.weights());
+    std::cout << "Quantized: " << NetTrainer::error(evaluator, heldBack) << " points on the held back samples"
+              << std::endl;
+    const std::string fileName = argv[1];
+    if (!evaluator.write(fileName)) {
+        std::cerr << "Cannot write " << fileName << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << fileName << std::endl;
+
+    if (!policyFile.empty()) {
+        PlayCounts counts;
+        for (const Sample& sample : samples)
+            counts.count(sample.position(), sample.move, 0);
+        if (!counts.model().write(policyFile)) {
+            std::cerr << "Cannot write " << policyFile << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << policyFile << std::endl;
+    }
+    return 0;
+}